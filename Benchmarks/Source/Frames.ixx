@@ -0,0 +1,197 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module Benchmarks.Frames;
+
+import Benchmarks.Harness;
+
+import RenderCore.Renderer;
+import RenderCore.Runtime.Device;
+import RenderCore.Runtime.Instance;
+import RenderCore.Runtime.Scene;
+import RenderCore.Runtime.StressScene;
+import RenderCore.Runtime.SwapChain;
+import RenderCore.Types.SurfaceProperties;
+import RenderCore.Utils.Helpers;
+
+using namespace RenderCore;
+
+namespace Benchmarks
+{
+    export struct FrameBenchmarkSettings
+    {
+        VkExtent2D       Extent { 1280U, 720U };
+        std::uint32_t    WarmupFrames { 30U };
+        strzilla::string Device {};
+    };
+
+    struct FrameBenchmarkScene
+    {
+        strzilla::string_view Name {};
+        StressSceneSettings   Settings {};
+    };
+
+    constexpr double g_FrameDeltaTime { 1. / 60. };
+
+    // Fixed seeds, so every run renders the same scenes
+    std::array const g_FrameBenchmarkScenes {
+            FrameBenchmarkScene { .Name = "Frame/StressScene/1k", .Settings = StressSceneSettings { .NumObjects = 1000U, .Seed = 1U } },
+            FrameBenchmarkScene {
+                    .Name = "Frame/StressScene/10k",
+                    .Settings = StressSceneSettings { .NumObjects = 10000U, .NumMeshes = 32U, .TrianglesPerMesh = 256U, .Seed = 2U }
+            },
+            FrameBenchmarkScene {
+                    .Name = "Frame/StressScene/Moving",
+                    .Settings = StressSceneSettings { .NumObjects = 2000U, .MovingFraction = 1.F, .Seed = 3U }
+            },
+            FrameBenchmarkScene {
+                    .Name = "Frame/StressScene/Lights",
+                    .Settings = StressSceneSettings { .NumObjects = 1000U, .NumPointLights = 512U, .Seed = 4U }
+            }
+    };
+
+    bool IsHeadlessSurfaceAvailable()
+    {
+        if (volkInitialize() != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        std::vector<strzilla::string> const Extensions = GetAvailableInstanceExtensionsNames();
+
+        return std::ranges::find(Extensions, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME) != std::end(Extensions);
+    }
+
+    SurfaceProperties SelectHeadlessSurfaceProperties(VkExtent2D const &Extent)
+    {
+        SurfaceProperties Output {
+                .Format = VkSurfaceFormatKHR { .format = VK_FORMAT_UNDEFINED, .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+                .DepthFormat = VK_FORMAT_D32_SFLOAT,
+                .Mode = VK_PRESENT_MODE_FIFO_KHR,
+                .Extent = Extent
+        };
+
+        for (VkSurfaceFormatKHR const &FormatIt : GetAvailablePhysicalDeviceSurfaceFormats())
+        {
+            if (Output.Format.format == VK_FORMAT_UNDEFINED || FormatIt.format == VK_FORMAT_B8G8R8A8_UNORM)
+            {
+                Output.Format = FormatIt;
+            }
+        }
+
+        // Presentation shouldn't throttle the measurement when the surface allows it
+        for (VkPresentModeKHR const ModeIt : GetAvailablePhysicalDeviceSurfacePresentationModes())
+        {
+            if (ModeIt == VK_PRESENT_MODE_IMMEDIATE_KHR)
+            {
+                Output.Mode = ModeIt;
+                break;
+            }
+
+            if (ModeIt == VK_PRESENT_MODE_MAILBOX_KHR)
+            {
+                Output.Mode = ModeIt;
+            }
+        }
+
+        return Output;
+    }
+
+    bool InitializeHeadlessRenderer(FrameBenchmarkSettings const &Settings)
+    {
+        if (!IsHeadlessSurfaceAvailable())
+        {
+            BOOST_LOG_TRIVIAL(warning) << "[" << __func__ << "]: " << std::format("{} is not available, skipping frame benchmarks",
+                                                                                  VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+            return false;
+        }
+
+        SetPhysicalDeviceOverride(Settings.Device);
+
+        SetOnGetAdditionalInstanceExtensions([]
+        {
+            return std::vector<strzilla::string> { VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME };
+        });
+
+        SetOnSurfaceCreationCallback([](VkSurfaceKHR &Surface)
+        {
+            constexpr VkHeadlessSurfaceCreateInfoEXT SurfaceCreateInfo { .sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT };
+            CheckVulkanResult(vkCreateHeadlessSurfaceEXT(GetInstance(), &SurfaceCreateInfo, nullptr, &Surface));
+        });
+
+        SetOnGetSurfacePropertiesCallback([Extent = Settings.Extent, Cached = std::optional<SurfaceProperties> {}]() mutable
+        {
+            if (!Cached.has_value())
+            {
+                Cached = SelectHeadlessSurfaceProperties(Extent);
+            }
+
+            return Cached.value();
+        });
+
+        if (!Renderer::Initialize())
+        {
+            BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Failed to initialize the headless renderer";
+            Renderer::Shutdown();
+            return false;
+        }
+
+        Renderer::SetRenderOffscreen(true);
+
+        return true;
+    }
+
+    void DrawFrames(std::uint32_t const NumFrames)
+    {
+        for (std::uint32_t FrameIt = 0U; FrameIt < NumFrames; ++FrameIt)
+        {
+            Renderer::DrawFrame(g_FrameDeltaTime);
+        }
+    }
+
+    export void RunFrameBenchmarks(BenchmarkRunner &Runner, FrameBenchmarkSettings const &Settings)
+    {
+        bool const HasEnabledScene = std::ranges::any_of(g_FrameBenchmarkScenes,
+                                                         [&Runner](FrameBenchmarkScene const &Scene)
+                                                         {
+                                                             return Runner.IsEnabled(Scene.Name);
+                                                         });
+
+        if (!HasEnabledScene || !InitializeHeadlessRenderer(Settings))
+        {
+            return;
+        }
+
+        for (FrameBenchmarkScene const &Scene : g_FrameBenchmarkScenes)
+        {
+            if (!Runner.IsEnabled(Scene.Name))
+            {
+                continue;
+            }
+
+            Renderer::RequestClearScene();
+            Renderer::RequestGenerateStressScene(Scene.Settings);
+
+            // Scene generation, resource creation and the first submissions are excluded from the measurement
+            DrawFrames(Settings.WarmupFrames);
+
+            if (!Renderer::IsReady() || std::empty(GetObjects()))
+            {
+                BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: " << std::format("Scene '{}' isn't ready to render, skipping it", std::data(Scene.Name));
+                continue;
+            }
+
+            Runner.Run(Scene.Name,
+                       1U,
+                       []
+                       {
+                           DrawFrames(1U);
+                       });
+        }
+
+        Renderer::Shutdown();
+    }
+} // namespace Benchmarks
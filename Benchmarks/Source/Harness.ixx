@@ -0,0 +1,378 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module Benchmarks.Harness;
+
+namespace Benchmarks
+{
+    volatile std::uintptr_t g_OptimizationSink { 0U };
+
+    export struct BenchmarkSettings
+    {
+        std::uint32_t    Samples { 15U };
+        double           MinSampleTime { 0.02 };
+        std::uint32_t    MaxIterationsPerSample { 1U << 20U };
+        strzilla::string Filter {};
+    };
+
+    export struct RegressionSettings
+    {
+        // Relative median slowdown tolerated before a change is reported
+        double Threshold { 0.05 };
+        // The slowdown must also exceed this many combined standard deviations, estimated from the MADs
+        double DeviationFactor { 3. };
+    };
+
+    export struct BenchmarkComparison
+    {
+        strzilla::string Name {};
+        double           BaselineMedian { 0. };
+        double           CurrentMedian { 0. };
+        double           RelativeChange { 0. };
+        bool             IsSignificant { false };
+
+        [[nodiscard]] inline bool IsRegression() const
+        {
+            return IsSignificant && RelativeChange > 0.;
+        }
+
+        [[nodiscard]] inline bool IsImprovement() const
+        {
+            return IsSignificant && RelativeChange < 0.;
+        }
+    };
+
+    export struct BenchmarkResult
+    {
+        strzilla::string Name {};
+        std::uint64_t    Items { 0U };
+        std::uint64_t    Iterations { 0U };
+        double           Median { 0. };
+        double           Mean { 0. };
+        double           Min { 0. };
+        double           Max { 0. };
+        double           MedianAbsoluteDeviation { 0. };
+    };
+
+    export template <typename ValueType>
+    inline void DoNotOptimize(ValueType const &Value)
+    {
+        g_OptimizationSink = reinterpret_cast<std::uintptr_t>(&Value);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    double GetMedian(std::vector<double> Values)
+    {
+        if (std::empty(Values))
+        {
+            return 0.;
+        }
+
+        std::ranges::sort(Values);
+        std::size_t const Middle = std::size(Values) / 2U;
+
+        return std::size(Values) % 2U == 0U ? (Values.at(Middle - 1U) + Values.at(Middle)) / 2. : Values.at(Middle);
+    }
+
+    std::string EscapeJSON(strzilla::string_view const Value)
+    {
+        std::string Output {};
+
+        for (char const Character : Value)
+        {
+            switch (Character)
+            {
+                case '"': Output += "\\\"";
+                    break;
+
+                case '\\': Output += "\\\\";
+                    break;
+
+                case '\n': Output += "\\n";
+                    break;
+
+                default: Output += Character;
+                    break;
+            }
+        }
+
+        return Output;
+    }
+
+    std::string UnescapeJSON(std::string_view const Value)
+    {
+        std::string Output {};
+
+        for (std::size_t Index = 0U; Index < std::size(Value); ++Index)
+        {
+            if (Value.at(Index) == '\\' && Index + 1U < std::size(Value))
+            {
+                ++Index;
+                Output += Value.at(Index) == 'n' ? '\n' : Value.at(Index);
+            }
+            else
+            {
+                Output += Value.at(Index);
+            }
+        }
+
+        return Output;
+    }
+
+    std::optional<std::string_view> FindJSONString(std::string_view const Line, std::string_view const Key)
+    {
+        std::string const Pattern  = std::format("\"{}\": \"", Key);
+        std::size_t const Position = Line.find(Pattern);
+
+        if (Position == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+
+        std::size_t const Begin = Position + std::size(Pattern);
+        std::size_t       End   = Begin;
+
+        while (End < std::size(Line) && Line.at(End) != '"')
+        {
+            End += Line.at(End) == '\\' ? 2U : 1U;
+        }
+
+        return Line.substr(Begin, std::min(End, std::size(Line)) - Begin);
+    }
+
+    std::optional<double> FindJSONNumber(std::string_view const Line, std::string_view const Key)
+    {
+        std::string const Pattern  = std::format("\"{}\": ", Key);
+        std::size_t const Position = Line.find(Pattern);
+
+        if (Position == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+
+        double      Output = 0.;
+        char const *Begin  = std::data(Line) + Position + std::size(Pattern);
+
+        if (std::from_chars(Begin, std::data(Line) + std::size(Line), Output).ec != std::errc {})
+        {
+            return std::nullopt;
+        }
+
+        return Output;
+    }
+
+    export class BenchmarkRunner
+    {
+        BenchmarkSettings            m_Settings {};
+        std::vector<BenchmarkResult> m_Results {};
+
+    public:
+        explicit BenchmarkRunner(BenchmarkSettings Settings)
+            : m_Settings(std::move(Settings))
+        {
+        }
+
+        [[nodiscard]] inline std::vector<BenchmarkResult> const &GetResults() const
+        {
+            return m_Results;
+        }
+
+        [[nodiscard]] inline bool IsEnabled(strzilla::string_view const Name) const
+        {
+            return std::empty(m_Settings.Filter) || std::string_view { std::data(Name), std::size(Name) }.find(std::data(m_Settings.Filter)) !=
+                   std::string_view::npos;
+        }
+
+        // Setup runs before each iteration and is excluded from the measurement
+        template <typename SetupType, typename BodyType>
+        void Run(strzilla::string_view const Name, std::uint64_t const Items, SetupType &&Setup, BodyType &&Body)
+        {
+            if (!IsEnabled(Name))
+            {
+                return;
+            }
+
+            using Clock = std::chrono::steady_clock;
+
+            Setup();
+            Body();
+
+            std::vector<double> Samples {};
+            Samples.reserve(m_Settings.Samples);
+
+            std::uint64_t TotalIterations = 0U;
+
+            for (std::uint32_t SampleIt = 0U; SampleIt < m_Settings.Samples; ++SampleIt)
+            {
+                Clock::duration SampleTime { 0 };
+                std::uint32_t   Iterations = 0U;
+
+                while (std::chrono::duration<double>(SampleTime).count() < m_Settings.MinSampleTime && Iterations < m_Settings.MaxIterationsPerSample)
+                {
+                    Setup();
+
+                    auto const Begin = Clock::now();
+                    Body();
+                    SampleTime += Clock::now() - Begin;
+
+                    ++Iterations;
+                }
+
+                TotalIterations += Iterations;
+                Samples.push_back(std::chrono::duration<double, std::nano>(SampleTime).count() / Iterations);
+            }
+
+            BenchmarkResult Result {
+                    .Name = strzilla::string { Name },
+                    .Items = Items,
+                    .Iterations = TotalIterations,
+                    .Median = GetMedian(Samples),
+                    .Mean = std::accumulate(std::begin(Samples), std::end(Samples), 0.) / static_cast<double>(std::size(Samples)),
+                    .Min = std::ranges::min(Samples),
+                    .Max = std::ranges::max(Samples)
+            };
+
+            std::vector<double> Deviations(std::size(Samples));
+            std::ranges::transform(Samples,
+                                   std::begin(Deviations),
+                                   [Median = Result.Median](double const Sample)
+                                   {
+                                       return std::abs(Sample - Median);
+                                   });
+
+            Result.MedianAbsoluteDeviation = GetMedian(std::move(Deviations));
+
+            BOOST_LOG_TRIVIAL(info) << std::format("{:<48} {:>14.1f} ns/op {:>10.1f} MAD {:>12} items",
+                                                   std::data(Result.Name),
+                                                   Result.Median,
+                                                   Result.MedianAbsoluteDeviation,
+                                                   Items);
+
+            m_Results.push_back(std::move(Result));
+        }
+
+        template <typename BodyType>
+        void Run(strzilla::string_view const Name, std::uint64_t const Items, BodyType &&Body)
+        {
+            Run(Name,
+                Items,
+                []
+                {
+                },
+                std::forward<BodyType>(Body));
+        }
+
+        [[nodiscard]] std::string ToJSON() const
+        {
+            std::string Output = std::format("{{\n  \"context\": {{\n    \"samples\": {},\n    \"min_sample_time_s\": {},\n"
+                                             "    \"hardware_concurrency\": {}\n  }},\n  \"benchmarks\": [\n",
+                                             m_Settings.Samples,
+                                             m_Settings.MinSampleTime,
+                                             std::thread::hardware_concurrency());
+
+            for (std::size_t Index = 0U; Index < std::size(m_Results); ++Index)
+            {
+                BenchmarkResult const &Result = m_Results.at(Index);
+
+                double const ItemsPerSecond = Result.Median > 0. ? static_cast<double>(Result.Items) * 1.e9 / Result.Median : 0.;
+
+                Output += std::format("    {{\"name\": \"{}\", \"items\": {}, \"iterations\": {}, \"median_ns\": {:.3f}, \"mean_ns\": {:.3f}, "
+                                      "\"min_ns\": {:.3f}, \"max_ns\": {:.3f}, \"mad_ns\": {:.3f}, \"items_per_second\": {:.3f}}}{}\n",
+                                      std::data(EscapeJSON(Result.Name)),
+                                      Result.Items,
+                                      Result.Iterations,
+                                      Result.Median,
+                                      Result.Mean,
+                                      Result.Min,
+                                      Result.Max,
+                                      Result.MedianAbsoluteDeviation,
+                                      ItemsPerSecond,
+                                      Index + 1U < std::size(m_Results) ? "," : "");
+            }
+
+            Output += "  ]\n}\n";
+
+            return Output;
+        }
+    };
+
+    // Reads the results written by BenchmarkRunner::ToJSON, one benchmark per line
+    export std::optional<std::vector<BenchmarkResult>> LoadBenchmarkResults(strzilla::string_view const Path)
+    {
+        std::ifstream InputFile { std::data(Path) };
+
+        if (!InputFile.is_open())
+        {
+            return std::nullopt;
+        }
+
+        std::vector<BenchmarkResult> Output {};
+        std::string                  Line {};
+
+        while (std::getline(InputFile, Line))
+        {
+            std::optional<std::string_view> const Name   = FindJSONString(Line, "name");
+            std::optional<double> const           Median = FindJSONNumber(Line, "median_ns");
+
+            if (!Name.has_value() || !Median.has_value())
+            {
+                continue;
+            }
+
+            std::string const UnescapedName = UnescapeJSON(Name.value());
+
+            Output.push_back(BenchmarkResult {
+                    .Name = strzilla::string { std::data(UnescapedName), std::size(UnescapedName) },
+                    .Items = static_cast<std::uint64_t>(FindJSONNumber(Line, "items").value_or(0.)),
+                    .Iterations = static_cast<std::uint64_t>(FindJSONNumber(Line, "iterations").value_or(0.)),
+                    .Median = Median.value(),
+                    .Mean = FindJSONNumber(Line, "mean_ns").value_or(0.),
+                    .Min = FindJSONNumber(Line, "min_ns").value_or(0.),
+                    .Max = FindJSONNumber(Line, "max_ns").value_or(0.),
+                    .MedianAbsoluteDeviation = FindJSONNumber(Line, "mad_ns").value_or(0.)
+            });
+        }
+
+        return Output;
+    }
+
+    // Benchmarks missing from either side are ignored: renamed or new benchmarks can't regress
+    export std::vector<BenchmarkComparison> CompareBenchmarkResults(std::vector<BenchmarkResult> const &Baseline,
+                                                                    std::vector<BenchmarkResult> const &Current,
+                                                                    RegressionSettings const &          Settings)
+    {
+        // Scales a MAD to the standard deviation of normally distributed samples
+        constexpr double MADToStandardDeviation { 1.4826 };
+
+        std::vector<BenchmarkComparison> Output {};
+
+        for (BenchmarkResult const &CurrentIt : Current)
+        {
+            auto const Match = std::ranges::find(Baseline, CurrentIt.Name, &BenchmarkResult::Name);
+
+            if (Match == std::end(Baseline) || Match->Median <= 0.)
+            {
+                continue;
+            }
+
+            double const Difference = CurrentIt.Median - Match->Median;
+            double const Deviation  = MADToStandardDeviation * std::hypot(CurrentIt.MedianAbsoluteDeviation, Match->MedianAbsoluteDeviation);
+
+            BenchmarkComparison Comparison {
+                    .Name = CurrentIt.Name,
+                    .BaselineMedian = Match->Median,
+                    .CurrentMedian = CurrentIt.Median,
+                    .RelativeChange = Difference / Match->Median
+            };
+
+            Comparison.IsSignificant = std::abs(Comparison.RelativeChange) > Settings.Threshold && std::abs(Difference) > Settings.DeviationFactor * Deviation;
+
+            Output.push_back(std::move(Comparison));
+        }
+
+        return Output;
+    }
+} // namespace Benchmarks
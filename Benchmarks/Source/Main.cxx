@@ -0,0 +1,529 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+import Benchmarks.Frames;
+import Benchmarks.Harness;
+
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Model;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Scene;
+import RenderCore.Types.Camera;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Object;
+import RenderCore.Types.Texture;
+import RenderCore.Types.Transform;
+import RenderCore.Types.Vertex;
+
+using namespace RenderCore;
+using namespace Benchmarks;
+
+struct CommandLineOptions
+{
+    BenchmarkSettings      Settings {};
+    FrameBenchmarkSettings FrameSettings {};
+    RegressionSettings     Regression {};
+    strzilla::string       OutputPath { "BenchmarkResults.json" };
+    strzilla::string       BaselinePath {};
+    std::uint32_t          NumObjects { 10000U };
+    std::uint32_t          GridSize { 181U };
+    std::uint32_t          RunFrames { 1U };
+};
+
+struct SyntheticPrimitive
+{
+    tinygltf::Model     Model {};
+    tinygltf::Primitive Primitive {};
+};
+
+CommandLineOptions ParseCommandLine(int const Argc, char const *const *Argv)
+{
+    CommandLineOptions Output {};
+
+    auto const ParseNumber = [](std::string_view const Value, auto &Target)
+    {
+        std::from_chars(std::data(Value), std::data(Value) + std::size(Value), Target);
+    };
+
+    for (int Index = 1; Index + 1 < Argc; Index += 2)
+    {
+        std::string_view const Key { Argv[Index] };
+        std::string_view const Value { Argv[Index + 1] };
+
+        if (Key == "--output")
+        {
+            Output.OutputPath = strzilla::string { std::data(Value), std::size(Value) };
+        }
+        else if (Key == "--filter")
+        {
+            Output.Settings.Filter = strzilla::string { std::data(Value), std::size(Value) };
+        }
+        else if (Key == "--samples")
+        {
+            ParseNumber(Value, Output.Settings.Samples);
+        }
+        else if (Key == "--objects")
+        {
+            ParseNumber(Value, Output.NumObjects);
+        }
+        else if (Key == "--grid")
+        {
+            ParseNumber(Value, Output.GridSize);
+        }
+        else if (Key == "--baseline")
+        {
+            Output.BaselinePath = strzilla::string { std::data(Value), std::size(Value) };
+        }
+        else if (Key == "--threshold")
+        {
+            ParseNumber(Value, Output.Regression.Threshold);
+        }
+        else if (Key == "--deviations")
+        {
+            ParseNumber(Value, Output.Regression.DeviationFactor);
+        }
+        else if (Key == "--frames")
+        {
+            ParseNumber(Value, Output.RunFrames);
+        }
+        else if (Key == "--frame-width")
+        {
+            ParseNumber(Value, Output.FrameSettings.Extent.width);
+        }
+        else if (Key == "--frame-height")
+        {
+            ParseNumber(Value, Output.FrameSettings.Extent.height);
+        }
+        else if (Key == "--device")
+        {
+            Output.FrameSettings.Device = strzilla::string { std::data(Value), std::size(Value) };
+        }
+    }
+
+    Output.Settings.Samples = std::max(Output.Settings.Samples, 1U);
+    Output.NumObjects       = std::max(Output.NumObjects, 1U);
+    Output.GridSize         = std::clamp(Output.GridSize, 2U, 255U);
+
+    Output.FrameSettings.Extent.width  = std::max(Output.FrameSettings.Extent.width, 1U);
+    Output.FrameSettings.Extent.height = std::max(Output.FrameSettings.Extent.height, 1U);
+
+    return Output;
+}
+
+template <typename ValueType>
+void AddAccessor(tinygltf::Model &              Model,
+                 tinygltf::Primitive &          Primitive,
+                 std::vector<ValueType> const & Data,
+                 int const                      Type,
+                 int const                      ComponentType,
+                 std::string_view const         Attribute)
+{
+    tinygltf::Buffer &Buffer     = Model.buffers.at(0U);
+    std::size_t const ByteOffset = std::size(Buffer.data);
+    std::size_t const ByteLength = std::size(Data) * sizeof(ValueType);
+
+    Buffer.data.resize(ByteOffset + ByteLength);
+    std::copy_n(reinterpret_cast<unsigned char const *>(std::data(Data)), ByteLength, std::data(Buffer.data) + ByteOffset);
+
+    tinygltf::BufferView &BufferView = Model.bufferViews.emplace_back();
+    BufferView.buffer                = 0;
+    BufferView.byteOffset            = ByteOffset;
+    BufferView.byteLength            = ByteLength;
+
+    tinygltf::Accessor &Accessor = Model.accessors.emplace_back();
+    Accessor.bufferView          = static_cast<int>(std::size(Model.bufferViews) - 1U);
+    Accessor.type                = Type;
+    Accessor.componentType       = ComponentType;
+    Accessor.count               = std::size(Data) / static_cast<std::size_t>(tinygltf::GetNumComponentsInType(Type));
+
+    auto const AccessorIndex = static_cast<int>(std::size(Model.accessors) - 1U);
+
+    if (std::empty(Attribute))
+    {
+        Primitive.indices = AccessorIndex;
+    }
+    else
+    {
+        Primitive.attributes.emplace(std::string { Attribute }, AccessorIndex);
+    }
+}
+
+void GenerateGrid(std::uint32_t const GridSize, std::vector<Vertex> &Vertices, std::vector<std::uint32_t> &Indices)
+{
+    Vertices.clear();
+    Indices.clear();
+
+    Vertices.reserve(GridSize * GridSize);
+    Indices.reserve((GridSize - 1U) * (GridSize - 1U) * 6U);
+
+    float const Step = 1.F / static_cast<float>(GridSize - 1U);
+
+    for (std::uint32_t Row = 0U; Row < GridSize; ++Row)
+    {
+        for (std::uint32_t Column = 0U; Column < GridSize; ++Column)
+        {
+            glm::vec2 const Coordinate { static_cast<float>(Column) * Step, static_cast<float>(Row) * Step };
+
+            Vertices.push_back(Vertex {
+                    .Position = glm::vec3(Coordinate.x - 0.5F, std::sin(Coordinate.x * 6.F) * std::cos(Coordinate.y * 6.F) * 0.1F, Coordinate.y - 0.5F),
+                    .Normal = glm::vec3(0.F, 1.F, 0.F),
+                    .TextureCoordinate = Coordinate,
+                    .Color = glm::vec4(Coordinate, 1.F, 1.F),
+                    .Tangent = glm::vec4(1.F, 0.F, 0.F, 1.F)
+            });
+        }
+    }
+
+    for (std::uint32_t Row = 0U; Row + 1U < GridSize; ++Row)
+    {
+        for (std::uint32_t Column = 0U; Column + 1U < GridSize; ++Column)
+        {
+            std::uint32_t const TopLeft    = Row * GridSize + Column;
+            std::uint32_t const BottomLeft = TopLeft + GridSize;
+
+            Indices.insert(std::end(Indices), { TopLeft, BottomLeft, TopLeft + 1U, TopLeft + 1U, BottomLeft, BottomLeft + 1U });
+        }
+    }
+}
+
+SyntheticPrimitive CreateSyntheticPrimitive(std::uint32_t const GridSize, int const IndexComponentType)
+{
+    std::vector<Vertex>        Vertices;
+    std::vector<std::uint32_t> Indices;
+    GenerateGrid(GridSize, Vertices, Indices);
+
+    SyntheticPrimitive Output {};
+    Output.Model.buffers.emplace_back();
+
+    std::vector<float> Positions;
+    std::vector<float> Normals;
+    std::vector<float> TextureCoordinates;
+    std::vector<float> Colors;
+    std::vector<float> Tangents;
+
+    for (Vertex const &VertexIt : Vertices)
+    {
+        Positions.insert(std::end(Positions), { VertexIt.Position.x, VertexIt.Position.y, VertexIt.Position.z });
+        Normals.insert(std::end(Normals), { VertexIt.Normal.x, VertexIt.Normal.y, VertexIt.Normal.z });
+        TextureCoordinates.insert(std::end(TextureCoordinates), { VertexIt.TextureCoordinate.x, VertexIt.TextureCoordinate.y });
+        Colors.insert(std::end(Colors), { VertexIt.Color.x, VertexIt.Color.y, VertexIt.Color.z, VertexIt.Color.w });
+        Tangents.insert(std::end(Tangents), { VertexIt.Tangent.x, VertexIt.Tangent.y, VertexIt.Tangent.z, VertexIt.Tangent.w });
+    }
+
+    constexpr int FloatType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+
+    AddAccessor(Output.Model, Output.Primitive, Positions, TINYGLTF_TYPE_VEC3, FloatType, "POSITION");
+    AddAccessor(Output.Model, Output.Primitive, Normals, TINYGLTF_TYPE_VEC3, FloatType, "NORMAL");
+    AddAccessor(Output.Model, Output.Primitive, TextureCoordinates, TINYGLTF_TYPE_VEC2, FloatType, "TEXCOORD_0");
+    AddAccessor(Output.Model, Output.Primitive, Colors, TINYGLTF_TYPE_VEC4, FloatType, "COLOR_0");
+    AddAccessor(Output.Model, Output.Primitive, Tangents, TINYGLTF_TYPE_VEC4, FloatType, "TANGENT");
+
+    if (IndexComponentType == TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT)
+    {
+        std::vector<std::uint16_t> ShortIndices(std::begin(Indices), std::end(Indices));
+        AddAccessor(Output.Model, Output.Primitive, ShortIndices, TINYGLTF_TYPE_SCALAR, IndexComponentType, "");
+    }
+    else
+    {
+        AddAccessor(Output.Model, Output.Primitive, Indices, TINYGLTF_TYPE_SCALAR, IndexComponentType, "");
+    }
+
+    return Output;
+}
+
+std::vector<std::shared_ptr<Object>> CreateSceneObjects(std::uint32_t const NumObjects)
+{
+    std::vector<Vertex>        Vertices;
+    std::vector<std::uint32_t> Indices;
+    GenerateGrid(4U, Vertices, Indices);
+
+    // Fixed seed linear congruential generator, so every run places the objects at the same locations
+    std::uint32_t Seed = 42U;
+
+    auto const GetRandom = [&Seed](float const Min, float const Max)
+    {
+        Seed = Seed * 1664525U + 1013904223U;
+        return Min + static_cast<float>(Seed >> 8U) / static_cast<float>(1U << 24U) * (Max - Min);
+    };
+
+    std::vector<std::shared_ptr<Object>> Output;
+    Output.reserve(NumObjects);
+
+    for (std::uint32_t ObjectIt = 0U; ObjectIt < NumObjects; ++ObjectIt)
+    {
+        auto NewMesh = std::make_shared<Mesh>(ObjectIt, "Benchmark");
+        NewMesh->SetVertices(Vertices);
+        NewMesh->SetIndices(Indices);
+
+        Transform MeshTransform {};
+        MeshTransform.SetPosition(glm::vec3(GetRandom(-100.F, 100.F), GetRandom(-100.F, 100.F), GetRandom(-100.F, 100.F)));
+        MeshTransform.SetRotation(glm::vec3(GetRandom(0.F, 360.F), GetRandom(0.F, 360.F), GetRandom(0.F, 360.F)));
+        NewMesh->SetTransform(MeshTransform);
+        NewMesh->SetupBounds();
+
+        auto NewObject = std::make_shared<Object>(ObjectIt, "Benchmark");
+        NewObject->SetMesh(NewMesh);
+        NewObject->SetTransform(MeshTransform);
+
+        Output.push_back(std::move(NewObject));
+    }
+
+    return Output;
+}
+
+void RunModelBenchmarks(BenchmarkRunner &Runner, CommandLineOptions const &Options)
+{
+    auto const Mesh = std::make_shared<RenderCore::Mesh>(0U, "Benchmark");
+
+    {
+        SyntheticPrimitive const Primitive = CreateSyntheticPrimitive(Options.GridSize, TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT);
+        std::uint64_t const      NumVertices = Primitive.Model.accessors.at(Primitive.Primitive.attributes.at("POSITION")).count;
+        std::uint64_t const      NumIndices  = Primitive.Model.accessors.at(Primitive.Primitive.indices).count;
+
+        Runner.Run("Model/SetVertexAttributes",
+                   NumVertices,
+                   [&]
+                   {
+                       SetVertexAttributes(Mesh, Primitive.Model, Primitive.Primitive);
+                   });
+
+        Runner.Run("Model/AllocatePrimitiveIndices/UInt32",
+                   NumIndices,
+                   [&]
+                   {
+                       AllocatePrimitiveIndices(Mesh, Primitive.Model, Primitive.Primitive);
+                   });
+    }
+
+    {
+        SyntheticPrimitive const Primitive  = CreateSyntheticPrimitive(Options.GridSize, TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT);
+        std::uint64_t const      NumIndices = Primitive.Model.accessors.at(Primitive.Primitive.indices).count;
+
+        Runner.Run("Model/AllocatePrimitiveIndices/UInt16",
+                   NumIndices,
+                   [&]
+                   {
+                       AllocatePrimitiveIndices(Mesh, Primitive.Model, Primitive.Primitive);
+                   });
+    }
+}
+
+void RunMeshBenchmarks(BenchmarkRunner &Runner, CommandLineOptions const &Options)
+{
+    std::vector<Vertex>        Vertices;
+    std::vector<std::uint32_t> Indices;
+    GenerateGrid(Options.GridSize, Vertices, Indices);
+
+    // Unindexed triangle soup, so the vertex remap has duplicates to fold
+    std::vector<Vertex> SoupVertices;
+    SoupVertices.reserve(std::size(Indices));
+
+    for (std::uint32_t const Index : Indices)
+    {
+        SoupVertices.push_back(Vertices.at(Index));
+    }
+
+    std::vector<std::uint32_t> SoupIndices(std::size(SoupVertices));
+    std::iota(std::begin(SoupIndices), std::end(SoupIndices), 0U);
+
+    auto const Mesh = std::make_shared<RenderCore::Mesh>(0U, "Benchmark");
+
+    Runner.Run("Mesh/Optimize",
+               std::size(SoupIndices),
+               [&]
+               {
+                   Mesh->SetVertices(SoupVertices);
+                   Mesh->SetIndices(SoupIndices);
+               },
+               [&]
+               {
+                   Mesh->Optimize();
+               });
+
+    Mesh->SetVertices(Vertices);
+    Mesh->SetIndices(Indices);
+
+    Runner.Run("Mesh/SetupBounds",
+               std::size(Vertices),
+               [&]
+               {
+                   Mesh->SetupBounds();
+                   DoNotOptimize(Mesh->GetBounds());
+               });
+}
+
+void RunSceneBenchmarks(BenchmarkRunner &Runner, CommandLineOptions const &Options)
+{
+    std::vector<std::shared_ptr<Object>> const Objects = CreateSceneObjects(Options.NumObjects);
+
+    {
+        Camera const ViewCamera {};
+
+        std::array<glm::vec4, 6U> FrustumPlanes {};
+        Camera::CalculateFrustumPlanes(ViewCamera.GetProjectionMatrix(16.F / 9.F) * ViewCamera.GetViewMatrix(), FrustumPlanes);
+
+        Runner.Run("Camera/CanDrawObject",
+                   std::size(Objects),
+                   [&]
+                   {
+                       std::uint32_t Visible = 0U;
+
+                       for (std::shared_ptr<Object> const &ObjectIt : Objects)
+                       {
+                           Visible += ViewCamera.CanDrawObject(ObjectIt, FrustumPlanes) ? 1U : 0U;
+                       }
+
+                       DoNotOptimize(Visible);
+                   });
+    }
+
+    Runner.Run("Transform/GetMatrix",
+               std::size(Objects),
+               [&]
+               {
+                   for (std::shared_ptr<Object> const &ObjectIt : Objects)
+                   {
+                       glm::mat4 const Matrix = ObjectIt->GetTransform().GetMatrix();
+                       DoNotOptimize(Matrix);
+                   }
+               });
+
+    GetObjects() = Objects;
+
+    Runner.Run("Scene/TickObjects",
+               std::size(Objects),
+               []
+               {
+                   TickObjects(0.016F);
+               });
+
+    GetObjects().clear();
+
+    Runner.Run("Memory/PackModelsBuffers",
+               std::size(Objects),
+               [&]
+               {
+                   std::vector<Vertex>        Vertices;
+                   std::vector<std::uint32_t> Indices;
+
+                   ModelsBufferLayout const Layout = PackModelsBuffers(Objects, 256U, Vertices, Indices);
+                   DoNotOptimize(Layout);
+               });
+
+    // GPU calls are stubbed: descriptors are written to host memory and the descriptor fetch is a no-op
+    vkGetDescriptorEXT = [](VkDevice, VkDescriptorGetInfoEXT const *, std::size_t, void *)
+    {
+    };
+
+    constexpr VkDeviceSize DescriptorLayoutSize { 64U };
+    constexpr std::size_t  NumTextures { static_cast<std::size_t>(TextureType::Count) };
+
+    std::vector<unsigned char> ModelDescriptors(std::size(Objects) * DescriptorLayoutSize);
+    std::vector<unsigned char> TextureDescriptors(std::size(Objects) * NumTextures * DescriptorLayoutSize);
+
+    PipelineDescriptorData DescriptorData {};
+    DescriptorData.ModelData.LayoutSize          = DescriptorLayoutSize;
+    DescriptorData.ModelData.Buffer.MappedData   = std::data(ModelDescriptors);
+    DescriptorData.TextureData.LayoutSize        = DescriptorLayoutSize;
+    DescriptorData.TextureData.Buffer.MappedData = std::data(TextureDescriptors);
+
+    Runner.Run("Pipeline/WriteModelsDescriptors",
+               std::size(Objects),
+               [&]
+               {
+                   DescriptorData.WriteModelsDescriptors(Objects, 0U, VkDescriptorImageInfo {});
+               });
+
+    vkGetDescriptorEXT = nullptr;
+}
+
+// Returns the number of significant regressions, or nullopt if the baseline couldn't be read
+std::optional<std::uint32_t> CompareWithBaseline(BenchmarkRunner const &Runner, CommandLineOptions const &Options)
+{
+    std::optional<std::vector<BenchmarkResult>> const Baseline = LoadBenchmarkResults(Options.BaselinePath);
+
+    if (!Baseline.has_value())
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: " << std::format("Failed to open baseline file: {}", std::data(Options.BaselinePath));
+        return std::nullopt;
+    }
+
+    std::uint32_t NumRegressions = 0U;
+
+    for (BenchmarkComparison const &Comparison : CompareBenchmarkResults(Baseline.value(), Runner.GetResults(), Options.Regression))
+    {
+        auto const Message = std::format("{:<48} {:>14.1f} -> {:>14.1f} ns/op {:>+8.2f}%",
+                                         std::data(Comparison.Name),
+                                         Comparison.BaselineMedian,
+                                         Comparison.CurrentMedian,
+                                         Comparison.RelativeChange * 100.);
+
+        if (Comparison.IsRegression())
+        {
+            BOOST_LOG_TRIVIAL(error) << Message << " REGRESSION";
+            ++NumRegressions;
+        }
+        else if (Comparison.IsImprovement())
+        {
+            BOOST_LOG_TRIVIAL(info) << Message << " improvement";
+        }
+        else
+        {
+            BOOST_LOG_TRIVIAL(info) << Message;
+        }
+    }
+
+    return NumRegressions;
+}
+
+int main(int const Argc, char const *const *Argv)
+{
+    CommandLineOptions const Options = ParseCommandLine(Argc, Argv);
+    BenchmarkRunner          Runner { Options.Settings };
+
+    RunModelBenchmarks(Runner, Options);
+    RunMeshBenchmarks(Runner, Options);
+    RunSceneBenchmarks(Runner, Options);
+
+    if (Options.RunFrames != 0U)
+    {
+        RunFrameBenchmarks(Runner, Options.FrameSettings);
+    }
+
+    std::ofstream OutputFile { std::data(Options.OutputPath), std::ios::trunc };
+
+    if (!OutputFile.is_open())
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: " << std::format("Failed to open output file: {}", std::data(Options.OutputPath));
+        return EXIT_FAILURE;
+    }
+
+    OutputFile << Runner.ToJSON();
+
+    OutputFile.close();
+
+    BOOST_LOG_TRIVIAL(info) << "[" << __func__ << "]: " << std::format("Results written to {}", std::data(Options.OutputPath));
+
+    if (std::empty(Options.BaselinePath))
+    {
+        return EXIT_SUCCESS;
+    }
+
+    std::optional<std::uint32_t> const NumRegressions = CompareWithBaseline(Runner, Options);
+
+    if (!NumRegressions.has_value())
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (NumRegressions.value() > 0U)
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: " << std::format("{} benchmark(s) regressed against {}",
+                                                                            NumRegressions.value(),
+                                                                            std::data(Options.BaselinePath));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
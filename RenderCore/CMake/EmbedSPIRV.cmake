@@ -0,0 +1,37 @@
+# Author: Lucas Vilas-Boas
+# Year: 2024
+# Repo: https://github.com/lucoiso/vulkan-renderer
+
+# Usage: cmake -DINPUT_FILE=<spv> -DOUTPUT_FILE=<hpp> -DVARIABLE_NAME=<name> -P EmbedSPIRV.cmake
+
+IF (NOT DEFINED INPUT_FILE OR NOT DEFINED OUTPUT_FILE OR NOT DEFINED VARIABLE_NAME)
+    MESSAGE(FATAL_ERROR "[CMake Script] [RenderCore]: INPUT_FILE, OUTPUT_FILE and VARIABLE_NAME must be defined")
+ENDIF ()
+
+FILE(READ ${INPUT_FILE} SPIRV_HEX_CONTENT HEX)
+STRING(LENGTH "${SPIRV_HEX_CONTENT}" SPIRV_HEX_LENGTH)
+
+MATH(EXPR SPIRV_WORD_REMAINDER "${SPIRV_HEX_LENGTH} % 8")
+IF (SPIRV_HEX_LENGTH EQUAL 0 OR NOT SPIRV_WORD_REMAINDER EQUAL 0)
+    MESSAGE(FATAL_ERROR "[CMake Script] [RenderCore]: Invalid SPIR-V binary: ${INPUT_FILE}")
+ENDIF ()
+
+MATH(EXPR SPIRV_WORD_COUNT "${SPIRV_HEX_LENGTH} / 8")
+
+# SPIR-V binaries are little-endian sequences of 32-bit words
+STRING(REGEX REPLACE "(..)(..)(..)(..)" "        0x\\4\\3\\2\\1U,\n" SPIRV_WORDS "${SPIRV_HEX_CONTENT}")
+
+GET_FILENAME_COMPONENT(INPUT_FILE_NAME ${INPUT_FILE} NAME)
+
+FILE(WRITE ${OUTPUT_FILE}.tmp
+        "// Generated from ${INPUT_FILE_NAME} by RenderCore/CMake/EmbedSPIRV.cmake - do not edit\n\n"
+        "#pragma once\n\n"
+        "#include <array>\n"
+        "#include <cstdint>\n\n"
+        "inline constexpr std::array<std::uint32_t, ${SPIRV_WORD_COUNT}U> ${VARIABLE_NAME} {\n"
+        "${SPIRV_WORDS}"
+        "};\n"
+)
+
+FILE(COPY_FILE ${OUTPUT_FILE}.tmp ${OUTPUT_FILE} ONLY_IF_DIFFERENT)
+FILE(REMOVE ${OUTPUT_FILE}.tmp)
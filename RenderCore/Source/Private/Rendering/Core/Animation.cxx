@@ -0,0 +1,82 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.Animation;
+
+import RenderCore.Runtime.Command;
+import RenderCore.Runtime.Skinning;
+import RenderCore.Types.Skeleton;
+import RenderCore.Utils.CPUTopology;
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+std::vector<Skeleton *>   g_AnimatedSkeletons {};
+std::unique_ptr<JobGraph> g_AnimationJobGraph {};
+
+// Only the skeletons that move a skinned object are evaluated, and the paused ones are left out of the batches;
+// the list is rebuilt with the graph, so it must not be scheduled again before the previous jobs are finished
+void RenderCore::ScheduleAnimations(JobGraph &Graph, JobHandle const Before, JobHandle const After, float const DeltaTime)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    g_AnimatedSkeletons.clear();
+
+    for (std::shared_ptr<Skeleton> const &SkeletonIt : GetSkinnedSkeletons())
+    {
+        if (SkeletonIt->IsAnimating())
+        {
+            g_AnimatedSkeletons.push_back(SkeletonIt.get());
+        }
+    }
+
+    auto const NumSkeletons = static_cast<std::uint32_t>(std::size(g_AnimatedSkeletons));
+
+    for (std::uint32_t FirstIndex = 0U; FirstIndex < NumSkeletons; FirstIndex += g_AnimationBatchSize)
+    {
+        std::uint32_t const LastIndex = std::min(FirstIndex + g_AnimationBatchSize, NumSkeletons);
+
+        JobHandle const BatchJob = Graph.AddJob("Animation Task",
+                                                [FirstIndex, LastIndex, DeltaTime]
+                                                {
+                                                    for (std::uint32_t Index = FirstIndex; Index < LastIndex; ++Index)
+                                                    {
+                                                        g_AnimatedSkeletons.at(Index)->Animate(DeltaTime);
+                                                    }
+                                                });
+
+        if (Before)
+        {
+            Graph.AddDependency(Before, BatchJob);
+        }
+
+        if (After)
+        {
+            Graph.AddDependency(BatchJob, After);
+        }
+    }
+}
+
+// The scene thread isn't a worker of the pool, so it waits on its own graph without holding back the frame being recorded
+void RenderCore::TickAnimations(float const DeltaTime)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    if (!g_AnimationJobGraph)
+    {
+        g_AnimationJobGraph = std::make_unique<JobGraph>(GetThreadPool(), GetNumWorkers(WorkerClass::Recording));
+    }
+
+    g_AnimationJobGraph->Reset();
+    ScheduleAnimations(*g_AnimationJobGraph, nullptr, nullptr, DeltaTime);
+    g_AnimationJobGraph->Wait();
+}
+
+void RenderCore::ReleaseAnimationResources()
+{
+    g_AnimationJobGraph.reset();
+    g_AnimatedSkeletons.clear();
+}
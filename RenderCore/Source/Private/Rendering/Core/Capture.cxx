@@ -0,0 +1,777 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.Capture;
+
+import RenderCore.Runtime.ClusteredLighting;
+import RenderCore.Runtime.Command;
+import RenderCore.Runtime.Device;
+import RenderCore.Runtime.ImageExport;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Scene;
+import RenderCore.Runtime.SwapChain;
+import RenderCore.Types.Allocation;
+import RenderCore.Types.Camera;
+import RenderCore.Types.Illumination;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Object;
+import RenderCore.Types.Transform;
+import RenderCore.Types.UniformBufferObject;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.Helpers;
+import RenderCore.Utils.AllocationCallbacks;
+import RenderCore.Utils.Logger;
+
+using namespace RenderCore;
+
+struct CaptureTile
+{
+    VkOffset2D Offset {};
+    VkExtent2D Extent {};
+};
+
+struct CaptureTargets
+{
+    ImageAllocation ColorImage {};
+    ImageAllocation DepthImage {};
+
+    void Allocate(VkExtent2D const &);
+    void Destroy(VmaAllocator const &);
+};
+
+void CaptureTargets::Allocate(VkExtent2D const &Extent)
+{
+    constexpr VkImageUsageFlags ColorUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    constexpr VkImageUsageFlags DepthUsage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    ColorImage.Extent = Extent;
+    ColorImage.Format = GetSwapChainImageFormat();
+
+    CreateImage(ColorImage.Format, Extent, g_ImageTiling, ColorUsage, g_TextureMemoryUsage, "CAPTURE_COLOR", ColorImage.Image, ColorImage.Allocation);
+    CreateImageView(ColorImage.Image, ColorImage.Format, g_ImageAspect, ColorImage.View);
+
+    DepthImage.Extent                    = Extent;
+    DepthImage.Format                    = GetDepthImage().Format;
+    VkImageAspectFlags const DepthAspect = DepthHasStencil(DepthImage.Format) ? g_DepthAspect | VK_IMAGE_ASPECT_STENCIL_BIT : g_DepthAspect;
+
+    CreateImage(DepthImage.Format, Extent, g_ImageTiling, DepthUsage, g_TextureMemoryUsage, "CAPTURE_DEPTH", DepthImage.Image, DepthImage.Allocation);
+    CreateImageView(DepthImage.Image, DepthImage.Format, DepthAspect, DepthImage.View);
+}
+
+void CaptureTargets::Destroy(VmaAllocator const &Allocator)
+{
+    ColorImage.DestroyResources(Allocator);
+    DepthImage.DestroyResources(Allocator);
+}
+
+void CreateReadbackBuffer(BufferAllocation &Buffer, VkExtent2D const &Extent)
+{
+    constexpr std::uint8_t Components { 4U };
+    Buffer.Size = static_cast<VkDeviceSize>(Extent.width) * Extent.height * Components;
+
+    VkBufferCreateInfo const BufferInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = Buffer.Size,
+            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+
+    VmaAllocationCreateInfo const AllocationCreateInfo { .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT, .usage = VMA_MEMORY_USAGE_CPU_ONLY };
+
+    VmaAllocator const &Allocator = GetAllocator();
+    VmaAllocationInfo   AllocationInfo {};
+    CheckVulkanResult(vmaCreateBuffer(Allocator, &BufferInfo, &AllocationCreateInfo, &Buffer.Buffer, &Buffer.Allocation, &AllocationInfo));
+
+    vmaSetAllocationName(Allocator, Buffer.Allocation, "Buffer: CAPTURE_READBACK");
+    Buffer.MappedData = AllocationInfo.pMappedData;
+}
+
+void DestroyReadbackBuffer(BufferAllocation &Buffer)
+{
+    // Persistently mapped by VMA, must not be unmapped manually
+    Buffer.MappedData = nullptr;
+    Buffer.DestroyResources(GetAllocator());
+}
+
+SceneUniformData MountSceneUniformData(glm::mat4 const &ProjectionView)
+{
+    Camera const &      Camera       = GetCamera();
+    Illumination const &Illumination = GetIllumination();
+
+    SceneUniformData Output {
+            .ProjectionView = ProjectionView,
+            .LightPosition = Illumination.GetPosition(),
+            .LightColor = Illumination.GetColor() * Illumination.GetIntensity(),
+            .AmbientLight = Illumination.GetAmbient()
+    };
+
+    // The clusters binned for the camera are reused, so the lookup must go through the camera projection
+    FillClusterUniformData(Output,
+                           Camera.GetViewMatrix(),
+                           Camera.GetProjectionMatrix(),
+                           Camera.GetNearPlane(),
+                           Camera.GetFarPlane(),
+                           std::size(Illumination.GetPointLights()));
+
+    return Output;
+}
+
+glm::mat4 MountTileProjection(glm::mat4 const &Projection, VkExtent2D const &Extent, CaptureTile const &Tile)
+{
+    auto const Width      = static_cast<float>(Extent.width);
+    auto const Height     = static_cast<float>(Extent.height);
+    auto const TileWidth  = static_cast<float>(Tile.Extent.width);
+    auto const TileHeight = static_cast<float>(Tile.Extent.height);
+
+    float const ScaleX  = Width / TileWidth;
+    float const ScaleY  = Height / TileHeight;
+    float const CenterX = (2.F * static_cast<float>(Tile.Offset.x) + TileWidth) / Width - 1.F;
+    float const CenterY = (2.F * static_cast<float>(Tile.Offset.y) + TileHeight) / Height - 1.F;
+
+    // Scale and shift the clip space so only the tile's region of the full image covers the viewport
+    glm::mat4 TileMatrix { 1.F };
+    TileMatrix[0][0] = ScaleX;
+    TileMatrix[1][1] = ScaleY;
+    TileMatrix[3][0] = -ScaleX * CenterX;
+    TileMatrix[3][1] = -ScaleY * CenterY;
+
+    return TileMatrix * Projection;
+}
+
+void RecordCaptureCommands(VkCommandBuffer const & CommandBuffer,
+                           CaptureTargets const &  Targets,
+                           BufferAllocation const &ReadbackBuffer,
+                           VkExtent2D const &      RenderExtent,
+                           Camera const &          Camera,
+                           glm::mat4 const &       ProjectionView)
+{
+    ImageAllocation const &ColorImage = Targets.ColorImage;
+    ImageAllocation const &DepthImage = Targets.DepthImage;
+
+    std::array PreRenderBarriers {
+            MountImageBarrier<g_UndefinedLayout, g_AttachmentLayout, g_ImageAspect>(ColorImage.Image, ColorImage.Format),
+            MountImageBarrier<g_UndefinedLayout, g_AttachmentLayout, g_DepthAspect>(DepthImage.Image, DepthImage.Format)
+    };
+
+    // Targets may be reused by consecutive submissions, so wait for the previous readback copy
+    PreRenderBarriers.at(0U).srcStageMask |= VK_PIPELINE_STAGE_2_COPY_BIT;
+
+    VkDependencyInfo const PreRenderDependency {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .imageMemoryBarrierCount = static_cast<std::uint32_t>(std::size(PreRenderBarriers)),
+            .pImageMemoryBarriers = std::data(PreRenderBarriers)
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &PreRenderDependency);
+
+    VkRenderingAttachmentInfo const ColorAttachment {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+            .imageView = ColorImage.View,
+            .imageLayout = g_AttachmentLayout,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .clearValue = g_ClearValues.at(0U)
+    };
+
+    VkRenderingAttachmentInfo const DepthAttachment {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+            .imageView = DepthImage.View,
+            .imageLayout = g_AttachmentLayout,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .clearValue = g_ClearValues.at(1U)
+    };
+
+    VkRenderingInfo const RenderingInfo {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+            .renderArea = { .offset = { 0, 0 }, .extent = RenderExtent },
+            .layerCount = 1U,
+            .colorAttachmentCount = 1U,
+            .pColorAttachments = &ColorAttachment,
+            .pDepthAttachment = &DepthAttachment,
+            .pStencilAttachment = &DepthAttachment
+    };
+
+    vkCmdBeginRendering(CommandBuffer, &RenderingInfo);
+    {
+        VkViewport const Viewport {
+                .x = 0.F,
+                .y = 0.F,
+                .width = static_cast<float>(RenderExtent.width),
+                .height = static_cast<float>(RenderExtent.height),
+                .minDepth = 0.F,
+                .maxDepth = 1.F
+        };
+
+        VkRect2D const Scissor { .offset = { 0, 0 }, .extent = RenderExtent };
+
+        vkCmdSetViewport(CommandBuffer, 0U, 1U, &Viewport);
+        vkCmdSetScissor(CommandBuffer, 0U, 1U, &Scissor);
+
+        std::array<glm::vec4, 6U> FrustumPlanes {};
+        Camera::CalculateFrustumPlanes(ProjectionView, FrustumPlanes);
+
+        VkPipelineLayout const &PipelineLayout = GetPipelineLayout();
+        auto const &            Objects        = GetObjects();
+
+        vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, GetMainPipeline());
+
+        for (std::uint32_t ObjectIndex = 0U; ObjectIndex < std::size(Objects); ++ObjectIndex)
+        {
+            if (auto const &Object = Objects.at(ObjectIndex);
+                Object->GetMesh() && Camera.CanDrawObject(Object, FrustumPlanes))
+            {
+                Object->DrawObject(CommandBuffer, PipelineLayout, ObjectIndex);
+            }
+        }
+    }
+    vkCmdEndRendering(CommandBuffer);
+
+    VkImageMemoryBarrier2 const PreCopyBarrier {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT,
+            .oldLayout = g_AttachmentLayout,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = ColorImage.Image,
+            .subresourceRange = { .aspectMask = g_ImageAspect, .baseMipLevel = 0U, .levelCount = 1U, .baseArrayLayer = 0U, .layerCount = 1U }
+    };
+
+    VkDependencyInfo const PreCopyDependency {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .imageMemoryBarrierCount = 1U,
+            .pImageMemoryBarriers = &PreCopyBarrier
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &PreCopyDependency);
+
+    VkBufferImageCopy const Region {
+            .bufferOffset = 0U,
+            .bufferRowLength = 0U,
+            .bufferImageHeight = 0U,
+            .imageSubresource = { .aspectMask = g_ImageAspect, .mipLevel = 0U, .baseArrayLayer = 0U, .layerCount = 1U },
+            .imageOffset = { 0, 0, 0 },
+            .imageExtent = { .width = RenderExtent.width, .height = RenderExtent.height, .depth = 1U }
+    };
+
+    vkCmdCopyImageToBuffer(CommandBuffer, ColorImage.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, ReadbackBuffer.Buffer, 1U, &Region);
+
+    VkBufferMemoryBarrier2 const HostReadBarrier {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT,
+            .dstAccessMask = VK_ACCESS_2_HOST_READ_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = ReadbackBuffer.Buffer,
+            .offset = 0U,
+            .size = VK_WHOLE_SIZE
+    };
+
+    VkDependencyInfo const HostReadDependency {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = 1U,
+            .pBufferMemoryBarriers = &HostReadBarrier
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &HostReadDependency);
+}
+
+void WriteTileToFile(std::fstream &      File,
+                     std::size_t const   HeaderSize,
+                     VkExtent2D const &  Extent,
+                     CaptureTile const & Tile,
+                     std::uint8_t const *TileData,
+                     bool const          SwapRedAndBlue)
+{
+    constexpr std::size_t Components { 4U };
+    std::size_t const     RowSize = static_cast<std::size_t>(Tile.Extent.width) * Components;
+
+    std::vector<std::uint8_t> Row(RowSize);
+
+    for (std::uint32_t RowIndex = 0U; RowIndex < Tile.Extent.height; ++RowIndex)
+    {
+        std::memcpy(std::data(Row), TileData + RowIndex * RowSize, RowSize);
+
+        if (SwapRedAndBlue)
+        {
+            for (std::size_t Iterator = 0U; Iterator < RowSize; Iterator += Components)
+            {
+                std::swap(Row[Iterator], Row[Iterator + 2U]);
+            }
+        }
+
+        std::size_t const ImageRow = static_cast<std::size_t>(Tile.Offset.y) + RowIndex;
+        std::size_t const Position = HeaderSize + (ImageRow * Extent.width + static_cast<std::size_t>(Tile.Offset.x)) * Components;
+
+        File.seekp(static_cast<std::streamoff>(Position));
+        File.write(reinterpret_cast<char const *>(std::data(Row)), static_cast<std::streamsize>(RowSize));
+    }
+}
+
+bool RenderCore::CaptureTiledImage(strzilla::string_view const Path, TiledCaptureSettings const &Settings)
+{
+    VkExtent2D const &Extent = Settings.Extent;
+
+    if (Extent.width == 0U || Extent.height == 0U)
+    {
+        RENDERCORE_LOG(error, "Invalid capture extent");
+        return false;
+    }
+
+    if (GetMainPipeline() == VK_NULL_HANDLE || !GetDepthImage().IsValid())
+    {
+        RENDERCORE_LOG(error, "Render resources are not ready");
+        return false;
+    }
+
+    ImageExportFormat const Format = GetImageExportFormatFromPath(Path);
+
+    if (Format != ImageExportFormat::TGA && Format != ImageExportFormat::RAW)
+    {
+        RENDERCORE_LOG(error, "Tiled captures are streamed to disk and only support '.tga' and '.raw' outputs");
+        return false;
+    }
+
+    constexpr std::uint32_t MaxTGADimension { std::numeric_limits<std::uint16_t>::max() };
+
+    if (Format == ImageExportFormat::TGA && (Extent.width > MaxTGADimension || Extent.height > MaxTGADimension))
+    {
+        RENDERCORE_LOG(error, "Extent exceeds the maximum TGA dimension of {}", MaxTGADimension);
+        return false;
+    }
+
+    VkPhysicalDeviceLimits const &Limits   = GetPhysicalDeviceProperties().limits;
+    std::uint32_t const           TileSize = std::max(std::min({ Settings.MaxTileSize,
+                                                                 Limits.maxImageDimension2D,
+                                                                 Limits.maxViewportDimensions[0],
+                                                                 Limits.maxViewportDimensions[1] }),
+                                                      1U);
+
+    VkExtent2D const TileExtent { .width = std::min(TileSize, Extent.width), .height = std::min(TileSize, Extent.height) };
+
+    std::uint32_t const NumTilesX = (Extent.width + TileExtent.width - 1U) / TileExtent.width;
+    std::uint32_t const NumTilesY = (Extent.height + TileExtent.height - 1U) / TileExtent.height;
+
+    std::filesystem::path const OutputPath { std::data(Path) };
+    std::size_t                 HeaderSize { 0U };
+    {
+        std::ofstream Output { OutputPath, std::ios::binary | std::ios::trunc };
+
+        if (!Output.is_open())
+        {
+            RENDERCORE_LOG(error, "Failed to open output file: '{}'", std::data(Path));
+            return false;
+        }
+
+        if (Format == ImageExportFormat::TGA)
+        {
+            std::array<std::uint8_t, 18U> const Header = MountTGAHeader(Extent);
+            Output.write(reinterpret_cast<char const *>(std::data(Header)), static_cast<std::streamsize>(std::size(Header)));
+            HeaderSize = std::size(Header);
+        }
+    }
+
+    // Reserve the whole file upfront so each tile row can be written in place without holding the full image in memory
+    constexpr std::uintmax_t Components { 4U };
+    std::filesystem::resize_file(OutputPath, HeaderSize + static_cast<std::uintmax_t>(Extent.width) * Extent.height * Components);
+
+    std::fstream File { OutputPath, std::ios::binary | std::ios::in | std::ios::out };
+
+    if (!File.is_open())
+    {
+        RENDERCORE_LOG(error, "Failed to open output file: '{}'", std::data(Path));
+        return false;
+    }
+
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+    CheckVulkanResult(vkDeviceWaitIdle(LogicalDevice));
+
+    RENDERCORE_LOG(info,
+                   "Capturing {}x{} image in {}x{} tiles of {}x{}",
+                   Extent.width,
+                   Extent.height,
+                   NumTilesX,
+                   NumTilesY,
+                   TileExtent.width,
+                   TileExtent.height);
+
+    CaptureTargets Targets {};
+    Targets.Allocate(TileExtent);
+
+    BufferAllocation ReadbackBuffer {};
+    CreateReadbackBuffer(ReadbackBuffer, TileExtent);
+
+    UpdateObjectsUniformBuffer();
+
+    auto const &[FamilyIndex, Queue] = GetGraphicsQueue();
+
+    Camera const &  Camera         = GetCamera();
+    glm::mat4 const Projection     = Camera.GetProjectionMatrix(static_cast<float>(Extent.width) / static_cast<float>(Extent.height));
+    glm::mat4 const View           = Camera.GetViewMatrix();
+    bool const      SwapRedAndBlue = (Format == ImageExportFormat::TGA) != IsBGRAFormat(Targets.ColorImage.Format);
+
+    // Written back after the tiles: with the render thread, the frame being recorded may come from a state that doesn't upload the scene again
+    SceneUniformData LiveUBO {};
+    std::memcpy(&LiveUBO, GetSceneUniformData(), sizeof(SceneUniformData));
+
+    for (std::uint32_t TileY = 0U; TileY < NumTilesY; ++TileY)
+    {
+        for (std::uint32_t TileX = 0U; TileX < NumTilesX; ++TileX)
+        {
+            CaptureTile const Tile {
+                    .Offset = { .x = static_cast<std::int32_t>(TileX * TileExtent.width), .y = static_cast<std::int32_t>(TileY * TileExtent.height) },
+                    .Extent = { .width = std::min(TileExtent.width, Extent.width - TileX * TileExtent.width),
+                                .height = std::min(TileExtent.height, Extent.height - TileY * TileExtent.height) }
+            };
+
+            glm::mat4 const TileProjectionView = MountTileProjection(Projection, Extent, Tile) * View;
+
+            // The queue is idle between tiles, so the scene buffer can be rewritten directly
+            SceneUniformData const TileUBO = MountSceneUniformData(TileProjectionView);
+
+            std::memcpy(GetSceneUniformData(), &TileUBO, sizeof(SceneUniformData));
+
+            VkCommandPool                CommandPool { VK_NULL_HANDLE };
+            std::vector<VkCommandBuffer> CommandBuffers { VK_NULL_HANDLE };
+
+            InitializeSingleCommandQueue(CommandPool, CommandBuffers, FamilyIndex);
+            RecordCaptureCommands(CommandBuffers.at(0U), Targets, ReadbackBuffer, Tile.Extent, Camera, TileProjectionView);
+            FinishSingleCommandQueue(Queue, CommandPool, CommandBuffers);
+
+            CheckVulkanResult(vmaInvalidateAllocation(GetAllocator(), ReadbackBuffer.Allocation, 0U, VK_WHOLE_SIZE));
+
+            WriteTileToFile(File,
+                            HeaderSize,
+                            Extent,
+                            Tile,
+                            static_cast<std::uint8_t const *>(ReadbackBuffer.MappedData),
+                            SwapRedAndBlue);
+        }
+    }
+
+    std::memcpy(GetSceneUniformData(), &LiveUBO, sizeof(SceneUniformData));
+
+    DestroyReadbackBuffer(ReadbackBuffer);
+    Targets.Destroy(GetAllocator());
+    Camera.SetRenderDirty(true);
+
+    if (!File.good())
+    {
+        RENDERCORE_LOG(error, "Failed to write output file: '{}'", std::data(Path));
+        return false;
+    }
+
+    return true;
+}
+
+struct BatchFrameSlot
+{
+    VkCommandPool    CommandPool { VK_NULL_HANDLE };
+    VkCommandBuffer  CommandBuffer { VK_NULL_HANDLE };
+    VkFence          Fence { VK_NULL_HANDLE };
+    BufferAllocation ReadbackBuffer {};
+    bool             IsPending { false };
+
+    void Allocate(VkDevice const &, std::uint8_t, VkExtent2D const &);
+    void Destroy(VkDevice const &);
+};
+
+void BatchFrameSlot::Allocate(VkDevice const &LogicalDevice, std::uint8_t const QueueFamilyIndex, VkExtent2D const &Extent)
+{
+    CommandPool = CreateCommandPool(QueueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+    VkCommandBufferAllocateInfo const CommandBufferAllocateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = CommandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1U
+    };
+
+    CheckVulkanResult(vkAllocateCommandBuffers(LogicalDevice, &CommandBufferAllocateInfo, &CommandBuffer));
+
+    constexpr VkFenceCreateInfo FenceCreateInfo { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    CheckVulkanResult(vkCreateFence(LogicalDevice, &FenceCreateInfo, GetAllocationCallbacks(HostAllocationTag::Synchronization), &Fence));
+
+    CreateReadbackBuffer(ReadbackBuffer, Extent);
+}
+
+void BatchFrameSlot::Destroy(VkDevice const &LogicalDevice)
+{
+    DestroyReadbackBuffer(ReadbackBuffer);
+
+    if (Fence != VK_NULL_HANDLE)
+    {
+        vkDestroyFence(LogicalDevice, Fence, GetAllocationCallbacks(HostAllocationTag::Synchronization));
+        Fence = VK_NULL_HANDLE;
+    }
+
+    if (CommandPool != VK_NULL_HANDLE)
+    {
+        vkDestroyCommandPool(LogicalDevice, CommandPool, GetAllocationCallbacks(HostAllocationTag::Commands));
+        CommandPool   = VK_NULL_HANDLE;
+        CommandBuffer = VK_NULL_HANDLE;
+    }
+}
+
+// Formatted once with the first frame index: a string that fails here would throw in the middle of the batch, with frames still in flight
+bool IsValidOutputPathFormat(strzilla::string_view const Format)
+{
+    try
+    {
+        constexpr std::uint32_t FrameIndex { 0U };
+        [[maybe_unused]] std::string const _ = std::vformat(std::string_view { std::data(Format), std::size(Format) }, std::make_format_args(FrameIndex));
+    }
+    catch (std::format_error const &Error)
+    {
+        RENDERCORE_LOG(error, "Invalid output path format '{}': {}", std::data(Format), Error.what());
+        return false;
+    }
+
+    return true;
+}
+
+void RecordUniformUpdates(VkCommandBuffer const &                                        CommandBuffer,
+                          SceneUniformData const &                                       SceneData,
+                          std::vector<std::pair<VkDeviceSize, ModelUniformData>> const &ModelData)
+{
+    // Uniforms are updated in queue order, so frames still in flight keep reading their own values
+    VkMemoryBarrier2 const PreUpdateBarrier {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT,
+            .srcAccessMask = VK_ACCESS_2_NONE,
+            .dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            .dstAccessMask = VK_ACCESS_2_NONE
+    };
+
+    VkDependencyInfo const PreUpdateDependency {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .memoryBarrierCount = 1U,
+            .pMemoryBarriers = &PreUpdateBarrier
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &PreUpdateDependency);
+
+    vkCmdUpdateBuffer(CommandBuffer, GetSceneUniformBuffer().Buffer, 0U, sizeof(SceneUniformData), &SceneData);
+
+    for (auto const &[Offset, ModelUBO] : ModelData)
+    {
+        vkCmdUpdateBuffer(CommandBuffer, GetAllocationBuffer(), Offset, sizeof(ModelUniformData), &ModelUBO);
+    }
+
+    VkMemoryBarrier2 const PostUpdateBarrier {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT,
+            .dstAccessMask = VK_ACCESS_2_UNIFORM_READ_BIT
+    };
+
+    VkDependencyInfo const PostUpdateDependency {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .memoryBarrierCount = 1U,
+            .pMemoryBarriers = &PostUpdateBarrier
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &PostUpdateDependency);
+}
+
+bool RenderCore::RenderBatch(BatchRenderRequest const &Request)
+{
+    if (std::empty(Request.Frames))
+    {
+        RENDERCORE_LOG(warning, "No frames to render");
+        return false;
+    }
+
+    if (!Request.Sink && std::empty(Request.OutputPathFormat))
+    {
+        RENDERCORE_LOG(error, "A sink or an output path format is required");
+        return false;
+    }
+
+    if (!Request.Sink && !IsValidOutputPathFormat(Request.OutputPathFormat))
+    {
+        return false;
+    }
+
+    if (GetMainPipeline() == VK_NULL_HANDLE || !GetDepthImage().IsValid())
+    {
+        RENDERCORE_LOG(error, "Render resources are not ready");
+        return false;
+    }
+
+    VkExtent2D const Extent = Request.Extent.width > 0U && Request.Extent.height > 0U ? Request.Extent : GetSwapChainExtent();
+
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+    CheckVulkanResult(vkDeviceWaitIdle(LogicalDevice));
+
+    UpdateObjectsUniformBuffer();
+
+    auto const &Objects = GetObjects();
+
+    std::unordered_map<std::uint32_t, std::uint32_t> ObjectIndices {};
+    for (std::uint32_t ObjectIndex = 0U; ObjectIndex < std::size(Objects); ++ObjectIndex)
+    {
+        ObjectIndices.emplace(Objects.at(ObjectIndex)->GetID(), ObjectIndex);
+    }
+
+    // Objects transformed by any frame have to be rewritten on every frame so the next ones start from the right state
+    std::vector<std::uint32_t> AnimatedObjects {};
+    for (BatchRenderFrame const &FrameIt : Request.Frames)
+    {
+        for (BatchObjectTransform const &TransformIt : FrameIt.ObjectTransforms)
+        {
+            if (auto const MatchingIt = ObjectIndices.find(TransformIt.ObjectID);
+                MatchingIt != std::end(ObjectIndices) && Objects.at(MatchingIt->second)->GetMesh())
+            {
+                AnimatedObjects.push_back(MatchingIt->second);
+            }
+        }
+    }
+
+    std::ranges::sort(AnimatedObjects);
+    AnimatedObjects.erase(std::ranges::unique(AnimatedObjects).begin(), std::end(AnimatedObjects));
+
+    auto const &[FamilyIndex, Queue] = GetGraphicsQueue();
+
+    CaptureTargets Targets {};
+    Targets.Allocate(Extent);
+
+    std::array<BatchFrameSlot, g_ImageCount> Slots {};
+    for (BatchFrameSlot &SlotIt : Slots)
+    {
+        SlotIt.Allocate(LogicalDevice, FamilyIndex, Extent);
+    }
+
+    auto const     NumFrames   = static_cast<std::uint32_t>(std::size(Request.Frames));
+    float const    AspectRatio = static_cast<float>(Extent.width) / static_cast<float>(Extent.height);
+    VkFormat const PixelFormat = Targets.ColorImage.Format;
+    std::uint32_t  NextFrameToConsume { 0U };
+
+    auto ConsumeFrame = [&](std::uint32_t const FrameIndex)
+    {
+        BatchFrameSlot &Slot = Slots.at(FrameIndex % g_ImageCount);
+
+        CheckVulkanResult(vkWaitForFences(LogicalDevice, 1U, &Slot.Fence, VK_TRUE, g_Timeout));
+        CheckVulkanResult(vkResetFences(LogicalDevice, 1U, &Slot.Fence));
+        CheckVulkanResult(vmaInvalidateAllocation(GetAllocator(), Slot.ReadbackBuffer.Allocation, 0U, VK_WHOLE_SIZE));
+
+        auto const *const         Data = static_cast<std::uint8_t const *>(Slot.ReadbackBuffer.MappedData);
+        std::vector<std::uint8_t> Pixels(Data, Data + Slot.ReadbackBuffer.Size);
+        Slot.IsPending = false;
+
+        if (Request.Sink)
+        {
+            Request.Sink(FrameIndex, Extent, PixelFormat, std::move(Pixels));
+        }
+        else
+        {
+            strzilla::string const Path = std::vformat(std::data(Request.OutputPathFormat), std::make_format_args(FrameIndex));
+
+            EnqueueImageExport(ImageExportRequest {
+                    .Path = Path,
+                    .Format = GetImageExportFormatFromPath(Path),
+                    .Extent = Extent,
+                    .PixelFormat = PixelFormat,
+                    .Pixels = std::move(Pixels)
+            });
+        }
+
+        ++NextFrameToConsume;
+    };
+
+    constexpr VkCommandBufferBeginInfo BeginInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+
+    std::vector<std::pair<VkDeviceSize, ModelUniformData>> ModelData {};
+    ModelData.reserve(std::size(AnimatedObjects));
+
+    for (std::uint32_t FrameIndex = 0U; FrameIndex < NumFrames; ++FrameIndex)
+    {
+        BatchFrameSlot &Slot = Slots.at(FrameIndex % g_ImageCount);
+
+        if (Slot.IsPending)
+        {
+            ConsumeFrame(NextFrameToConsume);
+        }
+
+        BatchRenderFrame const &Frame = Request.Frames.at(FrameIndex);
+
+        Camera PoseCamera = GetCamera();
+        PoseCamera.SetPosition(Frame.Pose.Position);
+        PoseCamera.SetRotation(Frame.Pose.Rotation);
+
+        glm::mat4 const ProjectionView = PoseCamera.GetProjectionMatrix(AspectRatio) * PoseCamera.GetViewMatrix();
+
+        ModelData.clear();
+        for (std::uint32_t const ObjectIndex : AnimatedObjects)
+        {
+            std::shared_ptr<Object> const &Object          = Objects.at(ObjectIndex);
+            Transform const *              ObjectTransform = &Object->GetTransform();
+
+            if (auto const MatchingIt = std::ranges::find(Frame.ObjectTransforms, Object->GetID(), &BatchObjectTransform::ObjectID);
+                MatchingIt != std::end(Frame.ObjectTransforms))
+            {
+                ObjectTransform = &MatchingIt->ObjectTransform;
+            }
+
+            ModelData.emplace_back(Object->GetUniformOffset(), Object->GetUniformData(*ObjectTransform));
+        }
+
+        CheckVulkanResult(vkResetCommandPool(LogicalDevice, Slot.CommandPool, 0U));
+        CheckVulkanResult(vkBeginCommandBuffer(Slot.CommandBuffer, &BeginInfo));
+        RecordUniformUpdates(Slot.CommandBuffer, MountSceneUniformData(ProjectionView), ModelData);
+        RecordCaptureCommands(Slot.CommandBuffer, Targets, Slot.ReadbackBuffer, Extent, PoseCamera, ProjectionView);
+        CheckVulkanResult(vkEndCommandBuffer(Slot.CommandBuffer));
+
+        VkCommandBufferSubmitInfo const CommandBufferInfo { .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, .commandBuffer = Slot.CommandBuffer };
+
+        VkSubmitInfo2 const SubmitInfo {
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+                .commandBufferInfoCount = 1U,
+                .pCommandBufferInfos = &CommandBufferInfo
+        };
+
+        CheckVulkanResult(vkQueueSubmit2(Queue, 1U, &SubmitInfo, Slot.Fence));
+        Slot.IsPending = true;
+
+        // Hand finished frames over as soon as they are ready so their readback overlaps the frames still in flight
+        while (NextFrameToConsume < FrameIndex && vkGetFenceStatus(LogicalDevice, Slots.at(NextFrameToConsume % g_ImageCount).Fence) == VK_SUCCESS)
+        {
+            ConsumeFrame(NextFrameToConsume);
+        }
+    }
+
+    while (NextFrameToConsume < NumFrames)
+    {
+        ConsumeFrame(NextFrameToConsume);
+    }
+
+    for (BatchFrameSlot &SlotIt : Slots)
+    {
+        SlotIt.Destroy(LogicalDevice);
+    }
+
+    Targets.Destroy(GetAllocator());
+
+    // The batch overwrote the live uniforms, force them to be uploaded again on the next frame
+    GetCamera().SetRenderDirty(true);
+    for (std::shared_ptr<Object> const &ObjectIt : Objects)
+    {
+        ObjectIt->MarkAsRenderDirty();
+    }
+
+    return true;
+}
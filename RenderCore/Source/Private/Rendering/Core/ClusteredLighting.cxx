@@ -0,0 +1,300 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.ClusteredLighting;
+
+import RenderCore.Renderer;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+struct ClusterBounds
+{
+    glm::vec3 Min {};
+    glm::vec3 Max {};
+};
+
+// Host binning scratch: the counts are uploaded at once, the indices are written straight to the mapped buffer
+std::vector<std::uint32_t> g_ClusterLightCounts(g_NumClusters, 0U);
+std::vector<ClusterBounds> g_ClusterBounds(g_NumClusters);
+glm::vec4                  g_ClusterBoundsProjection {};
+
+float GetClusterSliceDepth(glm::vec4 const &ClusterProjection, std::uint32_t const Slice)
+{
+    float const Near = ClusterProjection.z;
+    float const Far  = ClusterProjection.w;
+
+    return Near * std::pow(Far / Near, static_cast<float>(Slice) / static_cast<float>(g_ClusterGridZ));
+}
+
+std::uint32_t GetClusterSlice(glm::vec4 const &ClusterProjection, float const Depth)
+{
+    float const Near  = ClusterProjection.z;
+    float const Far   = ClusterProjection.w;
+    float const Slice = std::log(Depth / Near) / std::log(Far / Near) * static_cast<float>(g_ClusterGridZ);
+
+    return static_cast<std::uint32_t>(std::clamp(static_cast<std::int32_t>(std::floor(Slice)), 0, static_cast<std::int32_t>(g_ClusterGridZ) - 1));
+}
+
+std::uint32_t GetClusterTile(float const NDC, std::uint32_t const NumTiles)
+{
+    float const Tile = std::floor((NDC * 0.5F + 0.5F) * static_cast<float>(NumTiles));
+    return static_cast<std::uint32_t>(std::clamp(static_cast<std::int32_t>(Tile), 0, static_cast<std::int32_t>(NumTiles) - 1));
+}
+
+// Tiles are NDC ranges, unprojected at the slice depths with the projection scale: the same math as the culling shader
+void UpdateClusterBounds(glm::vec4 const &ClusterProjection)
+{
+    if (g_ClusterBoundsProjection == ClusterProjection)
+    {
+        return;
+    }
+
+    g_ClusterBoundsProjection = ClusterProjection;
+
+    for (std::uint32_t Z = 0U; Z < g_ClusterGridZ; ++Z)
+    {
+        std::array const Depths { GetClusterSliceDepth(ClusterProjection, Z), GetClusterSliceDepth(ClusterProjection, Z + 1U) };
+
+        for (std::uint32_t Y = 0U; Y < g_ClusterGridY; ++Y)
+        {
+            for (std::uint32_t X = 0U; X < g_ClusterGridX; ++X)
+            {
+                ClusterBounds Bounds { .Min = glm::vec3 { std::numeric_limits<float>::max() }, .Max = glm::vec3 { std::numeric_limits<float>::lowest() } };
+
+                for (float const DepthIt : Depths)
+                {
+                    for (std::uint32_t Corner = 0U; Corner < 4U; ++Corner)
+                    {
+                        float const TileX = -1.F + 2.F * static_cast<float>(X + (Corner & 1U)) / static_cast<float>(g_ClusterGridX);
+                        float const TileY = -1.F + 2.F * static_cast<float>(Y + (Corner >> 1U)) / static_cast<float>(g_ClusterGridY);
+
+                        glm::vec3 const Point { TileX * DepthIt / ClusterProjection.x, TileY * DepthIt / ClusterProjection.y, -DepthIt };
+
+                        Bounds.Min = min(Bounds.Min, Point);
+                        Bounds.Max = max(Bounds.Max, Point);
+                    }
+                }
+
+                g_ClusterBounds.at(X + Y * g_ClusterGridX + Z * g_ClusterGridX * g_ClusterGridY) = Bounds;
+            }
+        }
+    }
+}
+
+bool SphereIntersectsBox(glm::vec3 const &Center, float const Radius, ClusterBounds const &Bounds)
+{
+    glm::vec3 const Closest = clamp(Center, Bounds.Min, Bounds.Max);
+    glm::vec3 const Delta   = Closest - Center;
+
+    return dot(Delta, Delta) <= Radius * Radius;
+}
+
+// CPU fallback of the culling shader: each light only visits the clusters under its conservative screen and depth range
+void BinLightsOnHost(std::span<PointLight const> const Lights, SceneUniformData const &SceneData)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    glm::vec4 const &ClusterProjection = SceneData.ClusterProjection;
+    UpdateClusterBounds(ClusterProjection);
+
+    std::ranges::fill(g_ClusterLightCounts, 0U);
+
+    auto const ClusterIndices = reinterpret_cast<std::uint32_t *>(static_cast<unsigned char *>(g_ClusterBuffer.MappedData) + g_ClusterCountsSize);
+
+    for (std::uint32_t LightIndex = 0U; LightIndex < std::size(Lights); ++LightIndex)
+    {
+        PointLight const &Light  = Lights[LightIndex];
+        glm::vec3 const   Center { SceneData.View * glm::vec4 { Light.Position, 1.F } };
+
+        float const MinDepth = std::max(-Center.z - Light.Radius, ClusterProjection.z);
+        float const MaxDepth = std::min(-Center.z + Light.Radius, ClusterProjection.w);
+
+        if (MinDepth > MaxDepth)
+        {
+            continue;
+        }
+
+        // x / depth is monotonic in depth, so the screen bounds of the sphere lie on the depth range ends
+        glm::vec2 MinNDC { std::numeric_limits<float>::max() };
+        glm::vec2 MaxNDC { std::numeric_limits<float>::lowest() };
+
+        for (float const DepthIt : { MinDepth, MaxDepth })
+        {
+            for (float const OffsetIt : { -Light.Radius, Light.Radius })
+            {
+                glm::vec2 const NDC { (Center.x + OffsetIt) * ClusterProjection.x / DepthIt, (Center.y + OffsetIt) * ClusterProjection.y / DepthIt };
+
+                MinNDC = min(MinNDC, NDC);
+                MaxNDC = max(MaxNDC, NDC);
+            }
+        }
+
+        if (MinNDC.x > 1.F || MinNDC.y > 1.F || MaxNDC.x < -1.F || MaxNDC.y < -1.F)
+        {
+            continue;
+        }
+
+        std::uint32_t const MinX = GetClusterTile(MinNDC.x, g_ClusterGridX);
+        std::uint32_t const MaxX = GetClusterTile(MaxNDC.x, g_ClusterGridX);
+        std::uint32_t const MinY = GetClusterTile(MinNDC.y, g_ClusterGridY);
+        std::uint32_t const MaxY = GetClusterTile(MaxNDC.y, g_ClusterGridY);
+        std::uint32_t const MinZ = GetClusterSlice(ClusterProjection, MinDepth);
+        std::uint32_t const MaxZ = GetClusterSlice(ClusterProjection, MaxDepth);
+
+        for (std::uint32_t Z = MinZ; Z <= MaxZ; ++Z)
+        {
+            for (std::uint32_t Y = MinY; Y <= MaxY; ++Y)
+            {
+                for (std::uint32_t X = MinX; X <= MaxX; ++X)
+                {
+                    std::uint32_t const ClusterIndex = X + Y * g_ClusterGridX + Z * g_ClusterGridX * g_ClusterGridY;
+                    std::uint32_t &     Count        = g_ClusterLightCounts.at(ClusterIndex);
+
+                    if (Count < g_MaxLightsPerCluster && SphereIntersectsBox(Center, Light.Radius, g_ClusterBounds.at(ClusterIndex)))
+                    {
+                        ClusterIndices[ClusterIndex * g_MaxLightsPerCluster + Count] = LightIndex;
+                        ++Count;
+                    }
+                }
+            }
+        }
+    }
+
+    std::memcpy(g_ClusterBuffer.MappedData, std::data(g_ClusterLightCounts), g_ClusterCountsSize);
+}
+
+void RenderCore::CreateClusteredLightingResources()
+{
+    VmaAllocator const &         Allocator  = GetAllocator();
+    constexpr VkBufferUsageFlags UsageFlags = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+    constexpr VkDeviceSize LightBufferSize = g_MaxPointLights * sizeof(GPUPointLight);
+
+    g_PointLightBuffer.Size = LightBufferSize;
+    CreateBuffer(LightBufferSize, UsageFlags, "POINT_LIGHTS", g_PointLightBuffer.Buffer, g_PointLightBuffer.Allocation);
+    vmaMapMemory(Allocator, g_PointLightBuffer.Allocation, &g_PointLightBuffer.MappedData);
+
+    g_ClusterBuffer.Size = g_ClusterBufferSize;
+    CreateBuffer(g_ClusterBufferSize, UsageFlags, "LIGHT_CLUSTERS", g_ClusterBuffer.Buffer, g_ClusterBuffer.Allocation);
+    vmaMapMemory(Allocator, g_ClusterBuffer.Allocation, &g_ClusterBuffer.MappedData);
+
+    std::memset(g_ClusterBuffer.MappedData, 0, g_ClusterCountsSize);
+}
+
+void RenderCore::ReleaseClusteredLightingResources()
+{
+    VmaAllocator const &Allocator = GetAllocator();
+
+    g_PointLightBuffer.DestroyResources(Allocator);
+    g_ClusterBuffer.DestroyResources(Allocator);
+
+    g_ClusterBoundsProjection = glm::vec4 {};
+}
+
+// Tiled captures pass the camera projection, not the tile one: fragments look the lists up from their view space position
+void RenderCore::FillClusterUniformData(SceneUniformData & SceneData,
+                                        glm::mat4 const &  View,
+                                        glm::mat4 const &  Projection,
+                                        float const        Near,
+                                        float const        Far,
+                                        std::size_t const  NumLights)
+{
+    SceneData.View              = View;
+    SceneData.ClusterProjection = glm::vec4 { Projection[0][0], Projection[1][1], Near, Far };
+    SceneData.ClusterGrid       = glm::uvec4 {
+            g_ClusterGridX,
+            g_ClusterGridY,
+            g_ClusterGridZ,
+            static_cast<std::uint32_t>(std::min<std::size_t>(NumLights, g_MaxPointLights))
+    };
+}
+
+void RenderCore::UpdateClusteredLighting(std::span<PointLight const> const Lights, SceneUniformData const &SceneData)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    if (!g_PointLightBuffer.IsValid() || !g_ClusterBuffer.IsValid())
+    {
+        return;
+    }
+
+    std::uint32_t const NumLights = SceneData.ClusterGrid.w;
+    auto const          GPULights = static_cast<GPUPointLight *>(g_PointLightBuffer.MappedData);
+
+    for (std::uint32_t LightIndex = 0U; LightIndex < NumLights; ++LightIndex)
+    {
+        PointLight const &Light = Lights[LightIndex];
+
+        GPULights[LightIndex] = GPUPointLight {
+                .PositionRadius = glm::vec4 { Light.Position, Light.Radius },
+                .ColorIntensity = glm::vec4 { Light.Color, Light.Intensity }
+        };
+    }
+
+    if (!IsLightCullingOnGPU())
+    {
+        BinLightsOnHost(Lights.first(NumLights), SceneData);
+    }
+}
+
+void RenderCore::RecordLightCulling(VkCommandBuffer const &CommandBuffer)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    // The lists may still be read by the previous frame, shading either in the fragment stage or in the visibility resolve
+    VkBufferMemoryBarrier2 ClusterBarrier {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .srcAccessMask = VK_ACCESS_2_NONE,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = g_ClusterBuffer.Buffer,
+            .offset = 0U,
+            .size = VK_WHOLE_SIZE
+    };
+
+    VkDependencyInfo const DependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = 1U,
+            .pBufferMemoryBarriers = &ClusterBarrier
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+
+    DescriptorData const &SceneData = GetPipelineDescriptorData().SceneData;
+
+    VkDescriptorBufferBindingInfoEXT const BufferBindingInfo {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+            .address = SceneData.BufferDeviceAddress.deviceAddress,
+            .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+    };
+
+    constexpr std::uint32_t BufferIndex { 0U };
+
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, GetLightCullingPipeline());
+    vkCmdBindDescriptorBuffersEXT(CommandBuffer, 1U, &BufferBindingInfo);
+    vkCmdSetDescriptorBufferOffsetsEXT(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, GetPipelineLayout(), 0U, 1U, &BufferIndex, &SceneData.LayoutOffset);
+
+    constexpr std::uint32_t NumGroups = (g_NumClusters + g_LightCullingGroupSize - 1U) / g_LightCullingGroupSize;
+    vkCmdDispatch(CommandBuffer, NumGroups, 1U, 1U);
+
+    ClusterBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ClusterBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    ClusterBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ClusterBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+}
+
+bool RenderCore::IsLightCullingOnGPU()
+{
+    return Renderer::GetUseGPULightCulling() && GetLightCullingPipeline() != VK_NULL_HANDLE;
+}
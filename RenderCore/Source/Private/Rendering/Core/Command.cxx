@@ -9,16 +9,23 @@ module RenderCore.Runtime.Command;
 using namespace RenderCore;
 
 import RenderCore.Renderer;
+import RenderCore.Runtime.ClusteredLighting;
 import RenderCore.Runtime.Device;
+import RenderCore.Runtime.DynamicResolution;
 import RenderCore.Runtime.Pipeline;
 import RenderCore.Runtime.Scene;
 import RenderCore.Runtime.Synchronization;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.SwapChain;
 import RenderCore.Runtime.Offscreen;
-import RenderCore.Types.Camera;
+import RenderCore.Runtime.RenderGraph;
+import RenderCore.Runtime.Skinning;
+import RenderCore.Runtime.VisibilityBuffer;
 import RenderCore.Utils.Helpers;
 import RenderCore.Utils.Constants;
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.AllocationCallbacks;
+import RenderCore.Utils.CPUTopology;
 
 constexpr VkCommandBufferBeginInfo g_CommandBufferBeginInfo {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
@@ -59,7 +66,7 @@ void ThreadResources::Destroy(VkDevice const &LogicalDevice)
 
     Free(LogicalDevice);
 
-    vkDestroyCommandPool(LogicalDevice, CommandPool, nullptr);
+    vkDestroyCommandPool(LogicalDevice, CommandPool, GetAllocationCallbacks(HostAllocationTag::Commands));
     CommandPool = VK_NULL_HANDLE;
 }
 
@@ -80,9 +87,10 @@ struct CommandResources
     VkCommandBuffer                                   PrimaryCommandBuffer { VK_NULL_HANDLE };
 };
 
-std::uint32_t                              g_ObjectsPerThread { 0U };
-std::uint32_t                              g_NumThreads { 0U };
-std::array<CommandResources, g_ImageCount> g_CommandResources {};
+std::uint32_t                                          g_ObjectsPerThread { 0U };
+std::uint32_t                                          g_NumThreads { 0U };
+std::array<CommandResources, g_ImageCount>             g_CommandResources {};
+std::array<std::unique_ptr<RenderGraph>, g_ImageCount> g_FrameRenderGraphs {};
 
 void RenderCore::SetNumObjectsPerThread(std::uint32_t const NumObjects)
 {
@@ -98,7 +106,22 @@ void RenderCore::SetNumObjectsPerThread(std::uint32_t const NumObjects)
 
 void RenderCore::ResetCommandPool(std::uint32_t const Index)
 {
-    g_ThreadPool.Wait();
+    if (g_FrameJobGraphs.at(Index))
+    {
+        g_FrameJobGraphs.at(Index)->Reset();
+    }
+
+    // The graph gives its memory back before the allocator of the slot is rewound
+    if (g_FrameRenderGraphs.at(Index))
+    {
+        g_FrameRenderGraphs.at(Index)->Reset();
+    }
+
+    if (g_FrameAllocators.at(Index))
+    {
+        g_FrameAllocators.at(Index)->Reset();
+    }
+
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
     std::for_each(std::execution::unseq,
@@ -117,9 +140,40 @@ void RenderCore::ResetCommandPool(std::uint32_t const Index)
     vkResetCommandPool(LogicalDevice, g_CommandResources.at(Index).PrimaryCommandPool, 0U);
 }
 
+// Summed over the last frame of every slot: no heap allocation there means what the allocators back fit in their capacity.
+// Allocations made outside of them, by the rest of the frame, aren't counted
+FrameAllocationStats RenderCore::GetFrameAllocationStats()
+{
+    FrameAllocationStats Output {};
+
+    for (std::unique_ptr<FrameAllocator> const &FrameAllocatorIt : g_FrameAllocators)
+    {
+        if (!FrameAllocatorIt)
+        {
+            continue;
+        }
+
+        FrameAllocationStats const Stats = FrameAllocatorIt->GetStats();
+        Output.NumAllocations += Stats.NumAllocations;
+        Output.NumHeapAllocations += Stats.NumHeapAllocations;
+        Output.UsedBytes += Stats.UsedBytes;
+        Output.Capacity += Stats.Capacity;
+        Output.TotalHeapAllocations += Stats.TotalHeapAllocations;
+    }
+
+    return Output;
+}
+
 void RenderCore::FreeCommandBuffers()
 {
-    g_ThreadPool.Wait();
+    for (std::unique_ptr<JobGraph> const &FrameJobGraphIt : g_FrameJobGraphs)
+    {
+        if (FrameJobGraphIt)
+        {
+            FrameJobGraphIt->Wait();
+        }
+    }
+
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
     std::for_each(std::execution::unseq,
@@ -141,9 +195,34 @@ void RenderCore::FreeCommandBuffers()
 
 void RenderCore::InitializeCommandsResources(std::uint32_t const QueueFamily)
 {
-    g_NumThreads = static_cast<std::uint8_t>(std::thread::hardware_concurrency());
+    InitializeWorkerLayout();
+
+    g_NumThreads = GetNumWorkers(WorkerClass::Recording);
     g_ThreadPool.SetupCPUThreads("RenderThread");
 
+    // Pool threads past the worker count never get a task; the others are named and pinned to their core from inside
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < g_NumThreads; ++ThreadIndex)
+    {
+        g_ThreadPool.AddTask([ThreadIndex]
+                             {
+                                 SetupCurrentWorkerThread(WorkerClass::Recording, ThreadIndex);
+                             },
+                             static_cast<std::uint8_t>(ThreadIndex));
+    }
+
+    g_ThreadPool.Wait();
+
+    for (std::unique_ptr<JobGraph> &FrameJobGraphIt : g_FrameJobGraphs)
+    {
+        FrameJobGraphIt = std::make_unique<JobGraph>(g_ThreadPool, g_NumThreads);
+    }
+
+    for (std::uint8_t Index = 0U; Index < g_ImageCount; ++Index)
+    {
+        g_FrameAllocators.at(Index)   = std::make_unique<FrameAllocator>();
+        g_FrameRenderGraphs.at(Index) = std::make_unique<RenderGraph>(g_FrameAllocators.at(Index).get());
+    }
+
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
     std::for_each(std::execution::unseq,
@@ -173,8 +252,19 @@ void RenderCore::InitializeCommandsResources(std::uint32_t const QueueFamily)
 
 void RenderCore::ReleaseCommandsResources()
 {
+    for (std::unique_ptr<JobGraph> &FrameJobGraphIt : g_FrameJobGraphs)
+    {
+        FrameJobGraphIt.reset();
+    }
+
     g_ThreadPool.Wait();
 
+    for (std::uint8_t Index = 0U; Index < g_ImageCount; ++Index)
+    {
+        g_FrameRenderGraphs.at(Index).reset();
+        g_FrameAllocators.at(Index).reset();
+    }
+
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
     std::for_each(std::execution::unseq,
@@ -194,7 +284,7 @@ void RenderCore::ReleaseCommandsResources()
 
                       CheckVulkanResult(vkResetCommandPool(LogicalDevice, CommandResourceIt.PrimaryCommandPool, 0U));
                       vkFreeCommandBuffers(LogicalDevice, CommandResourceIt.PrimaryCommandPool, 1U, &CommandResourceIt.PrimaryCommandBuffer);
-                      vkDestroyCommandPool(LogicalDevice, CommandResourceIt.PrimaryCommandPool, nullptr);
+                      vkDestroyCommandPool(LogicalDevice, CommandResourceIt.PrimaryCommandPool, GetAllocationCallbacks(HostAllocationTag::Commands));
                       CommandResourceIt.PrimaryCommandPool   = VK_NULL_HANDLE;
                       CommandResourceIt.PrimaryCommandBuffer = VK_NULL_HANDLE;
                   });
@@ -211,7 +301,7 @@ VkCommandPool RenderCore::CreateCommandPool(std::uint8_t const FamilyQueueIndex,
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
     VkCommandPool Output = VK_NULL_HANDLE;
-    CheckVulkanResult(vkCreateCommandPool(LogicalDevice, &CommandPoolCreateInfo, nullptr, &Output));
+    CheckVulkanResult(vkCreateCommandPool(LogicalDevice, &CommandPoolCreateInfo, GetAllocationCallbacks(HostAllocationTag::Commands), &Output));
 
     return Output;
 }
@@ -234,35 +324,13 @@ void SetViewport(VkCommandBuffer const &CommandBuffer, VkExtent2D const &SwapCha
 }
 
 void BeginRendering(VkCommandBuffer const &CommandBuffer,
-                    ImageAllocation const &SwapchainAllocation,
+                    ImageAllocation const &ColorAllocation,
                     ImageAllocation const &DepthAllocation,
-                    ImageAllocation const &OffscreenAllocation)
+                    VkExtent2D const &     RenderExtent)
 {
-    std::vector ImageBarriers {
-            RenderCore::MountImageBarrier<g_UndefinedLayout, g_AttachmentLayout,
-                                          g_ImageAspect>(SwapchainAllocation.Image, SwapchainAllocation.Format),
-            RenderCore::MountImageBarrier<g_UndefinedLayout, g_AttachmentLayout, g_DepthAspect>(DepthAllocation.Image, DepthAllocation.Format)
-    };
-
-    bool const &HasOffscreenRendering = Renderer::GetRenderOffscreen();
-
-    if (HasOffscreenRendering)
-    {
-        ImageBarriers.push_back(RenderCore::MountImageBarrier<g_UndefinedLayout, g_AttachmentLayout, g_ImageAspect>(OffscreenAllocation.Image,
-                                    OffscreenAllocation.Format));
-    }
-
-    VkDependencyInfo const DependencyInfo {
-            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            .imageMemoryBarrierCount = static_cast<std::uint32_t>(std::size(ImageBarriers)),
-            .pImageMemoryBarriers = std::data(ImageBarriers)
-    };
-
-    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
-
     VkRenderingAttachmentInfo const ColorAttachment {
             .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
-            .imageView = HasOffscreenRendering ? OffscreenAllocation.View : SwapchainAllocation.View,
+            .imageView = ColorAllocation.View,
             .imageLayout = g_AttachmentLayout,
             .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
             .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
@@ -281,7 +349,7 @@ void BeginRendering(VkCommandBuffer const &CommandBuffer,
     VkRenderingInfo const RenderingInfo {
             .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
             .flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT,
-            .renderArea = { .offset = { 0, 0 }, .extent = SwapchainAllocation.Extent },
+            .renderArea = { .offset = { 0, 0 }, .extent = RenderExtent },
             .layerCount = 1U,
             .colorAttachmentCount = 1U,
             .pColorAttachments = &ColorAttachment,
@@ -292,36 +360,20 @@ void BeginRendering(VkCommandBuffer const &CommandBuffer,
     vkCmdBeginRendering(CommandBuffer, &RenderingInfo);
 }
 
-void EndRendering(VkCommandBuffer const &CommandBuffer, ImageAllocation const &SwapchainAllocation, ImageAllocation const &OffscreenAllocation)
+std::pmr::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageIndex,
+                                                      SceneFrameState const &State,
+                                                      ImageAllocation const &ColorAllocation,
+                                                      ImageAllocation const &DepthAllocation,
+                                                      VkExtent2D const &     RenderExtent,
+                                                      bool const             WriteVisibility)
 {
-    vkCmdEndRendering(CommandBuffer);
-
-    if (Renderer::GetRenderOffscreen())
-    {
-        RenderCore::RequestImageLayoutTransition<g_AttachmentLayout, g_ReadLayout, g_ImageAspect>(CommandBuffer,
-                                                                                                  OffscreenAllocation.Image,
-                                                                                                  OffscreenAllocation.Format);
-    }
+    RENDERCORE_PROFILE_FUNCTION();
 
-    if (g_OnCommandBufferRecordCallback)
-    {
-        g_OnCommandBufferRecordCallback(CommandBuffer, SwapchainAllocation);
-    }
-
-    RenderCore::RequestImageLayoutTransition<g_AttachmentLayout, g_PresentLayout, g_ImageAspect>(CommandBuffer,
-                                                                                                 SwapchainAllocation.Image,
-                                                                                                 SwapchainAllocation.Format);
-}
-
-std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageIndex,
-                                                 ImageAllocation const &SwapchainAllocation,
-                                                 ImageAllocation const &DepthAllocation)
-{
     VkCommandBufferInheritanceRenderingInfo const InheritanceRenderingInfo {
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
             .flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT,
             .colorAttachmentCount = 1U,
-            .pColorAttachmentFormats = &SwapchainAllocation.Format,
+            .pColorAttachmentFormats = &ColorAllocation.Format,
             .depthAttachmentFormat = DepthAllocation.Format,
             .stencilAttachmentFormat = DepthAllocation.Format,
             .rasterizationSamples = g_MSAASamples,
@@ -336,26 +388,23 @@ std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageInd
     SecondaryBeginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
     SecondaryBeginInfo.pInheritanceInfo = &InheritanceInfo;
 
-    auto const &Objects = GetObjects();
-    if (Objects.empty())
+    if (std::empty(State.Objects))
     {
         return {};
     }
 
-    VkPipeline const &      Pipeline       = GetMainPipeline();
+    VkPipeline const &      Pipeline       = WriteVisibility ? GetVisibilityPipeline() : GetMainPipeline();
     VkPipelineLayout const &PipelineLayout = GetPipelineLayout();
-    Camera const &          Camera         = GetCamera();
 
-    std::vector<VkCommandBuffer> Output;
+    std::pmr::vector<VkCommandBuffer> Output { &GetFrameAllocator(ImageIndex) };
     Output.reserve(g_NumThreads);
 
     CommandResources const &CommandResources = g_CommandResources.at(ImageIndex);
 
-    std::vector<std::uint32_t> ThreadIndices(g_NumThreads);
-    std::iota(std::begin(ThreadIndices), std::end(ThreadIndices), 0U);
-
     auto ProcessCommandBuffer = [&](std::uint32_t const ThreadIndex)
     {
+        RENDERCORE_PROFILE_THREAD("Render Worker");
+
         auto const &[CommandPool, CommandBuffer] = CommandResources.MultiThreadResources.at(ThreadIndex);
 
         if (CommandBuffer == VK_NULL_HANDLE)
@@ -364,7 +413,7 @@ std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageInd
         }
 
         CheckVulkanResult(vkBeginCommandBuffer(CommandBuffer, &SecondaryBeginInfo));
-        SetViewport(CommandBuffer, SwapchainAllocation.Extent);
+        SetViewport(CommandBuffer, RenderExtent);
 
         bool HasDraw = false;
 
@@ -372,13 +421,20 @@ std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageInd
         {
             std::uint32_t const ObjectAccessIndex = ThreadIndex * g_ObjectsPerThread + ObjectIndex;
 
-            if (ObjectAccessIndex >= Objects.size())
+            if (ObjectAccessIndex >= std::size(State.Objects))
             {
                 break;
             }
 
-            if (auto const &Object = Objects.at(ObjectAccessIndex);
-                Camera.CanDrawObject(Object))
+            ObjectFrameState const &ObjectState = State.Objects.at(ObjectAccessIndex);
+
+            // The capture consumed the dirty flag of culled objects too, so they're uploaded as well to be current once back in view
+            if (ObjectState.IsUniformDirty)
+            {
+                ObjectState.Owner->UpdateUniformBuffers(ObjectState.UniformData);
+            }
+
+            if (State.IsVisible(ObjectState))
             {
                 if (!HasDraw)
                 {
@@ -386,25 +442,31 @@ std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageInd
                     vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline);
                 }
 
-                Object->UpdateUniformBuffers();
-                Object->DrawObject(CommandBuffer, PipelineLayout, ObjectAccessIndex);
+                if (WriteVisibility)
+                {
+                    vkCmdPushConstants(CommandBuffer, PipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0U, sizeof(std::uint32_t), &ObjectAccessIndex);
+                }
+
+                ObjectState.Owner->DrawObject(CommandBuffer, PipelineLayout, ObjectAccessIndex, ObjectState.NumInstances);
             }
         }
 
         CheckVulkanResult(vkEndCommandBuffer(CommandBuffer));
     };
 
-    std::for_each(std::execution::unseq,
-                  std::cbegin(ThreadIndices),
-                  std::cend(ThreadIndices),
-                  [&](std::uint32_t const ThreadIndex)
-                  {
-                      g_ThreadPool.AddTask([ProcessCommandBuffer, ThreadIndex]
-                                           {
-                                               ProcessCommandBuffer(ThreadIndex);
-                                           },
-                                           ThreadIndex);
-                  });
+    // One job per batch: each batch owns its pool and secondary buffer, so it may run on any worker
+    JobGraph &FrameJobGraph = GetFrameJobGraph(ImageIndex);
+
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < g_NumThreads; ++ThreadIndex)
+    {
+        FrameJobGraph.AddJob("RecordSceneCommands Task",
+                             [&ProcessCommandBuffer, ThreadIndex]
+                             {
+                                 ProcessCommandBuffer(ThreadIndex);
+                             });
+    }
+
+    FrameJobGraph.Dispatch();
 
     std::for_each(std::execution::unseq,
                   std::cbegin(CommandResources.MultiThreadResources),
@@ -417,34 +479,220 @@ std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageInd
                       }
                   });
 
-    g_ThreadPool.Wait();
+    {
+        RENDERCORE_PROFILE_SCOPE("Wait Render Workers");
+        FrameJobGraph.Wait();
+    }
 
     return Output;
 }
 
-void RenderCore::RecordCommandBuffers(std::uint32_t const ImageIndex)
+void BuildFrameRenderGraph(RenderGraph &          Graph,
+                           std::uint32_t const    ImageIndex,
+                           SceneFrameState const &State,
+                           VkExtent2D const &     RenderExtent)
+{
+    bool const HasOffscreenRendering = Renderer::GetRenderOffscreen();
+    bool const HasDynamicResolution  = IsDynamicResolutionActive();
+
+    // Presentation only waits for the acquired image at the color output stage, so nothing may touch it before that
+    RenderGraphResource const Swapchain = Graph.ImportImage("Swapchain",
+                                                            GetSwapChainImages().at(ImageIndex),
+                                                            g_ImageAspect,
+                                                            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+    // Shared by every frame in flight: the depth writes of the previous frame must finish before the image is discarded again
+    RenderGraphResource const Depth = Graph.ImportImage("Depth",
+                                                        GetDepthImage(),
+                                                        g_DepthAspect,
+                                                        VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                                                        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+
+    Graph.ExportImage(Swapchain, RenderGraphAccess::Present);
+
+    RenderGraphResource Output = Swapchain;
+
+    if (HasOffscreenRendering)
+    {
+        Output = Graph.ImportImage("Offscreen",
+                                   GetOffscreenImages().at(ImageIndex),
+                                   g_ImageAspect,
+                                   VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+        Graph.ExportImage(Output, RenderGraphAccess::ShaderRead);
+    }
+
+    RenderGraphResource const SceneColor = HasDynamicResolution
+                                               ? Graph.ImportImage("Scaled Color",
+                                                                   GetScaledColorImage(),
+                                                                   g_ImageAspect,
+                                                                   VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT)
+                                               : Output;
+
+    // Rebuilt every frame, as the lists follow the camera; when it's off, they're binned on the host with the light upload
+    if (State.SceneData.ClusterGrid.w > 0U && IsLightCullingOnGPU())
+    {
+        Graph.AddPass("Light Culling",
+                      [](VkCommandBuffer const &CommandBuffer, RenderGraph const &)
+                      {
+                          RecordLightCulling(CommandBuffer);
+                      })
+             .SetHasSideEffects();
+    }
+
+    // Poses every skinned object before any pass reads the vertices, on the graphics queue like the light culling
+    if (IsSkinningActive())
+    {
+        Graph.AddPass("Skinning",
+                      [ImageIndex](VkCommandBuffer const &CommandBuffer, RenderGraph const &)
+                      {
+                          RecordSkinning(CommandBuffer, ImageIndex);
+                      })
+             .SetHasSideEffects();
+    }
+
+    auto const AddScenePass = [&Graph, ImageIndex, &State, Depth, RenderExtent](strzilla::string_view const Name,
+                                                                                RenderGraphResource const   Color,
+                                                                                bool const                  WriteVisibility)
+    {
+        Graph.AddPass(Name,
+                      [ImageIndex, &State, Color, Depth, RenderExtent, WriteVisibility](VkCommandBuffer const &CommandBuffer,
+                                                                                        RenderGraph const &    FrameGraph)
+                      {
+                          ImageAllocation const &ColorAllocation = FrameGraph.GetImage(Color);
+                          ImageAllocation const &DepthAllocation = FrameGraph.GetImage(Depth);
+
+                          BeginRendering(CommandBuffer, ColorAllocation, DepthAllocation, RenderExtent);
+
+                          if (std::pmr::vector<VkCommandBuffer> const CommandBuffers = RecordSceneCommands(ImageIndex,
+                                                                                                           State,
+                                                                                                           ColorAllocation,
+                                                                                                           DepthAllocation,
+                                                                                                           RenderExtent,
+                                                                                                           WriteVisibility);
+                              !std::empty(CommandBuffers))
+                          {
+                              vkCmdExecuteCommands(CommandBuffer, static_cast<std::uint32_t>(std::size(CommandBuffers)), std::data(CommandBuffers));
+                          }
+
+                          vkCmdEndRendering(CommandBuffer);
+                      })
+             .Write(Color, RenderGraphAccess::ColorAttachment)
+             .Write(Depth, RenderGraphAccess::DepthAttachment);
+    };
+
+    if (IsVisibilityBufferActive())
+    {
+        // Sized to the surface, so dynamic resolution doesn't create new images whenever the scale moves
+        VkExtent2D const SurfaceExtent = GetSwapChainImages().at(ImageIndex).Extent;
+
+        RenderGraphResource const Visibility = Graph.CreateTransientImage("Visibility",
+                                                                          TransientImageDescription {
+                                                                                  .Format = g_VisibilityFormat,
+                                                                                  .Extent = SurfaceExtent,
+                                                                                  .Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                                                           VK_IMAGE_USAGE_STORAGE_BIT
+                                                                          });
+
+        RenderGraphResource const VisibilityColor = Graph.CreateTransientImage("Visibility Color",
+                                                                               TransientImageDescription {
+                                                                                       .Format = g_VisibilityColorFormat,
+                                                                                       .Extent = SurfaceExtent,
+                                                                                       .Usage = VK_IMAGE_USAGE_STORAGE_BIT |
+                                                                                                VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                                                                               });
+
+        // Depth tested triangle ids only: each pixel is then shaded once, however many layers were drawn over it
+        AddScenePass("Visibility", Visibility, true);
+
+        Graph.AddPass("Visibility Resolve",
+                      [ImageIndex, Visibility, VisibilityColor, RenderExtent](VkCommandBuffer const &CommandBuffer, RenderGraph const &FrameGraph)
+                      {
+                          RecordVisibilityResolve(CommandBuffer,
+                                                  ImageIndex,
+                                                  FrameGraph.GetImage(Visibility),
+                                                  FrameGraph.GetImage(VisibilityColor),
+                                                  RenderExtent);
+                      })
+             .Read(Visibility, RenderGraphAccess::Storage)
+             .Write(VisibilityColor, RenderGraphAccess::Storage);
+
+        Graph.AddPass("Visibility Copy",
+                      [VisibilityColor, SceneColor, RenderExtent](VkCommandBuffer const &CommandBuffer, RenderGraph const &FrameGraph)
+                      {
+                          RecordVisibilityCopy(CommandBuffer, FrameGraph.GetImage(VisibilityColor), FrameGraph.GetImage(SceneColor), RenderExtent);
+                      })
+             .Read(VisibilityColor, RenderGraphAccess::TransferRead)
+             .Write(SceneColor, RenderGraphAccess::TransferWrite);
+    }
+    else
+    {
+        AddScenePass("Scene", SceneColor, false);
+    }
+
+    if (HasDynamicResolution)
+    {
+        Graph.AddPass("Upscale",
+                      [Output, RenderExtent](VkCommandBuffer const &CommandBuffer, RenderGraph const &FrameGraph)
+                      {
+                          RecordUpscale(CommandBuffer, RenderExtent, FrameGraph.GetImage(Output));
+                      })
+             .Read(SceneColor, RenderGraphAccess::TransferRead)
+             .Write(Output, RenderGraphAccess::TransferWrite);
+    }
+
+    if (g_OnCommandBufferRecordCallback)
+    {
+        RenderGraphPass &OverlayPass = Graph.AddPass("Overlay",
+                                                     [Swapchain](VkCommandBuffer const &CommandBuffer, RenderGraph const &FrameGraph)
+                                                     {
+                                                         g_OnCommandBufferRecordCallback(CommandBuffer, FrameGraph.GetImage(Swapchain));
+                                                     })
+                                            .Read(Swapchain, RenderGraphAccess::ColorAttachment)
+                                            .Write(Swapchain, RenderGraphAccess::ColorAttachment)
+                                            .SetHasSideEffects();
+
+        // The overlay may display the offscreen image
+        if (HasOffscreenRendering)
+        {
+            OverlayPass.Read(Output, RenderGraphAccess::ShaderRead);
+        }
+    }
+}
+
+void RenderCore::RecordCommandBuffers(std::uint32_t const ImageIndex, SceneFrameState const &State, JobHandle const Dependency)
 {
-    ImageAllocation const &SwapchainAllocation = GetSwapChainImages().at(ImageIndex);
-    ImageAllocation const &DepthAllocation     = GetDepthImage();
-    ImageAllocation const &OffscreenAllocation = GetOffscreenImages().at(ImageIndex);
+    RENDERCORE_PROFILE_FUNCTION();
 
     VkCommandBuffer const &CommandBuffer = g_CommandResources.at(ImageIndex).PrimaryCommandBuffer;
     CheckVulkanResult(vkBeginCommandBuffer(CommandBuffer, &g_CommandBufferBeginInfo));
 
-    BeginRendering(CommandBuffer, SwapchainAllocation, DepthAllocation, OffscreenAllocation);
+    UpdateDynamicResolution(ImageIndex);
+    BeginFrameTimestamp(CommandBuffer, ImageIndex);
 
-    if (std::vector<VkCommandBuffer> const CommandBuffers = RecordSceneCommands(ImageIndex, SwapchainAllocation, DepthAllocation);
-        !std::empty(CommandBuffers))
+    VkExtent2D const RenderExtent = GetRenderExtent(GetSwapChainImages().at(ImageIndex).Extent);
+
+    // The graph and its passes read the state, so the capture has to be over from here; the work above doesn't depend on it
+    if (Dependency != nullptr)
     {
-        vkCmdExecuteCommands(CommandBuffer, static_cast<std::uint32_t>(std::size(CommandBuffers)), std::data(CommandBuffers));
+        RENDERCORE_PROFILE_SCOPE("Wait Frame State");
+        GetFrameJobGraph(ImageIndex).Wait(Dependency);
     }
 
-    EndRendering(CommandBuffer, SwapchainAllocation, OffscreenAllocation);
+    RenderGraph &FrameRenderGraph = *g_FrameRenderGraphs.at(ImageIndex);
+    FrameRenderGraph.Reset();
+
+    BuildFrameRenderGraph(FrameRenderGraph, ImageIndex, State, RenderExtent);
+    FrameRenderGraph.Compile();
+    FrameRenderGraph.Execute(CommandBuffer);
+
+    EndFrameTimestamp(CommandBuffer, ImageIndex);
     CheckVulkanResult(vkEndCommandBuffer(CommandBuffer));
 }
 
 void RenderCore::SubmitCommandBuffers(std::uint32_t const ImageIndex)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     VkSemaphoreSubmitInfo const WaitSemaphoreInfo {
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
             .semaphore = GetImageAvailableSemaphore(ImageIndex),
@@ -456,7 +704,7 @@ void RenderCore::SubmitCommandBuffers(std::uint32_t const ImageIndex)
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
             .semaphore = GetRenderFinishedSemaphore(ImageIndex),
             .value = 1U,
-            .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+            .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
     };
 
     VkCommandBuffer const &         CommandBuffer = g_CommandResources.at(ImageIndex).PrimaryCommandBuffer;
@@ -515,6 +763,8 @@ void RenderCore::InitializeSingleCommandQueue(VkCommandPool &               Comm
 
 void RenderCore::FinishSingleCommandQueue(VkQueue const &Queue, VkCommandPool const &CommandPool, std::vector<VkCommandBuffer> const &CommandBuffers)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     if (std::empty(CommandBuffers) || CommandPool == VK_NULL_HANDLE)
     {
         return;
@@ -549,5 +799,5 @@ void RenderCore::FinishSingleCommandQueue(VkQueue const &Queue, VkCommandPool co
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
     vkFreeCommandBuffers(LogicalDevice, CommandPool, static_cast<std::uint32_t>(std::size(CommandBuffers)), std::data(CommandBuffers));
-    vkDestroyCommandPool(LogicalDevice, CommandPool, nullptr);
+    vkDestroyCommandPool(LogicalDevice, CommandPool, GetAllocationCallbacks(HostAllocationTag::Commands));
 }
@@ -12,46 +12,38 @@ import RenderCore.Runtime.Instance;
 import RenderCore.Utils.Helpers;
 import RenderCore.Utils.Constants;
 import RenderCore.Utils.DebugHelpers;
+import RenderCore.Utils.AllocationCallbacks;
+import RenderCore.Utils.Logger;
 
 using namespace RenderCore;
 
-bool IsPhysicalDeviceSuitable(VkPhysicalDevice const &Device)
-{
-    if (Device == VK_NULL_HANDLE)
-    {
-        return false;
-    }
-
-    VkPhysicalDeviceProperties SurfaceProperties;
-    vkGetPhysicalDeviceProperties(Device, &SurfaceProperties);
-
-    VkPhysicalDeviceFeatures SupportedFeatures;
-    vkGetPhysicalDeviceFeatures(Device, &SupportedFeatures);
+constexpr auto g_PhysicalDeviceOverrideVariable = "RENDERCORE_PHYSICAL_DEVICE";
 
-    return SurfaceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU && SupportedFeatures.samplerAnisotropy != 0U;
-}
-
-bool GetQueueFamilyIndices(VkSurfaceKHR const &         VulkanSurface,
+bool GetQueueFamilyIndices(VkPhysicalDevice const &     Device,
+                           VkSurfaceKHR const &         VulkanSurface,
                            std::optional<std::uint8_t> &GraphicsQueueFamilyIndex,
                            std::optional<std::uint8_t> &PresentationQueueFamilyIndex,
                            std::optional<std::uint8_t> &ComputeQueueFamilyIndex)
 {
     std::uint32_t QueueFamilyCount = 0U;
-    vkGetPhysicalDeviceQueueFamilyProperties(g_PhysicalDevice, &QueueFamilyCount, nullptr);
+    vkGetPhysicalDeviceQueueFamilyProperties(Device, &QueueFamilyCount, nullptr);
 
     std::vector<VkQueueFamilyProperties> QueueFamilies(QueueFamilyCount);
-    vkGetPhysicalDeviceQueueFamilyProperties(g_PhysicalDevice, &QueueFamilyCount, std::data(QueueFamilies));
+    vkGetPhysicalDeviceQueueFamilyProperties(Device, &QueueFamilyCount, std::data(QueueFamilies));
 
     for (std::uint32_t Iterator = 0U; Iterator < QueueFamilyCount; ++Iterator)
     {
-        if (!GraphicsQueueFamilyIndex.has_value() && (QueueFamilies.at(Iterator).queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0U)
-        {
-            GraphicsQueueFamilyIndex.emplace(static_cast<std::uint8_t>(Iterator));
+        VkQueueFlags const QueueFlags = QueueFamilies.at(Iterator).queueFlags;
+
+        VkBool32 PresentationSupport = 0U;
+        CheckVulkanResult(vkGetPhysicalDeviceSurfaceSupportKHR(Device, Iterator, VulkanSurface, &PresentationSupport));
 
-            if (!PresentationQueueFamilyIndex.has_value())
+        if ((QueueFlags & VK_QUEUE_GRAPHICS_BIT) != 0U)
+        {
+            // The renderer presents from the graphics queue, so prefer a family that supports both
+            if (!GraphicsQueueFamilyIndex.has_value() || (PresentationSupport != 0U && PresentationQueueFamilyIndex != GraphicsQueueFamilyIndex))
             {
-                VkBool32 PresentationSupport = 0U;
-                CheckVulkanResult(vkGetPhysicalDeviceSurfaceSupportKHR(g_PhysicalDevice, Iterator, VulkanSurface, &PresentationSupport));
+                GraphicsQueueFamilyIndex.emplace(static_cast<std::uint8_t>(Iterator));
 
                 if (PresentationSupport != 0U)
                 {
@@ -59,32 +51,299 @@ bool GetQueueFamilyIndices(VkSurfaceKHR const &         VulkanSurface,
                 }
             }
         }
-        else if (!ComputeQueueFamilyIndex.has_value() && (QueueFamilies.at(Iterator).queueFlags & VK_QUEUE_COMPUTE_BIT) != 0U)
+        else if (!ComputeQueueFamilyIndex.has_value() && (QueueFlags & VK_QUEUE_COMPUTE_BIT) != 0U)
         {
             ComputeQueueFamilyIndex.emplace(static_cast<std::uint8_t>(Iterator));
         }
 
-        if (GraphicsQueueFamilyIndex.has_value() && PresentationQueueFamilyIndex.has_value() && ComputeQueueFamilyIndex.has_value())
+        if (!PresentationQueueFamilyIndex.has_value() && PresentationSupport != 0U)
         {
-            break;
+            PresentationQueueFamilyIndex.emplace(static_cast<std::uint8_t>(Iterator));
         }
     }
 
+    if (!ComputeQueueFamilyIndex.has_value() && GraphicsQueueFamilyIndex.has_value())
+    {
+        ComputeQueueFamilyIndex = GraphicsQueueFamilyIndex;
+    }
+
     return GraphicsQueueFamilyIndex.has_value() && PresentationQueueFamilyIndex.has_value() && ComputeQueueFamilyIndex.has_value();
 }
 
-void PickPhysicalDevice()
+bool HasRequiredExtensions(VkPhysicalDevice const &Device)
 {
+    std::uint32_t ExtensionsCount = 0U;
+    CheckVulkanResult(vkEnumerateDeviceExtensionProperties(Device, nullptr, &ExtensionsCount, nullptr));
+
+    std::vector<VkExtensionProperties> AvailableExtensions(ExtensionsCount);
+    CheckVulkanResult(vkEnumerateDeviceExtensionProperties(Device, nullptr, &ExtensionsCount, std::data(AvailableExtensions)));
+
+    return std::ranges::all_of(g_RequiredDeviceExtensions,
+                               [&AvailableExtensions](strzilla::string_view const Required)
+                               {
+                                   return std::ranges::any_of(AvailableExtensions,
+                                                              [Required](VkExtensionProperties const &Extension)
+                                                              {
+                                                                  return strzilla::string_view { Extension.extensionName } == Required;
+                                                              });
+                               });
+}
+
+bool HasRequiredFeatures(VkPhysicalDevice const &Device)
+{
+    VkPhysicalDeviceMeshShaderFeaturesEXT MeshShaderFeatures {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT
+    };
+
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT PipelineLibraryFeatures {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+            .pNext = &MeshShaderFeatures
+    };
+
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT DescriptorBufferFeatures {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+            .pNext = &PipelineLibraryFeatures
+    };
+
+    VkPhysicalDeviceVulkan12Features Vulkan12Features {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+            .pNext = &DescriptorBufferFeatures
+    };
+
+    VkPhysicalDeviceVulkan13Features Vulkan13Features {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+            .pNext = &Vulkan12Features
+    };
+
+    VkPhysicalDeviceFeatures2 DeviceFeatures {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &Vulkan13Features
+    };
+
+    vkGetPhysicalDeviceFeatures2(Device, &DeviceFeatures);
+
+    return DeviceFeatures.features.samplerAnisotropy != 0U && Vulkan13Features.dynamicRendering != 0U && Vulkan13Features.synchronization2 != 0U &&
+           Vulkan12Features.bufferDeviceAddress != 0U && DescriptorBufferFeatures.descriptorBuffer != 0U && PipelineLibraryFeatures.graphicsPipelineLibrary
+           != 0U && MeshShaderFeatures.taskShader != 0U && MeshShaderFeatures.meshShader != 0U;
+}
+
+std::uint64_t GetPhysicalDeviceTypeWeight(VkPhysicalDeviceType const Type)
+{
+    switch (Type)
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: return 4U;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 3U;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: return 2U;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU: return 1U;
+        default: return 0U;
+    }
+}
+
+PhysicalDeviceCandidate EvaluatePhysicalDevice(VkPhysicalDevice const &Device, std::uint32_t const Index, VkSurfaceKHR const &VulkanSurface)
+{
+    VkPhysicalDeviceIDProperties DeviceIDProperties { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES };
+    VkPhysicalDeviceProperties2  DeviceProperties { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &DeviceIDProperties };
+    vkGetPhysicalDeviceProperties2(Device, &DeviceProperties);
+
+    VkPhysicalDeviceMemoryProperties MemoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(Device, &MemoryProperties);
+
+    PhysicalDeviceCandidate Output {
+            .Device = Device,
+            .Index = Index,
+            .Name = DeviceProperties.properties.deviceName,
+            .Type = DeviceProperties.properties.deviceType
+    };
+
+    std::copy_n(std::begin(DeviceIDProperties.deviceUUID), VK_UUID_SIZE, std::begin(Output.UUID));
+
+    for (std::uint32_t HeapIndex = 0U; HeapIndex < MemoryProperties.memoryHeapCount; ++HeapIndex)
+    {
+        if (VkMemoryHeap const &Heap = MemoryProperties.memoryHeaps[HeapIndex];
+            (Heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0U)
+        {
+            Output.DeviceLocalMemory = std::max(Output.DeviceLocalMemory, Heap.size);
+        }
+    }
+
+    VkPhysicalDeviceVulkan12Features Vulkan12Features { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+    VkPhysicalDeviceFeatures2        Features { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &Vulkan12Features };
+    vkGetPhysicalDeviceFeatures2(Device, &Features);
+
+    // The resolve indexes the material maps of every object from a single array
+    VkPhysicalDeviceLimits const &Limits               = DeviceProperties.properties.limits;
+    bool const                    HasMaterialMapsArray = Vulkan12Features.runtimeDescriptorArray != 0U &&
+                                                         Vulkan12Features.shaderSampledImageArrayNonUniformIndexing != 0U &&
+                                                         Vulkan12Features.descriptorBindingVariableDescriptorCount != 0U &&
+                                                         std::min({ Limits.maxPerStageDescriptorSamplers,
+                                                                    Limits.maxPerStageDescriptorSampledImages,
+                                                                    Limits.maxDescriptorSetSamplers,
+                                                                    Limits.maxDescriptorSetSampledImages }) >= g_MaxVisibilityMaterialMaps;
+
+    Output.SupportsVisibilityBuffer = Features.features.geometryShader != 0U && Features.features.shaderStorageImageExtendedFormats != 0U &&
+                                      HasMaterialMapsArray;
+
+    std::optional<std::uint8_t> GraphicsQueueFamilyIndex { std::nullopt };
+    std::optional<std::uint8_t> PresentationQueueFamilyIndex { std::nullopt };
+    std::optional<std::uint8_t> ComputeQueueFamilyIndex { std::nullopt };
+
+    bool const HasQueues = GetQueueFamilyIndices(Device, VulkanSurface, GraphicsQueueFamilyIndex, PresentationQueueFamilyIndex, ComputeQueueFamilyIndex);
+
+    Output.IsSuitable = DeviceProperties.properties.apiVersion >= VK_API_VERSION_1_3 && HasQueues && GraphicsQueueFamilyIndex ==
+                        PresentationQueueFamilyIndex && HasRequiredExtensions(Device) && HasRequiredFeatures(Device);
+
+    if (!Output.IsSuitable)
+    {
+        return Output;
+    }
+
+    // Device type dominates, then the size of the largest device local heap (MiB), the optional features and at last the queue layout
+    constexpr std::uint64_t TypeWeightFactor { 1'000'000'000U };
+    constexpr std::uint64_t MemoryWeightFactor { 1'000U };
+
+    std::uint64_t const FeatureScore     = Output.SupportsVisibilityBuffer ? 2U : 0U;
+    std::uint64_t const QueueLayoutScore = ComputeQueueFamilyIndex != GraphicsQueueFamilyIndex ? 1U : 0U;
+
+    Output.Score = GetPhysicalDeviceTypeWeight(Output.Type) * TypeWeightFactor + Output.DeviceLocalMemory / (1024U * 1024U) * MemoryWeightFactor +
+                   FeatureScore + QueueLayoutScore;
+
+    return Output;
+}
+
+std::vector<PhysicalDeviceCandidate> EvaluatePhysicalDevices(VkSurfaceKHR const &VulkanSurface)
+{
+    std::vector<PhysicalDeviceCandidate> Output;
+
+    std::uint32_t Index = 0U;
     for (VkPhysicalDevice const &Device : GetAvailablePhysicalDevices())
     {
-        if (IsPhysicalDeviceSuitable(Device))
+        Output.push_back(EvaluatePhysicalDevice(Device, Index++, VulkanSurface));
+    }
+
+    std::ranges::stable_sort(Output,
+                             [](PhysicalDeviceCandidate const &Lhs, PhysicalDeviceCandidate const &Rhs)
+                             {
+                                 return Lhs.IsSuitable != Rhs.IsSuitable ? Lhs.IsSuitable : Lhs.Score > Rhs.Score;
+                             });
+
+    return Output;
+}
+
+strzilla::string GetPhysicalDeviceOverride()
+{
+    if (!std::empty(g_PhysicalDeviceOverride))
+    {
+        return g_PhysicalDeviceOverride;
+    }
+
+    if (char const *const Value = std::getenv(g_PhysicalDeviceOverrideVariable);
+        Value != nullptr)
+    {
+        return Value;
+    }
+
+    return {};
+}
+
+std::string ToLowerCase(strzilla::string_view const Value)
+{
+    std::string Output(std::data(Value), std::size(Value));
+
+    std::ranges::transform(Output,
+                           std::begin(Output),
+                           [](char const Character)
+                           {
+                               return static_cast<char>(std::tolower(static_cast<unsigned char>(Character)));
+                           });
+
+    return Output;
+}
+
+bool MatchesPhysicalDeviceOverride(PhysicalDeviceCandidate const &Candidate, strzilla::string_view const Override)
+{
+    if (std::ranges::all_of(Override,
+                            [](char const Character)
+                            {
+                                return Character >= '0' && Character <= '9';
+                            }))
+    {
+        std::uint32_t Index = 0U;
+        auto const [_, Error] = std::from_chars(std::data(Override), std::data(Override) + std::size(Override), Index);
+        return Error == std::errc {} && Candidate.Index == Index;
+    }
+
+    std::string OverrideUUID = ToLowerCase(Override);
+    std::erase(OverrideUUID, '-');
+
+    if (std::size(OverrideUUID) == VK_UUID_SIZE * 2U)
+    {
+        std::string CandidateUUID;
+        for (std::uint8_t const Byte : Candidate.UUID)
         {
-            g_PhysicalDevice = Device;
-            break;
+            CandidateUUID += std::format("{:02x}", Byte);
+        }
+
+        if (CandidateUUID == OverrideUUID)
+        {
+            return true;
         }
     }
 
+    return ToLowerCase(Candidate.Name).find(ToLowerCase(Override)) != std::string::npos;
+}
+
+void PickPhysicalDevice(VkSurfaceKHR const &VulkanSurface)
+{
+    std::vector<PhysicalDeviceCandidate> const Candidates = EvaluatePhysicalDevices(VulkanSurface);
+
+    for (PhysicalDeviceCandidate const &Candidate : Candidates)
+    {
+        RENDERCORE_LOG(info,
+                       "Physical device {} '{}': {} (score {})",
+                       Candidate.Index,
+                       std::data(Candidate.Name),
+                       Candidate.IsSuitable ? "suitable" : "unsuitable",
+                       Candidate.Score);
+    }
+
+    if (std::empty(Candidates) || !Candidates.front().IsSuitable)
+    {
+        EmitFatalError("No suitable physical device found");
+        return;
+    }
+
+    g_SelectedPhysicalDevice = Candidates.front();
+
+    if (strzilla::string const Override = GetPhysicalDeviceOverride();
+        !std::empty(Override))
+    {
+        if (auto const Match = std::ranges::find_if(Candidates,
+                                                    [&Override](PhysicalDeviceCandidate const &Candidate)
+                                                    {
+                                                        return MatchesPhysicalDeviceOverride(Candidate, Override);
+                                                    });
+            Match == std::cend(Candidates))
+        {
+            RENDERCORE_LOG(warning,
+                           "No physical device matches '{}', using the highest score",
+                           std::data(Override));
+        }
+        else if (!Match->IsSuitable)
+        {
+            RENDERCORE_LOG(warning,
+                           "Physical device '{}' is not suitable, using the highest score",
+                           std::data(Match->Name));
+        }
+        else
+        {
+            g_SelectedPhysicalDevice = *Match;
+        }
+    }
+
+    g_PhysicalDevice = g_SelectedPhysicalDevice.Device;
     vkGetPhysicalDeviceProperties(g_PhysicalDevice, &g_PhysicalDeviceProperties);
+
+    RENDERCORE_LOG(info, "Selected physical device: {}", std::data(g_SelectedPhysicalDevice.Name));
 }
 
 void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
@@ -93,7 +352,8 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
     std::optional<std::uint8_t> ComputeQueueFamilyIndex { std::nullopt };
     std::optional<std::uint8_t> PresentationQueueFamilyIndex { std::nullopt };
 
-    GetQueueFamilyIndices(VulkanSurface, GraphicsQueueFamilyIndex, PresentationQueueFamilyIndex, ComputeQueueFamilyIndex);
+    GetQueueFamilyIndices(g_PhysicalDevice, VulkanSurface, GraphicsQueueFamilyIndex, PresentationQueueFamilyIndex, ComputeQueueFamilyIndex);
+    g_GraphicsQueue.first = GraphicsQueueFamilyIndex.value_or(0U);
 
     std::vector Layers(std::cbegin(g_RequiredDeviceLayers), std::cend(g_RequiredDeviceLayers));
     std::vector Extensions(std::cbegin(g_RequiredDeviceExtensions), std::cend(g_RequiredDeviceExtensions));
@@ -130,10 +390,21 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
                                   });
     }
 
+    VkBool32 const HasVisibilityFeatures = IsVisibilityBufferSupported() ? VK_TRUE : VK_FALSE;
+
+    VkPhysicalDeviceDescriptorIndexingFeatures DescriptorIndexingFeatures {
+            // Optional
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+            .pNext = nullptr,
+            .shaderSampledImageArrayNonUniformIndexing = HasVisibilityFeatures,
+            .descriptorBindingVariableDescriptorCount = HasVisibilityFeatures,
+            .runtimeDescriptorArray = HasVisibilityFeatures
+    };
+
     VkPhysicalDeviceMeshShaderFeaturesEXT MeshShaderFeatures {
             // Required
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
-            .pNext = nullptr,
+            .pNext = &DescriptorIndexingFeatures,
             .taskShader = VK_TRUE,
             .meshShader = VK_TRUE
     };
@@ -178,6 +449,7 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
             .pNext = &DynamicRenderingFeatures,
             .features = VkPhysicalDeviceFeatures {
                     .independentBlend = VK_TRUE,
+                    .geometryShader = HasVisibilityFeatures,
                     .drawIndirectFirstInstance = true,
                     .fillModeNonSolid = true,
                     .wideLines = true,
@@ -186,6 +458,7 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
                     .vertexPipelineStoresAndAtomics = true,
                     .fragmentStoresAndAtomics = true,
                     .shaderImageGatherExtended = true,
+                    .shaderStorageImageExtendedFormats = HasVisibilityFeatures,
                     .shaderInt16 = false
             }
     };
@@ -201,7 +474,7 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
             .ppEnabledExtensionNames = std::data(Extensions)
     };
 
-    CheckVulkanResult(vkCreateDevice(g_PhysicalDevice, &DeviceCreateInfo, nullptr, &g_Device));
+    CheckVulkanResult(vkCreateDevice(g_PhysicalDevice, &DeviceCreateInfo, GetAllocationCallbacks(HostAllocationTag::Device), &g_Device));
     volkLoadDevice(g_Device);
 
     vkGetDeviceQueue(g_Device, g_GraphicsQueue.first, 0U, &g_GraphicsQueue.second);
@@ -214,7 +487,7 @@ void RenderCore::InitializeDevice(VkSurfaceKHR const &VulkanSurface)
         return;
     }
 
-    PickPhysicalDevice();
+    PickPhysicalDevice(VulkanSurface);
     CreateLogicalDevice(VulkanSurface);
 }
 
@@ -242,11 +515,17 @@ std::vector<std::uint32_t> RenderCore::GetUniqueQueueFamilyIndicesU32()
 
 void RenderCore::ReleaseDeviceResources()
 {
-    vkDestroyDevice(g_Device, nullptr);
+    vkDestroyDevice(g_Device, GetAllocationCallbacks(HostAllocationTag::Device));
     g_Device = VK_NULL_HANDLE;
 
-    g_PhysicalDevice       = VK_NULL_HANDLE;
-    g_GraphicsQueue.second = VK_NULL_HANDLE;
+    g_PhysicalDevice         = VK_NULL_HANDLE;
+    g_SelectedPhysicalDevice = {};
+    g_GraphicsQueue.second   = VK_NULL_HANDLE;
+}
+
+std::vector<PhysicalDeviceCandidate> RenderCore::GetPhysicalDeviceCandidates()
+{
+    return EvaluatePhysicalDevices(GetSurface());
 }
 
 std::vector<VkPhysicalDevice> RenderCore::GetAvailablePhysicalDevices()
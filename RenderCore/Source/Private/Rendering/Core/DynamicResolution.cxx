@@ -0,0 +1,216 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.DynamicResolution;
+
+import RenderCore.Runtime.Device;
+import RenderCore.Runtime.Memory;
+import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.AllocationCallbacks;
+import RenderCore.Utils.Logger;
+
+#if RENDERCORE_ENABLE_PROFILER
+std::array<std::int64_t, g_ImageCount> g_FrameRecordEndTimes {};
+#endif
+
+using namespace RenderCore;
+
+void RenderCore::CreateTimestampQueryPool()
+{
+    VkPhysicalDevice const &PhysicalDevice = GetPhysicalDevice();
+
+    std::uint32_t QueueFamilyCount = 0U;
+    vkGetPhysicalDeviceQueueFamilyProperties(PhysicalDevice, &QueueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> QueueFamilies(QueueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(PhysicalDevice, &QueueFamilyCount, std::data(QueueFamilies));
+
+    std::uint32_t const ValidBits = QueueFamilies.at(GetGraphicsQueue().first).timestampValidBits;
+
+    if (ValidBits == 0U || GetPhysicalDeviceProperties().limits.timestampPeriod <= 0.F)
+    {
+        RENDERCORE_LOG(warning, "Graphics queue does not support timestamps, dynamic resolution will remain disabled");
+        return;
+    }
+
+    g_TimestampMask = ValidBits >= 64U ? std::numeric_limits<std::uint64_t>::max() : (1ULL << ValidBits) - 1ULL;
+
+    VkQueryPoolCreateInfo const QueryPoolCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = g_ImageCount * 2U
+    };
+
+    CheckVulkanResult(vkCreateQueryPool(GetLogicalDevice(), &QueryPoolCreateInfo, GetAllocationCallbacks(HostAllocationTag::Device), &g_TimestampQueryPool));
+}
+
+void RenderCore::ReleaseTimestampQueryPool()
+{
+    DestroyScaledColorImage();
+
+    if (g_TimestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(GetLogicalDevice(), g_TimestampQueryPool, GetAllocationCallbacks(HostAllocationTag::Device));
+        g_TimestampQueryPool = VK_NULL_HANDLE;
+    }
+
+    g_PendingTimestamps.fill(false);
+}
+
+void RenderCore::CreateScaledColorImage(SurfaceProperties const &SurfaceProperties)
+{
+    DestroyScaledColorImage();
+
+    if (!g_DynamicResolutionSettings.Enabled || g_TimestampQueryPool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    // Drawn into by the forward path, or written by the copy of the visibility buffer resolve
+    constexpr VkImageUsageFlags UsageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    g_ScaledColorImage.Extent = SurfaceProperties.Extent;
+    g_ScaledColorImage.Format = SurfaceProperties.Format.format;
+
+    CreateImage(g_ScaledColorImage.Format,
+                g_ScaledColorImage.Extent,
+                g_ImageTiling,
+                UsageFlags,
+                g_TextureMemoryUsage,
+                "SCALED_COLOR_IMAGE",
+                g_ScaledColorImage.Image,
+                g_ScaledColorImage.Allocation);
+
+    CreateImageView(g_ScaledColorImage.Image, g_ScaledColorImage.Format, g_ImageAspect, g_ScaledColorImage.View);
+}
+
+void RenderCore::DestroyScaledColorImage()
+{
+    if (g_ScaledColorImage.IsValid())
+    {
+        g_ScaledColorImage.DestroyResources(GetAllocator());
+    }
+}
+
+void RenderCore::UpdateDynamicResolution(std::uint32_t const ImageIndex)
+{
+    if (g_TimestampQueryPool == VK_NULL_HANDLE || !g_PendingTimestamps.at(ImageIndex))
+    {
+        return;
+    }
+
+    std::array<std::uint64_t, 4U> Results {};
+
+    if (vkGetQueryPoolResults(GetLogicalDevice(),
+                              g_TimestampQueryPool,
+                              ImageIndex * 2U,
+                              2U,
+                              sizeof(Results),
+                              std::data(Results),
+                              2U * sizeof(std::uint64_t),
+                              VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) != VK_SUCCESS || Results.at(1U) == 0U || Results.at(3U) == 0U)
+    {
+        return;
+    }
+
+    g_PendingTimestamps.at(ImageIndex) = false;
+
+    std::uint64_t const Ticks        = (Results.at(2U) - Results.at(0U)) & g_TimestampMask;
+    float const         MeasuredTime = static_cast<float>(Ticks) * GetPhysicalDeviceProperties().limits.timestampPeriod / 1000000.F;
+
+    #if RENDERCORE_ENABLE_PROFILER
+    double const       TimestampPeriod = GetPhysicalDeviceProperties().limits.timestampPeriod;
+    std::int64_t const GPUBegin        = static_cast<std::int64_t>(static_cast<double>(Results.at(0U) & g_TimestampMask) * TimestampPeriod);
+    std::int64_t const GPUEnd          = GPUBegin + static_cast<std::int64_t>(static_cast<double>(Ticks) * TimestampPeriod);
+
+    RecordGPUProfilerZone("GPU Frame", GPUBegin, GPUEnd, g_FrameRecordEndTimes.at(ImageIndex));
+    #endif
+
+    constexpr float SmoothingFactor { 0.2F };
+    g_GPUFrameTime = g_GPUFrameTime <= 0.F ? MeasuredTime : std::lerp(g_GPUFrameTime, MeasuredTime, SmoothingFactor);
+
+    if (!g_DynamicResolutionSettings.Enabled || g_GPUFrameTime <= 0.F)
+    {
+        return;
+    }
+
+    // GPU cost scales with the pixel count, so the linear scale follows the square root of the time ratio
+    if (float const Ratio = g_DynamicResolutionSettings.TargetGPUTime / g_GPUFrameTime;
+        std::abs(1.F - Ratio) > g_DynamicResolutionSettings.Tolerance)
+    {
+        float const DesiredScale = g_ResolutionScale * std::sqrt(Ratio);
+        g_ResolutionScale += (DesiredScale - g_ResolutionScale) * g_DynamicResolutionSettings.AdjustmentRate;
+    }
+
+    float const MaxScale = std::clamp(g_DynamicResolutionSettings.MaxScale, 0.1F, 1.F);
+    g_ResolutionScale    = std::clamp(g_ResolutionScale, std::clamp(g_DynamicResolutionSettings.MinScale, 0.1F, MaxScale), MaxScale);
+}
+
+void RenderCore::BeginFrameTimestamp(VkCommandBuffer const &CommandBuffer, std::uint32_t const ImageIndex)
+{
+    if (g_TimestampQueryPool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    vkCmdResetQueryPool(CommandBuffer, g_TimestampQueryPool, ImageIndex * 2U, 2U);
+    vkCmdWriteTimestamp2(CommandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, g_TimestampQueryPool, ImageIndex * 2U);
+}
+
+void RenderCore::EndFrameTimestamp(VkCommandBuffer const &CommandBuffer, std::uint32_t const ImageIndex)
+{
+    if (g_TimestampQueryPool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    vkCmdWriteTimestamp2(CommandBuffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, g_TimestampQueryPool, ImageIndex * 2U + 1U);
+    g_PendingTimestamps.at(ImageIndex) = true;
+
+    #if RENDERCORE_ENABLE_PROFILER
+    g_FrameRecordEndTimes.at(ImageIndex) = GetProfilerTimestamp();
+    #endif
+}
+
+void RenderCore::RecordUpscale(VkCommandBuffer const &CommandBuffer, VkExtent2D const &RenderExtent, ImageAllocation const &Target)
+{
+    VkImageBlit2 const BlitRegion {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2,
+            .srcSubresource = { .aspectMask = g_ImageAspect, .mipLevel = 0U, .baseArrayLayer = 0U, .layerCount = 1U },
+            .srcOffsets = { VkOffset3D { 0, 0, 0 },
+                            VkOffset3D { static_cast<std::int32_t>(RenderExtent.width), static_cast<std::int32_t>(RenderExtent.height), 1 } },
+            .dstSubresource = { .aspectMask = g_ImageAspect, .mipLevel = 0U, .baseArrayLayer = 0U, .layerCount = 1U },
+            .dstOffsets = { VkOffset3D { 0, 0, 0 },
+                            VkOffset3D { static_cast<std::int32_t>(Target.Extent.width), static_cast<std::int32_t>(Target.Extent.height), 1 } }
+    };
+
+    VkBlitImageInfo2 const BlitInfo {
+            .sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2,
+            .srcImage = g_ScaledColorImage.Image,
+            .srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .dstImage = Target.Image,
+            .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .regionCount = 1U,
+            .pRegions = &BlitRegion,
+            .filter = VK_FILTER_LINEAR
+    };
+
+    vkCmdBlitImage2(CommandBuffer, &BlitInfo);
+}
+
+VkExtent2D RenderCore::GetRenderExtent(VkExtent2D const &FullExtent)
+{
+    if (!IsDynamicResolutionActive())
+    {
+        return FullExtent;
+    }
+
+    return VkExtent2D {
+            .width = std::max(1U, static_cast<std::uint32_t>(static_cast<float>(FullExtent.width) * g_ResolutionScale)),
+            .height = std::max(1U, static_cast<std::uint32_t>(static_cast<float>(FullExtent.height) * g_ResolutionScale))
+    };
+}
@@ -0,0 +1,210 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.FrameState;
+
+import RenderCore.Runtime.ClusteredLighting;
+import RenderCore.Runtime.Scene;
+import RenderCore.Runtime.Skinning;
+import RenderCore.Types.Camera;
+import RenderCore.Types.Illumination;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Skeleton;
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+bool SceneFrameState::IsVisible(ObjectFrameState const &ObjectState) const
+{
+    if (!ObjectState.CanDraw || length(ObjectState.MeshCenter - CameraPosition) > DrawDistance)
+    {
+        return false;
+    }
+
+    return std::ranges::all_of(FrustumPlanes,
+                               [&ObjectState](glm::vec4 const &PlaneIt)
+                               {
+                                   return Camera::BoxIntersectsPlane(ObjectState.MeshBounds, PlaneIt);
+                               });
+}
+
+void FrameStateQueue::Open()
+{
+    std::lock_guard const Lock { m_Mutex };
+
+    m_WriteIndex = 0U;
+    m_ReadIndex  = 0U;
+    m_NumQueued  = 0U;
+    m_IsOpen     = true;
+}
+
+void FrameStateQueue::Close()
+{
+    {
+        std::lock_guard const Lock { m_Mutex };
+        m_IsOpen = false;
+    }
+
+    m_Condition.notify_all();
+}
+
+// Only once both sides are gone: the states hold the objects they were captured from
+void FrameStateQueue::Reset()
+{
+    std::lock_guard const Lock { m_Mutex };
+
+    for (SceneFrameState &StateIt : m_States)
+    {
+        StateIt.Objects.clear();
+    }
+}
+
+SceneFrameState *FrameStateQueue::BeginWrite()
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    std::unique_lock Lock { m_Mutex };
+
+    m_Condition.wait(Lock,
+                     [this]
+                     {
+                         return !m_IsOpen || m_NumQueued < g_NumFrameStates;
+                     });
+
+    return m_IsOpen ? &m_States.at(m_WriteIndex) : nullptr;
+}
+
+void FrameStateQueue::EndWrite()
+{
+    {
+        std::lock_guard const Lock { m_Mutex };
+
+        m_WriteIndex = (m_WriteIndex + 1U) % g_NumFrameStates;
+        ++m_NumQueued;
+    }
+
+    m_Condition.notify_all();
+}
+
+SceneFrameState const *FrameStateQueue::BeginRead()
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    std::unique_lock Lock { m_Mutex };
+
+    m_Condition.wait(Lock,
+                     [this]
+                     {
+                         return !m_IsOpen || m_NumQueued > 0U;
+                     });
+
+    return m_IsOpen ? &m_States.at(m_ReadIndex) : nullptr;
+}
+
+// The state stays queued while it's being read, so the producer can't write over it
+void FrameStateQueue::EndRead()
+{
+    {
+        std::lock_guard const Lock { m_Mutex };
+
+        m_ReadIndex = (m_ReadIndex + 1U) % g_NumFrameStates;
+        --m_NumQueued;
+    }
+
+    m_Condition.notify_all();
+}
+
+void FrameStateQueue::WaitUntilEmpty()
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    std::unique_lock Lock { m_Mutex };
+
+    m_Condition.wait(Lock,
+                     [this]
+                     {
+                         return !m_IsOpen || m_NumQueued == 0U;
+                     });
+}
+
+// Must run on the thread that mutates the scene, after the tick: the objects' dirty flags are consumed here
+void RenderCore::CaptureFrameState(SceneFrameState &State, float const DeltaTime)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    Camera const &      Camera       = GetCamera();
+    Illumination const &Illumination = GetIllumination();
+
+    glm::mat4 const View           = Camera.GetViewMatrix();
+    glm::mat4 const Projection     = Camera.GetProjectionMatrix();
+    glm::mat4 const ProjectionView = Projection * View;
+
+    ++State.FrameNumber;
+    State.DeltaTime    = DeltaTime;
+    State.IsSceneDirty = Camera.IsRenderDirty() || Illumination.IsRenderDirty();
+    State.SceneData    = SceneUniformData {
+            .ProjectionView = ProjectionView,
+            .LightPosition = Illumination.GetPosition(),
+            .LightColor = Illumination.GetColor() * Illumination.GetIntensity(),
+            .AmbientLight = Illumination.GetAmbient()
+    };
+
+    State.PointLights = Illumination.GetPointLights();
+    FillClusterUniformData(State.SceneData, View, Projection, Camera.GetNearPlane(), Camera.GetFarPlane(), std::size(State.PointLights));
+
+    State.CameraPosition = Camera.GetPosition();
+    State.DrawDistance   = Camera.GetDrawDistance();
+    Camera::CalculateFrustumPlanes(ProjectionView, State.FrustumPlanes);
+
+    CaptureJointMatrices(State.JointMatrices);
+
+    auto const &Objects = GetObjects();
+    State.Objects.resize(std::size(Objects));
+
+    for (std::size_t ObjectIndex = 0U; ObjectIndex < std::size(Objects); ++ObjectIndex)
+    {
+        std::shared_ptr<Object> const &Object      = Objects.at(ObjectIndex);
+        ObjectFrameState &             ObjectState = State.Objects.at(ObjectIndex);
+        std::shared_ptr<Mesh> const &  Mesh        = Object->GetMesh();
+
+        ObjectState.Owner          = Object;
+        ObjectState.CanDraw        = Mesh && !Object->IsPendingDestroy();
+        ObjectState.NumInstances   = std::max(Object->GetNumInstances(), 1U);
+        ObjectState.IsUniformDirty = ObjectState.CanDraw && Object->IsRenderDirty();
+
+        if (!ObjectState.CanDraw)
+        {
+            continue;
+        }
+
+        ObjectState.MeshBounds = Mesh->GetBounds();
+        ObjectState.MeshCenter = Mesh->GetCenter();
+
+        // The next animation evaluation skips the skeletons that move no object in view
+        if (Object->IsSkinned() && State.IsVisible(ObjectState))
+        {
+            Object->GetSkeleton()->MarkAsVisible();
+        }
+
+        if (ObjectState.IsUniformDirty)
+        {
+            ObjectState.UniformData = Object->GetUniformData(Object->GetTransform());
+            Object->SetRenderDirty(false);
+        }
+    }
+}
+
+// A state that is dropped without being recorded gives its pending uniform updates back to the objects
+void RenderCore::RestoreFrameStateDirtiness(SceneFrameState const &State)
+{
+    for (ObjectFrameState const &ObjectStateIt : State.Objects)
+    {
+        if (ObjectStateIt.IsUniformDirty)
+        {
+            ObjectStateIt.Owner->MarkAsRenderDirty();
+        }
+    }
+}
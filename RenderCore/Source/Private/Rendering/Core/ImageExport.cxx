@@ -0,0 +1,461 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+#include <stb_image_write.h>
+
+module RenderCore.Runtime.ImageExport;
+
+import RenderCore.Utils.CPUTopology;
+import RenderCore.Utils.Logger;
+
+using namespace RenderCore;
+
+struct PendingImageExport
+{
+    std::uint64_t      Sequence { 0U };
+    ImageExportRequest Request {};
+};
+
+struct EncodedImageExport
+{
+    strzilla::string          Path {};
+    std::vector<std::uint8_t> Data {};
+    std::size_t               ReservedBytes { 0U };
+};
+
+ImageExportSettings                          g_ImageExportSettings {};
+std::mutex                                   g_ImageExportMutex {};
+std::condition_variable                      g_ImageExportWorkCondition {};
+std::condition_variable                      g_ImageExportStateCondition {};
+std::deque<PendingImageExport>               g_PendingImageExports {};
+std::map<std::uint64_t, EncodedImageExport> g_EncodedImageExports {};
+std::vector<std::jthread>                    g_ImageExportWorkers {};
+std::uint64_t                                g_NextImageExportSequence { 0U };
+std::uint64_t                                g_NextImageExportToWrite { 0U };
+std::uint64_t                                g_OutstandingImageExports { 0U };
+std::size_t                                  g_ImageExportInFlightBytes { 0U };
+bool                                         g_IsWritingImageExport { false };
+bool                                         g_StopImageExportWorkers { false };
+
+bool RenderCore::IsBGRAFormat(VkFormat const Format)
+{
+    return Format == VK_FORMAT_B8G8R8A8_UNORM || Format == VK_FORMAT_B8G8R8A8_SRGB || Format == VK_FORMAT_B8G8R8A8_SNORM;
+}
+
+void SwapRedAndBlueChannels(std::vector<std::uint8_t> &Pixels)
+{
+    for (std::size_t Iterator = 0U; Iterator + 3U < std::size(Pixels); Iterator += 4U)
+    {
+        std::swap(Pixels[Iterator], Pixels[Iterator + 2U]);
+    }
+}
+
+void WriteBigEndian(std::vector<std::uint8_t> &Output, std::uint32_t const Value)
+{
+    Output.push_back(static_cast<std::uint8_t>(Value >> 24U & 0xFFU));
+    Output.push_back(static_cast<std::uint8_t>(Value >> 16U & 0xFFU));
+    Output.push_back(static_cast<std::uint8_t>(Value >> 8U & 0xFFU));
+    Output.push_back(static_cast<std::uint8_t>(Value & 0xFFU));
+}
+
+std::vector<std::uint8_t> EncodeQOI(std::vector<std::uint8_t> const &Pixels, VkExtent2D const &Extent)
+{
+    constexpr std::uint8_t QOI_OP_INDEX = 0x00U;
+    constexpr std::uint8_t QOI_OP_DIFF  = 0x40U;
+    constexpr std::uint8_t QOI_OP_LUMA  = 0x80U;
+    constexpr std::uint8_t QOI_OP_RUN   = 0xC0U;
+    constexpr std::uint8_t QOI_OP_RGB   = 0xFEU;
+    constexpr std::uint8_t QOI_OP_RGBA  = 0xFFU;
+
+    std::vector<std::uint8_t> Output;
+    Output.reserve(14U + std::size(Pixels) / 2U + 8U);
+
+    Output.insert(std::end(Output), { 'q', 'o', 'i', 'f' });
+    WriteBigEndian(Output, Extent.width);
+    WriteBigEndian(Output, Extent.height);
+    Output.push_back(4U);
+    Output.push_back(0U);
+
+    std::array<std::array<std::uint8_t, 4U>, 64U> Index {};
+    std::array<std::uint8_t, 4U>                  Previous { 0U, 0U, 0U, 255U };
+    std::uint8_t                                  Run { 0U };
+
+    std::size_t const PixelsEnd = std::size(Pixels) - 4U;
+
+    for (std::size_t Position = 0U; Position + 3U < std::size(Pixels); Position += 4U)
+    {
+        std::array<std::uint8_t, 4U> const Pixel { Pixels[Position], Pixels[Position + 1U], Pixels[Position + 2U], Pixels[Position + 3U] };
+
+        if (Pixel == Previous)
+        {
+            ++Run;
+
+            if (Run == 62U || Position == PixelsEnd)
+            {
+                Output.push_back(static_cast<std::uint8_t>(QOI_OP_RUN | (Run - 1U)));
+                Run = 0U;
+            }
+
+            continue;
+        }
+
+        if (Run > 0U)
+        {
+            Output.push_back(static_cast<std::uint8_t>(QOI_OP_RUN | (Run - 1U)));
+            Run = 0U;
+        }
+
+        std::uint8_t const IndexPosition = (Pixel[0] * 3U + Pixel[1] * 5U + Pixel[2] * 7U + Pixel[3] * 11U) % 64U;
+
+        if (Index[IndexPosition] == Pixel)
+        {
+            Output.push_back(static_cast<std::uint8_t>(QOI_OP_INDEX | IndexPosition));
+        }
+        else
+        {
+            Index[IndexPosition] = Pixel;
+
+            if (Pixel[3] == Previous[3])
+            {
+                auto const DiffR = static_cast<std::int8_t>(Pixel[0] - Previous[0]);
+                auto const DiffG = static_cast<std::int8_t>(Pixel[1] - Previous[1]);
+                auto const DiffB = static_cast<std::int8_t>(Pixel[2] - Previous[2]);
+
+                auto const DiffRG = static_cast<std::int8_t>(DiffR - DiffG);
+                auto const DiffBG = static_cast<std::int8_t>(DiffB - DiffG);
+
+                if (DiffR > -3 && DiffR < 2 && DiffG > -3 && DiffG < 2 && DiffB > -3 && DiffB < 2)
+                {
+                    Output.push_back(static_cast<std::uint8_t>(QOI_OP_DIFF | (DiffR + 2) << 4 | (DiffG + 2) << 2 | (DiffB + 2)));
+                }
+                else if (DiffRG > -9 && DiffRG < 8 && DiffG > -33 && DiffG < 32 && DiffBG > -9 && DiffBG < 8)
+                {
+                    Output.push_back(static_cast<std::uint8_t>(QOI_OP_LUMA | (DiffG + 32)));
+                    Output.push_back(static_cast<std::uint8_t>((DiffRG + 8) << 4 | (DiffBG + 8)));
+                }
+                else
+                {
+                    Output.insert(std::end(Output), { QOI_OP_RGB, Pixel[0], Pixel[1], Pixel[2] });
+                }
+            }
+            else
+            {
+                Output.insert(std::end(Output), { QOI_OP_RGBA, Pixel[0], Pixel[1], Pixel[2], Pixel[3] });
+            }
+        }
+
+        Previous = Pixel;
+    }
+
+    Output.insert(std::end(Output), { 0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U });
+
+    return Output;
+}
+
+std::vector<std::uint8_t> EncodePNG(std::vector<std::uint8_t> const &Pixels, VkExtent2D const &Extent)
+{
+    constexpr std::int32_t Components { 4 };
+
+    std::vector<std::uint8_t> Output;
+
+    stbi_write_png_to_func(
+            [](void *Context, void *Data, int const Size)
+            {
+                auto &      Buffer = *static_cast<std::vector<std::uint8_t> *>(Context);
+                auto const *Bytes  = static_cast<std::uint8_t const *>(Data);
+                Buffer.insert(std::end(Buffer), Bytes, Bytes + Size);
+            },
+            &Output,
+            static_cast<std::int32_t>(Extent.width),
+            static_cast<std::int32_t>(Extent.height),
+            Components,
+            std::data(Pixels),
+            static_cast<std::int32_t>(Extent.width) * Components);
+
+    return Output;
+}
+
+bool WriteImageExport(EncodedImageExport const &Export)
+{
+    std::ofstream File { std::data(Export.Path), std::ios::binary | std::ios::trunc };
+
+    if (!File.is_open())
+    {
+        RENDERCORE_LOG(error, "Failed to open image export path: {}", std::data(Export.Path));
+        return false;
+    }
+
+    File.write(reinterpret_cast<char const *>(std::data(Export.Data)), static_cast<std::streamsize>(std::size(Export.Data)));
+
+    return !File.fail();
+}
+
+void ReleaseImageExport(std::size_t const Bytes)
+{
+    g_ImageExportInFlightBytes -= std::min(Bytes, g_ImageExportInFlightBytes);
+    --g_OutstandingImageExports;
+    g_ImageExportStateCondition.notify_all();
+}
+
+void FlushOrderedImageExports(std::unique_lock<std::mutex> &Lock)
+{
+    while (!g_IsWritingImageExport && g_EncodedImageExports.contains(g_NextImageExportToWrite))
+    {
+        auto Node = g_EncodedImageExports.extract(g_NextImageExportToWrite);
+
+        g_IsWritingImageExport = true;
+        Lock.unlock();
+
+        WriteImageExport(Node.mapped());
+
+        Lock.lock();
+        g_IsWritingImageExport = false;
+
+        ++g_NextImageExportToWrite;
+        ReleaseImageExport(Node.mapped().ReservedBytes);
+    }
+}
+
+void ImageExportWorker()
+{
+    std::unique_lock Lock { g_ImageExportMutex };
+
+    while (true)
+    {
+        g_ImageExportWorkCondition.wait(Lock,
+                                        []
+                                        {
+                                            return g_StopImageExportWorkers || !std::empty(g_PendingImageExports);
+                                        });
+
+        if (std::empty(g_PendingImageExports))
+        {
+            break;
+        }
+
+        PendingImageExport Pending = std::move(g_PendingImageExports.front());
+        g_PendingImageExports.pop_front();
+
+        bool const PreserveOrder = g_ImageExportSettings.PreserveOrder;
+        Lock.unlock();
+
+        std::size_t const  ReservedBytes = std::size(Pending.Request.Pixels);
+        EncodedImageExport Encoded { .Path = std::move(Pending.Request.Path), .Data = EncodeImage(Pending.Request), .ReservedBytes = ReservedBytes };
+        Pending.Request.Pixels = {};
+
+        if (PreserveOrder)
+        {
+            Lock.lock();
+            g_EncodedImageExports.emplace(Pending.Sequence, std::move(Encoded));
+            FlushOrderedImageExports(Lock);
+        }
+        else
+        {
+            WriteImageExport(Encoded);
+
+            Lock.lock();
+            ReleaseImageExport(Encoded.ReservedBytes);
+        }
+    }
+}
+
+void StartImageExportWorkers()
+{
+    if (!std::empty(g_ImageExportWorkers))
+    {
+        return;
+    }
+
+    g_StopImageExportWorkers = false;
+
+    std::uint8_t const NumWorkers = std::max<std::uint8_t>(g_ImageExportSettings.NumWorkers, 1U);
+    g_ImageExportWorkers.reserve(NumWorkers);
+
+    for (std::uint8_t Iterator = 0U; Iterator < NumWorkers; ++Iterator)
+    {
+        g_ImageExportWorkers.emplace_back([Iterator]
+        {
+            SetupCurrentWorkerThread(WorkerClass::IO, Iterator);
+            ImageExportWorker();
+        });
+    }
+}
+
+void StopImageExportWorkers()
+{
+    std::vector<std::jthread> Workers;
+
+    {
+        std::lock_guard const Lock { g_ImageExportMutex };
+        g_StopImageExportWorkers = true;
+        Workers.swap(g_ImageExportWorkers);
+    }
+
+    g_ImageExportWorkCondition.notify_all();
+    Workers.clear();
+}
+
+void RenderCore::SetImageExportSettings(ImageExportSettings const &Settings)
+{
+    WaitImageExports();
+    StopImageExportWorkers();
+
+    std::lock_guard const Lock { g_ImageExportMutex };
+    g_ImageExportSettings            = Settings;
+    g_NextImageExportToWrite         = g_NextImageExportSequence;
+    stbi_write_png_compression_level = std::clamp(Settings.PNGCompressionLevel, 0, 9);
+}
+
+ImageExportSettings RenderCore::GetImageExportSettings()
+{
+    std::lock_guard const Lock { g_ImageExportMutex };
+    return g_ImageExportSettings;
+}
+
+std::uint64_t RenderCore::EnqueueImageExport(ImageExportRequest &&Request)
+{
+    std::size_t const RequestBytes = std::size(Request.Pixels);
+
+    std::unique_lock Lock { g_ImageExportMutex };
+    StartImageExportWorkers();
+
+    g_ImageExportStateCondition.wait(Lock,
+                                     [RequestBytes]
+                                     {
+                                         return g_ImageExportInFlightBytes == 0U ||
+                                                g_ImageExportInFlightBytes + RequestBytes <= g_ImageExportSettings.MaxInFlightBytes;
+                                     });
+
+    std::uint64_t const Sequence = g_NextImageExportSequence++;
+    g_ImageExportInFlightBytes += RequestBytes;
+    ++g_OutstandingImageExports;
+    g_PendingImageExports.push_back(PendingImageExport { .Sequence = Sequence, .Request = std::move(Request) });
+
+    Lock.unlock();
+    g_ImageExportWorkCondition.notify_one();
+
+    return Sequence;
+}
+
+void RenderCore::WaitImageExports()
+{
+    std::unique_lock Lock { g_ImageExportMutex };
+
+    g_ImageExportStateCondition.wait(Lock,
+                                     []
+                                     {
+                                         return g_OutstandingImageExports == 0U;
+                                     });
+}
+
+void RenderCore::ReleaseImageExportResources()
+{
+    WaitImageExports();
+    StopImageExportWorkers();
+}
+
+std::size_t RenderCore::GetImageExportInFlightBytes()
+{
+    std::lock_guard const Lock { g_ImageExportMutex };
+    return g_ImageExportInFlightBytes;
+}
+
+ImageExportFormat RenderCore::GetImageExportFormatFromPath(strzilla::string_view const Path)
+{
+    if (Path.ends_with(".qoi"))
+    {
+        return ImageExportFormat::QOI;
+    }
+
+    if (Path.ends_with(".tga"))
+    {
+        return ImageExportFormat::TGA;
+    }
+
+    if (Path.ends_with(".raw"))
+    {
+        return ImageExportFormat::RAW;
+    }
+
+    return ImageExportFormat::PNG;
+}
+
+std::vector<std::uint8_t> RenderCore::EncodeImage(ImageExportRequest &Request)
+{
+    bool const IsBGRA = IsBGRAFormat(Request.PixelFormat);
+
+    switch (Request.Format)
+    {
+        case ImageExportFormat::PNG:
+        {
+            if (IsBGRA)
+            {
+                SwapRedAndBlueChannels(Request.Pixels);
+            }
+
+            return EncodePNG(Request.Pixels, Request.Extent);
+        }
+
+        case ImageExportFormat::QOI:
+        {
+            if (IsBGRA)
+            {
+                SwapRedAndBlueChannels(Request.Pixels);
+            }
+
+            return EncodeQOI(Request.Pixels, Request.Extent);
+        }
+
+        case ImageExportFormat::TGA:
+        {
+            if (!IsBGRA)
+            {
+                SwapRedAndBlueChannels(Request.Pixels);
+            }
+
+            std::array<std::uint8_t, 18U> const Header = MountTGAHeader(Request.Extent);
+
+            std::vector<std::uint8_t> Output;
+            Output.reserve(std::size(Header) + std::size(Request.Pixels));
+            Output.insert(std::end(Output), std::begin(Header), std::end(Header));
+            Output.insert(std::end(Output), std::begin(Request.Pixels), std::end(Request.Pixels));
+
+            return Output;
+        }
+
+        case ImageExportFormat::RAW:
+        default:
+            return std::move(Request.Pixels);
+    }
+}
+
+std::array<std::uint8_t, 18U> RenderCore::MountTGAHeader(VkExtent2D const &Extent)
+{
+    constexpr std::uint8_t UncompressedTrueColor { 2U };
+    constexpr std::uint8_t BitsPerPixel { 32U };
+    constexpr std::uint8_t TopLeftOriginWithAlpha { 0x28U };
+
+    return {
+            0U,
+            0U,
+            UncompressedTrueColor,
+            0U,
+            0U,
+            0U,
+            0U,
+            0U,
+            0U,
+            0U,
+            0U,
+            0U,
+            static_cast<std::uint8_t>(Extent.width & 0xFFU),
+            static_cast<std::uint8_t>(Extent.width >> 8U & 0xFFU),
+            static_cast<std::uint8_t>(Extent.height & 0xFFU),
+            static_cast<std::uint8_t>(Extent.height >> 8U & 0xFFU),
+            BitsPerPixel,
+            TopLeftOriginWithAlpha
+    };
+}
@@ -9,6 +9,7 @@ module RenderCore.Runtime.Instance;
 import RenderCore.Utils.Constants;
 import RenderCore.Utils.Helpers;
 import RenderCore.Utils.DebugHelpers;
+import RenderCore.Utils.AllocationCallbacks;
 
 using namespace RenderCore;
 
@@ -70,11 +71,11 @@ bool RenderCore::CreateVulkanInstance()
     CreateInfo.enabledExtensionCount   = static_cast<std::uint32_t>(std::size(Extensions));
     CreateInfo.ppEnabledExtensionNames = std::data(Extensions);
 
-    CheckVulkanResult(vkCreateInstance(&CreateInfo, nullptr, &g_Instance));
+    CheckVulkanResult(vkCreateInstance(&CreateInfo, GetAllocationCallbacks(HostAllocationTag::Instance), &g_Instance));
     volkLoadInstance(g_Instance);
 
     #ifdef _DEBUG
-    CheckVulkanResult(CreateDebugUtilsMessenger(g_Instance, &CreateDebugInfo, nullptr, &g_DebugMessenger));
+    CheckVulkanResult(CreateDebugUtilsMessenger(g_Instance, &CreateDebugInfo, GetAllocationCallbacks(HostAllocationTag::Instance), &g_DebugMessenger));
     #endif
 
     return g_Instance != VK_NULL_HANDLE;
@@ -85,11 +86,11 @@ void RenderCore::DestroyVulkanInstance()
     #ifdef _DEBUG
     if (g_DebugMessenger != VK_NULL_HANDLE)
     {
-        DestroyDebugUtilsMessenger(g_Instance, g_DebugMessenger, nullptr);
+        DestroyDebugUtilsMessenger(g_Instance, g_DebugMessenger, GetAllocationCallbacks(HostAllocationTag::Instance));
         g_DebugMessenger = VK_NULL_HANDLE;
     }
     #endif
 
-    vkDestroyInstance(g_Instance, nullptr);
+    vkDestroyInstance(g_Instance, GetAllocationCallbacks(HostAllocationTag::Instance));
     g_Instance = VK_NULL_HANDLE;
 }
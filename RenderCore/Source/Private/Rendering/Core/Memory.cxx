@@ -4,18 +4,17 @@
 
 module;
 
-#include <stb_image_write.h>
-
 #ifndef VMA_IMPLEMENTATION
-#define VMA_LEAK_LOG_FORMAT(format, ...)                                            \
-        do                                                                          \
-        {                                                                           \
-            std::size_t      _BuffSize = snprintf(nullptr, 0, format, __VA_ARGS__); \
-            strzilla::string _Message(_BuffSize + 1, '\0');                         \
-            snprintf(&_Message[0], _Message.size(), format, __VA_ARGS__);           \
-            _Message.pop_back();                                                    \
-            BOOST_LOG_TRIVIAL(debug) << _Message;                                   \
-        }                                                                           \
+#define VMA_LEAK_LOG_FORMAT(format, ...)                                                        \
+        do                                                                                      \
+        {                                                                                       \
+            if constexpr (boost::log::trivial::debug >= RENDERCORE_MIN_LOG_LEVEL)               \
+            {                                                                                   \
+                char _Message[512];                                                             \
+                snprintf(_Message, sizeof(_Message), format, __VA_ARGS__);                      \
+                RenderCore::EnqueueLogMessage(boost::log::trivial::debug, nullptr, _Message);   \
+            }                                                                                   \
+        }                                                                                       \
         while (false)
 
 #define VMA_IMPLEMENTATION
@@ -27,8 +26,12 @@ module RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Device;
 import RenderCore.Runtime.Instance;
 import RenderCore.Runtime.Command;
+import RenderCore.Runtime.ImageExport;
+import RenderCore.Types.Mesh;
 import RenderCore.Types.UniformBufferObject;
 import RenderCore.Types.Vertex;
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.AllocationCallbacks;
 
 using namespace RenderCore;
 
@@ -37,7 +40,13 @@ void RenderCore::CreateMemoryAllocator()
     VkPhysicalDevice const &PhysicalDevice = GetPhysicalDevice();
     VkDevice const &        LogicalDevice  = GetLogicalDevice();
 
-    VmaVulkanFunctions const VulkanFunctions { .vkGetInstanceProcAddr = vkGetInstanceProcAddr, .vkGetDeviceProcAddr = vkGetDeviceProcAddr };
+    // Memory entry points come from volk, so allocations made by VMA are attributed when the API calls are tracked
+    VmaVulkanFunctions const VulkanFunctions {
+            .vkGetInstanceProcAddr = vkGetInstanceProcAddr,
+            .vkGetDeviceProcAddr = vkGetDeviceProcAddr,
+            .vkAllocateMemory = vkAllocateMemory,
+            .vkFreeMemory = vkFreeMemory
+    };
 
     VmaAllocatorCreateInfo const AllocatorInfo {
             .flags = VMA_ALLOCATOR_CREATE_EXTERNALLY_SYNCHRONIZED_BIT | VMA_ALLOCATOR_CREATE_KHR_DEDICATED_ALLOCATION_BIT |
@@ -45,7 +54,7 @@ void RenderCore::CreateMemoryAllocator()
             .physicalDevice = PhysicalDevice,
             .device = LogicalDevice,
             .preferredLargeHeapBlockSize = 0U /*Default: 256 MiB*/,
-            .pAllocationCallbacks = nullptr,
+            .pAllocationCallbacks = GetAllocationCallbacks(HostAllocationTag::Memory),
             .pDeviceMemoryCallbacks = nullptr,
             .pHeapSizeLimit = nullptr,
             .pVulkanFunctions = &VulkanFunctions,
@@ -193,7 +202,7 @@ VmaAllocationInfo RenderCore::CreateBuffer(VkDeviceSize const &        Size,
         AllocationCreateInfo.pool = g_DescriptorBufferPool;
         AllocationCreateInfo.flags |= g_MapMemoryFlag;
     }
-    else if (IsStagingBuffer || Usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT || Identifier == "IMGUI_RENDER")
+    else if (IsStagingBuffer || Usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) || Identifier == "IMGUI_RENDER")
     {
         AllocationCreateInfo.flags |= g_MapMemoryFlag;
 
@@ -224,13 +233,29 @@ void RenderCore::CopyBuffer(VkCommandBuffer const &CommandBuffer, VkBuffer const
 void RenderCore::CreateUniformBuffers(BufferAllocation &BufferAllocation, VkDeviceSize const BufferSize, strzilla::string_view const Identifier)
 {
     VmaAllocator const &         Allocator  = GetAllocator();
-    constexpr VkBufferUsageFlags UsageFlags = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    constexpr VkBufferUsageFlags UsageFlags = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                                              VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
     BufferAllocation.Size = BufferSize;
     CreateBuffer(BufferSize, UsageFlags, Identifier, BufferAllocation.Buffer, BufferAllocation.Allocation);
     vmaMapMemory(Allocator, BufferAllocation.Allocation, &BufferAllocation.MappedData);
 }
 
+VkDeviceAddress RenderCore::GetBufferDeviceAddress(VkBuffer const &Buffer)
+{
+    if (Buffer == VK_NULL_HANDLE)
+    {
+        return 0U;
+    }
+
+    VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = Buffer
+    };
+
+    return vkGetBufferDeviceAddress(GetLogicalDevice(), &BufferDeviceAddressInfo);
+}
+
 void RenderCore::CreateImage(VkFormat const &            ImageFormat,
                              VkExtent2D const &          Extent,
                              VkImageTiling const &       Tiling,
@@ -275,7 +300,7 @@ void RenderCore::CreateImageView(VkImage const &Image, VkFormat const &Format, V
     };
 
     VkDevice const &LogicalDevice = GetLogicalDevice();
-    CheckVulkanResult(vkCreateImageView(LogicalDevice, &ImageViewCreateInfo, nullptr, &ImageView));
+    CheckVulkanResult(vkCreateImageView(LogicalDevice, &ImageViewCreateInfo, GetAllocationCallbacks(HostAllocationTag::Memory), &ImageView));
 }
 
 void RenderCore::CreateTextureImageView(ImageAllocation &Allocation, VkFormat const ImageFormat)
@@ -304,6 +329,8 @@ std::tuple<std::uint32_t, VkBuffer, VmaAllocation> RenderCore::AllocateTexture(V
                                                                                VkFormat const         ImageFormat,
                                                                                VkDeviceSize const     AllocationSize)
 {
+    RENDERCORE_PROFILE_SCOPE("Texture Upload");
+
     if (std::empty(g_AllocatedImages))
     {
         g_ImageAllocationIDCounter.fetch_sub(g_ImageAllocationIDCounter.load());
@@ -356,39 +383,88 @@ std::tuple<std::uint32_t, VkBuffer, VmaAllocation> RenderCore::AllocateTexture(V
     return { BufferID, Output.first, Output.second };
 }
 
-void RenderCore::AllocateModelsBuffers(std::vector<std::shared_ptr<Object>> const &Objects)
+ModelsBufferLayout RenderCore::PackModelsBuffers(std::vector<std::shared_ptr<Object>> const &Objects,
+                                                VkDeviceSize const                          MinUniformAlignment,
+                                                std::vector<Vertex> &                       Vertices,
+                                                std::vector<std::uint32_t> &                Indices)
 {
-    if (g_BufferAllocation.IsValid())
+    // Objects may share the same mesh (e.g. generated scenes), so each mesh is packed only once
+    std::vector<Mesh *>                           UniqueMeshes {};
+    std::unordered_map<Mesh const *, std::size_t> PackedMeshes {};
+
+    std::size_t NumVertices = 0U;
+    std::size_t NumIndices  = 0U;
+
+    for (auto const &ObjectIter : Objects)
     {
-        g_BufferAllocation.DestroyResources(g_Allocator);
+        if (auto const &Mesh = ObjectIter->GetMesh();
+            PackedMeshes.try_emplace(Mesh.get(), std::size(UniqueMeshes)).second)
+        {
+            UniqueMeshes.push_back(Mesh.get());
+            NumVertices += Mesh->GetNumVertices();
+            NumIndices += Mesh->GetNumIndices();
+        }
     }
 
-    std::vector<Vertex>        Vertices;
-    std::vector<std::uint32_t> Indices;
+    Vertices.clear();
+    Indices.clear();
+    Vertices.reserve(NumVertices);
+    Indices.reserve(NumIndices);
 
-    for (auto const &ObjectIter : Objects)
+    for (Mesh *const MeshIter : UniqueMeshes)
+    {
+        MeshIter->SetVertexOffset(std::size(Vertices) * sizeof(Vertex));
+        MeshIter->SetIndexOffset(std::size(Indices) * sizeof(std::uint32_t));
+
+        Vertices.insert(std::end(Vertices), std::begin(MeshIter->GetVertices()), std::end(MeshIter->GetVertices()));
+        Indices.insert(std::end(Indices), std::begin(MeshIter->GetIndices()), std::end(MeshIter->GetIndices()));
+    }
+
+    ModelsBufferLayout Output {
+            .VertexBufferSize = std::size(Vertices) * sizeof(Vertex),
+            .IndexBufferSize = std::size(Indices) * sizeof(std::uint32_t)
+    };
+
+    Output.UniformOffset = Output.VertexBufferSize + Output.IndexBufferSize;
+
+    if (MinUniformAlignment > 0U)
     {
-        auto const &Mesh = ObjectIter->GetMesh();
+        Output.UniformOffset = Output.UniformOffset + MinUniformAlignment - 1U & ~(MinUniformAlignment - 1U);
+    }
 
-        Mesh->SetVertexOffset(std::size(Vertices) * sizeof(Vertex));
-        Mesh->SetIndexOffset(std::size(Indices) * sizeof(std::uint32_t));
+    for (Mesh *const MeshIter : UniqueMeshes)
+    {
+        MeshIter->SetIndexOffset(MeshIter->GetIndexOffset() + Output.VertexBufferSize);
+    }
 
-        Vertices.insert(std::end(Vertices), std::begin(Mesh->GetVertices()), std::end(Mesh->GetVertices()));
-        Indices.insert(std::end(Indices), std::begin(Mesh->GetIndices()), std::end(Mesh->GetIndices()));
+    for (std::size_t ObjectIndex = 0U; ObjectIndex < std::size(Objects); ++ObjectIndex)
+    {
+        auto const &ObjectIter = Objects.at(ObjectIndex);
 
+        ObjectIter->SetUniformOffset(static_cast<std::uint32_t>(Output.UniformOffset + sizeof(ModelUniformData) * ObjectIndex));
         ObjectIter->MarkAsRenderDirty();
     }
 
-    VkDeviceSize const VertexBufferSize = std::size(Vertices) * sizeof(Vertex);
-    VkDeviceSize const IndexBufferSize  = std::size(Indices) * sizeof(std::uint32_t);
-    VkDeviceSize       UniformOffset    = VertexBufferSize + IndexBufferSize;
+    return Output;
+}
+
+void RenderCore::AllocateModelsBuffers(std::vector<std::shared_ptr<Object>> const &Objects)
+{
+    RENDERCORE_PROFILE_FUNCTION();
 
-    if (VkDeviceSize const MinAlignment = GetPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment;
-        MinAlignment > 0U)
+    if (g_BufferAllocation.IsValid())
     {
-        UniformOffset = UniformOffset + MinAlignment - 1U & ~(MinAlignment - 1U);
+        g_BufferAllocation.DestroyResources(g_Allocator);
     }
 
+    std::vector<Vertex>        Vertices;
+    std::vector<std::uint32_t> Indices;
+
+    auto const [VertexBufferSize, IndexBufferSize, UniformOffset] = PackModelsBuffers(Objects,
+                                                                                       GetPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment,
+                                                                                       Vertices,
+                                                                                       Indices);
+
     VmaAllocator const &Allocator  = GetAllocator();
     VkDeviceSize const  BufferSize = UniformOffset + sizeof(ModelUniformData) * std::size(Objects);
 
@@ -403,22 +479,17 @@ void RenderCore::AllocateModelsBuffers(std::vector<std::shared_ptr<Object>> cons
 
     for (auto const &ObjectIter : Objects)
     {
-        auto const &Mesh = ObjectIter->GetMesh();
-
-        Mesh->SetIndexOffset(Mesh->GetIndexOffset() + VertexBufferSize);
-
-        ObjectIter->SetUniformOffset(UniformOffset + sizeof(ModelUniformData) * std::distance(std::data(Objects), &ObjectIter));
         ObjectIter->SetupUniformDescriptor();
     }
 }
 
-void RenderCore::SaveImageToFile(VkImage const &Image, strzilla::string_view const Path, VkExtent2D const &Extent)
+std::vector<std::uint8_t> RenderCore::ReadbackImage(VkImage const &Image, VkExtent2D const &Extent)
 {
-    VkBuffer            Buffer;
-    VmaAllocation       Allocation;
-    VkSubresourceLayout Layout;
+    VkBuffer      Buffer;
+    VmaAllocation Allocation;
 
     constexpr std::uint8_t Components { 4U };
+    VkDeviceSize const     BufferSize = static_cast<VkDeviceSize>(Extent.width) * Extent.height * Components;
 
     auto const &[FamilyIndex, Queue] = GetGraphicsQueue();
 
@@ -426,14 +497,9 @@ void RenderCore::SaveImageToFile(VkImage const &Image, strzilla::string_view con
     std::vector<VkCommandBuffer> CommandBuffer { VK_NULL_HANDLE };
     InitializeSingleCommandQueue(CommandPool, CommandBuffer, FamilyIndex);
     {
-        VkImageSubresource SubResource { .aspectMask = g_ImageAspect, .mipLevel = 0, .arrayLayer = 0 };
-
-        VkDevice const &LogicalDevice = GetLogicalDevice();
-        vkGetImageSubresourceLayout(LogicalDevice, Image, &SubResource, &Layout);
-
         VkBufferCreateInfo BufferInfo {
                 .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-                .size = Layout.size,
+                .size = BufferSize,
                 .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                 .sharingMode = VK_SHARING_MODE_EXCLUSIVE
         };
@@ -497,13 +563,26 @@ void RenderCore::SaveImageToFile(VkImage const &Image, strzilla::string_view con
 
     void *ImageData;
     vmaMapMemory(g_Allocator, Allocation, &ImageData);
+    CheckVulkanResult(vmaInvalidateAllocation(g_Allocator, Allocation, 0U, VK_WHOLE_SIZE));
 
-    auto ImagePixels = static_cast<unsigned char *>(ImageData);
-
-    stbi_write_png(std::data(Path), Extent.width, Extent.height, Components, ImagePixels, Extent.width * Components);
+    auto const *              ImagePixels = static_cast<std::uint8_t const *>(ImageData);
+    std::vector<std::uint8_t> Output(ImagePixels, ImagePixels + BufferSize);
 
     vmaUnmapMemory(g_Allocator, Allocation);
     vmaDestroyBuffer(g_Allocator, Buffer, Allocation);
+
+    return Output;
+}
+
+void RenderCore::SaveImageToFile(VkImage const &Image, strzilla::string_view const Path, VkExtent2D const &Extent, VkFormat const Format)
+{
+    EnqueueImageExport(ImageExportRequest {
+            .Path = strzilla::string { Path },
+            .Format = GetImageExportFormatFromPath(Path),
+            .Extent = Extent,
+            .PixelFormat = Format,
+            .Pixels = ReadbackImage(Image, Extent)
+    });
 }
 
 void TextureDeleter::operator()(Texture *const Texture) const
@@ -523,7 +602,7 @@ void RenderCore::PrintMemoryAllocatorStats(bool const DetailedMap)
 {
     char *Stats;
     vmaBuildStatsString(g_Allocator, &Stats, DetailedMap);
-    BOOST_LOG_TRIVIAL(info) << Stats;
+    EnqueueLogMessage(boost::log::trivial::info, nullptr, Stats);
     vmaFreeStatsString(g_Allocator, Stats);
 }
 
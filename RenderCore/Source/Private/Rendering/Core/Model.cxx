@@ -4,6 +4,11 @@
 
 module;
 
+#ifndef GLM_ENABLE_EXPERIMENTAL
+    #define GLM_ENABLE_EXPERIMENTAL
+#endif // GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/matrix_decompose.hpp>
+
 module RenderCore.Runtime.Model;
 
 import RenderCore.Types.Vertex;
@@ -57,7 +62,70 @@ float const *RenderCore::GetPrimitiveData(strzilla::string_view const &ID,
     return nullptr;
 }
 
-void RenderCore::SetVertexAttributes(std::shared_ptr<Mesh> const &Mesh, tinygltf::Model const &Model, tinygltf::Primitive const &Primitive)
+// Joints are stored as unsigned integers and weights may be normalized ones, so these are converted by component type and stride
+std::pmr::vector<glm::vec4> RenderCore::GetPrimitiveVec4Data(strzilla::string_view const &   ID,
+                                                             tinygltf::Model const &         Model,
+                                                             tinygltf::Primitive const &     Primitive,
+                                                             std::pmr::memory_resource *const TransientResource)
+{
+    std::pmr::vector<glm::vec4> Output { TransientResource };
+
+    if (!Primitive.attributes.contains(std::data(ID)))
+    {
+        return Output;
+    }
+
+    tinygltf::Accessor const &  Accessor   = Model.accessors.at(Primitive.attributes.at(std::data(ID)));
+    tinygltf::BufferView const &BufferView = Model.bufferViews.at(Accessor.bufferView);
+    tinygltf::Buffer const &    Buffer     = Model.buffers.at(BufferView.buffer);
+    std::int32_t const          ByteStride = Accessor.ByteStride(BufferView);
+
+    if (Accessor.type != TINYGLTF_TYPE_VEC4 || ByteStride <= 0)
+    {
+        return Output;
+    }
+
+    unsigned char const *const Data = std::data(Buffer.data) + BufferView.byteOffset + Accessor.byteOffset;
+    Output.resize(Accessor.count);
+
+    for (std::size_t Iterator = 0U; Iterator < Accessor.count; ++Iterator)
+    {
+        unsigned char const *const Element = Data + Iterator * ByteStride;
+        glm::vec4 &                Value   = Output.at(Iterator);
+
+        switch (Accessor.componentType)
+        {
+            case TINYGLTF_PARAMETER_TYPE_FLOAT:
+                Value = glm::make_vec4(reinterpret_cast<float const *>(Element));
+                break;
+            case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT:
+                Value = glm::vec4 { glm::make_vec4(reinterpret_cast<std::uint16_t const *>(Element)) };
+
+                if (Accessor.normalized)
+                {
+                    Value /= static_cast<float>(std::numeric_limits<std::uint16_t>::max());
+                }
+                break;
+            case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE:
+                Value = glm::vec4 { glm::make_vec4(Element) };
+
+                if (Accessor.normalized)
+                {
+                    Value /= static_cast<float>(std::numeric_limits<std::uint8_t>::max());
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return Output;
+}
+
+void RenderCore::SetVertexAttributes(std::shared_ptr<Mesh> const &   Mesh,
+                                     tinygltf::Model const &         Model,
+                                     tinygltf::Primitive const &     Primitive,
+                                     std::pmr::memory_resource *const TransientResource)
 {
     std::vector<Vertex> Vertices;
     {
@@ -70,11 +138,11 @@ void RenderCore::SetVertexAttributes(std::shared_ptr<Mesh> const &Mesh, tinygltf
     float const * TexCoordData = GetPrimitiveData("TEXCOORD_0", Model, Primitive);
     std::uint32_t NumColorComponents {};
     float const * ColorData   = GetPrimitiveData("COLOR_0", Model, Primitive, &NumColorComponents);
-    float const * JointData   = GetPrimitiveData("JOINTS_0", Model, Primitive);
-    float const * WeightData  = GetPrimitiveData("WEIGHTS_0", Model, Primitive);
     float const * TangentData = GetPrimitiveData("TANGENT", Model, Primitive);
 
-    bool const HasSkin = JointData && WeightData;
+    std::pmr::vector<glm::vec4> const JointData  = GetPrimitiveVec4Data("JOINTS_0", Model, Primitive, TransientResource);
+    std::pmr::vector<glm::vec4> const WeightData = GetPrimitiveVec4Data("WEIGHTS_0", Model, Primitive, TransientResource);
+    bool const                        HasSkin    = std::size(JointData) == std::size(Vertices) && std::size(WeightData) == std::size(Vertices);
 
     for (std::uint32_t Iterator = 0U; Iterator < static_cast<std::uint32_t>(std::size(Vertices)); ++Iterator)
     {
@@ -114,8 +182,8 @@ void RenderCore::SetVertexAttributes(std::shared_ptr<Mesh> const &Mesh, tinygltf
 
         if (HasSkin)
         {
-            Vertices.at(Iterator).Joint  = glm::make_vec4(&JointData[Iterator * 4]);
-            Vertices.at(Iterator).Weight = glm::make_vec4(&WeightData[Iterator * 4]);
+            Vertices.at(Iterator).Joint  = JointData.at(Iterator);
+            Vertices.at(Iterator).Weight = WeightData.at(Iterator);
         }
 
         if (TangentData)
@@ -124,7 +192,7 @@ void RenderCore::SetVertexAttributes(std::shared_ptr<Mesh> const &Mesh, tinygltf
         }
     }
 
-    Mesh->SetVertices(Vertices);
+    Mesh->SetVertices(std::move(Vertices));
 }
 
 void RenderCore::AllocatePrimitiveIndices(std::shared_ptr<Mesh> const &Mesh, tinygltf::Model const &Model, tinygltf::Primitive const &Primitive)
@@ -162,7 +230,7 @@ void RenderCore::AllocatePrimitiveIndices(std::shared_ptr<Mesh> const &Mesh, tin
         }
     }
 
-    Mesh->SetIndices(Indices);
+    Mesh->SetIndices(std::move(Indices));
 }
 
 void RenderCore::SetPrimitiveTransform(std::shared_ptr<Mesh> const &Mesh, tinygltf::Node const &Node)
@@ -192,3 +260,312 @@ void RenderCore::SetPrimitiveTransform(std::shared_ptr<Mesh> const &Mesh, tinygl
     Mesh->SetTransform(Transform);
     Mesh->SetupBounds();
 }
+
+// Every node is kept, not only the joints, as the joints inherit the transforms of the nodes above them
+std::shared_ptr<Skeleton> RenderCore::ConstructSkeleton(tinygltf::Model const &Model)
+{
+    std::size_t const         NumNodes = std::size(Model.nodes);
+    std::vector<std::int32_t> Parents(NumNodes, -1);
+    std::vector<glm::vec3>    Translations(NumNodes, glm::vec3 { 0.F });
+    std::vector<glm::quat>    Rotations(NumNodes, glm::identity<glm::quat>());
+    std::vector<glm::vec3>    Scales(NumNodes, glm::vec3 { 1.F });
+
+    for (std::size_t NodeIndex = 0U; NodeIndex < NumNodes; ++NodeIndex)
+    {
+        tinygltf::Node const &Node = Model.nodes.at(NodeIndex);
+
+        for (std::int32_t const ChildIt : Node.children)
+        {
+            Parents.at(ChildIt) = static_cast<std::int32_t>(NodeIndex);
+        }
+
+        if (!std::empty(Node.matrix))
+        {
+            glm::vec3       Skew {};
+            glm::vec4       Perspective {};
+            glm::mat4 const Matrix { glm::make_mat4(std::data(Node.matrix)) };
+
+            decompose(Matrix, Scales.at(NodeIndex), Rotations.at(NodeIndex), Translations.at(NodeIndex), Skew, Perspective);
+            continue;
+        }
+
+        if (!std::empty(Node.translation))
+        {
+            Translations.at(NodeIndex) = glm::vec3 { glm::make_vec3(std::data(Node.translation)) };
+        }
+
+        if (!std::empty(Node.rotation))
+        {
+            Rotations.at(NodeIndex) = glm::quat { glm::make_quat(std::data(Node.rotation)) };
+        }
+
+        if (!std::empty(Node.scale))
+        {
+            Scales.at(NodeIndex) = glm::vec3 { glm::make_vec3(std::data(Node.scale)) };
+        }
+    }
+
+    auto NewSkeleton = std::make_shared<Skeleton>();
+    NewSkeleton->SetNodes(Parents, Translations, Rotations, Scales);
+
+    for (tinygltf::Skin const &SkinIt : Model.skins)
+    {
+        SkinData Skin {
+                .JointNodes = std::vector<std::uint32_t>(std::begin(SkinIt.joints), std::end(SkinIt.joints)),
+                .InverseBindMatrices = std::vector<glm::mat4>(std::size(SkinIt.joints), glm::mat4 { 1.F })
+        };
+
+        if (SkinIt.inverseBindMatrices >= 0)
+        {
+            tinygltf::Accessor const &  Accessor   = Model.accessors.at(SkinIt.inverseBindMatrices);
+            tinygltf::BufferView const &BufferView = Model.bufferViews.at(Accessor.bufferView);
+            tinygltf::Buffer const &    Buffer     = Model.buffers.at(BufferView.buffer);
+            unsigned char const *const  Data       = std::data(Buffer.data) + BufferView.byteOffset + Accessor.byteOffset;
+            std::int32_t const          ByteStride = Accessor.ByteStride(BufferView);
+
+            for (std::size_t JointIndex = 0U; JointIndex < std::min<std::size_t>(Accessor.count, std::size(SkinIt.joints)) && ByteStride > 0; ++JointIndex)
+            {
+                Skin.InverseBindMatrices.at(JointIndex) = glm::make_mat4(reinterpret_cast<float const *>(Data + JointIndex * ByteStride));
+            }
+        }
+
+        NewSkeleton->AddSkin(std::move(Skin));
+    }
+
+    return NewSkeleton;
+}
+
+// Animation outputs are floats, or normalized integers for the rotations of quantized models
+std::pmr::vector<float> RenderCore::GetAccessorFloatData(tinygltf::Model const &         Model,
+                                                         std::int32_t const              AccessorIndex,
+                                                         std::pmr::memory_resource *const TransientResource)
+{
+    std::pmr::vector<float> Output { TransientResource };
+
+    if (AccessorIndex < 0)
+    {
+        return Output;
+    }
+
+    tinygltf::Accessor const &Accessor = Model.accessors.at(AccessorIndex);
+
+    if (Accessor.bufferView < 0)
+    {
+        return Output;
+    }
+
+    tinygltf::BufferView const &BufferView    = Model.bufferViews.at(Accessor.bufferView);
+    tinygltf::Buffer const &    Buffer        = Model.buffers.at(BufferView.buffer);
+    std::int32_t const          ByteStride    = Accessor.ByteStride(BufferView);
+    std::int32_t const          NumComponents = tinygltf::GetNumComponentsInType(static_cast<std::uint32_t>(Accessor.type));
+
+    if (ByteStride <= 0 || NumComponents <= 0)
+    {
+        return Output;
+    }
+
+    unsigned char const *const Data = std::data(Buffer.data) + BufferView.byteOffset + Accessor.byteOffset;
+    Output.resize(Accessor.count * NumComponents);
+
+    for (std::size_t Iterator = 0U; Iterator < Accessor.count; ++Iterator)
+    {
+        unsigned char const *const Element = Data + Iterator * ByteStride;
+
+        for (std::int32_t Component = 0; Component < NumComponents; ++Component)
+        {
+            float &Value = Output.at(Iterator * NumComponents + Component);
+
+            switch (Accessor.componentType)
+            {
+                case TINYGLTF_PARAMETER_TYPE_FLOAT:
+                    Value = reinterpret_cast<float const *>(Element)[Component];
+                    break;
+                case TINYGLTF_PARAMETER_TYPE_SHORT:
+                    Value = std::max(reinterpret_cast<std::int16_t const *>(Element)[Component] / 32767.F, -1.F);
+                    break;
+                case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT:
+                    Value = reinterpret_cast<std::uint16_t const *>(Element)[Component] / 65535.F;
+                    break;
+                case TINYGLTF_PARAMETER_TYPE_BYTE:
+                    Value = std::max(reinterpret_cast<std::int8_t const *>(Element)[Component] / 127.F, -1.F);
+                    break;
+                case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE:
+                    Value = Element[Component] / 255.F;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    return Output;
+}
+
+// Channels are grouped in tracks by their sampler input and interpolation, and those that move no joint are dropped: only skins are animated
+std::vector<AnimationClip> RenderCore::ConstructAnimations(tinygltf::Model const &         Model,
+                                                           Skeleton const &                Target,
+                                                           std::pmr::memory_resource *const TransientResource)
+{
+    std::uint32_t const            NumNodes = Target.GetNumNodes();
+    std::pmr::vector<std::uint8_t> AnimatedNodes(NumNodes, 0U, TransientResource);
+
+    for (SkinData const &SkinIt : Target.GetSkins())
+    {
+        for (std::uint32_t const JointIt : SkinIt.JointNodes)
+        {
+            for (auto Node = static_cast<std::int32_t>(JointIt); Node >= 0 && AnimatedNodes.at(Node) == 0U; Node = Target.GetNodeParent(Node))
+            {
+                AnimatedNodes.at(Node) = 1U;
+            }
+        }
+    }
+
+    // The lanes of a track are only known once all of its channels are found, so the outputs are copied in a second pass
+    struct PendingChannel
+    {
+        std::uint32_t TrackIndex { 0U };
+        std::uint32_t FirstLane { 0U };
+        std::uint32_t NumComponents { 0U };
+        std::int32_t  OutputAccessor { -1 };
+    };
+
+    std::vector<AnimationClip> Output {};
+    Output.reserve(std::size(Model.animations));
+
+    for (tinygltf::Animation const &AnimationIt : Model.animations)
+    {
+        AnimationClip                    Clip { .Name = strzilla::string { std::data(AnimationIt.name) } };
+        std::pmr::vector<std::int32_t>   TrackInputs { TransientResource };
+        std::pmr::vector<PendingChannel> PendingChannels { TransientResource };
+
+        for (tinygltf::AnimationChannel const &ChannelIt : AnimationIt.channels)
+        {
+            if (ChannelIt.target_node < 0 || ChannelIt.target_node >= static_cast<std::int32_t>(NumNodes) || ChannelIt.sampler < 0 ||
+                AnimatedNodes.at(ChannelIt.target_node) == 0U)
+            {
+                continue;
+            }
+
+            AnimationPath Path { AnimationPath::TRANSLATION };
+
+            if (ChannelIt.target_path == "rotation")
+            {
+                Path = AnimationPath::ROTATION;
+            }
+            else if (ChannelIt.target_path == "scale")
+            {
+                Path = AnimationPath::SCALE;
+            }
+            else if (ChannelIt.target_path != "translation")
+            {
+                continue;
+            }
+
+            tinygltf::AnimationSampler const &Sampler = AnimationIt.samplers.at(ChannelIt.sampler);
+            AnimationInterpolation            Interpolation { AnimationInterpolation::LINEAR };
+
+            if (Sampler.interpolation == "STEP")
+            {
+                Interpolation = AnimationInterpolation::STEP;
+            }
+            else if (Sampler.interpolation == "CUBICSPLINE")
+            {
+                Interpolation = AnimationInterpolation::CUBIC_SPLINE;
+            }
+
+            if (Sampler.input < 0 || Sampler.output < 0 || Model.accessors.at(Sampler.input).bufferView < 0 ||
+                Model.accessors.at(Sampler.output).bufferView < 0)
+            {
+                continue;
+            }
+
+            // Cubic splines hold an in-tangent, a value and an out-tangent per key
+            std::size_t const NumKeys    = Model.accessors.at(Sampler.input).count;
+            std::size_t const NumOutputs = Model.accessors.at(Sampler.output).count;
+
+            if (NumKeys == 0U || NumOutputs != NumKeys * (Interpolation == AnimationInterpolation::CUBIC_SPLINE ? 3U : 1U))
+            {
+                continue;
+            }
+
+            std::size_t TrackIndex = 0U;
+
+            while (TrackIndex < std::size(Clip.Tracks) &&
+                   (TrackInputs.at(TrackIndex) != Sampler.input || Clip.Tracks.at(TrackIndex).Interpolation != Interpolation))
+            {
+                ++TrackIndex;
+            }
+
+            if (TrackIndex == std::size(Clip.Tracks))
+            {
+                std::pmr::vector<float> const Times = GetAccessorFloatData(Model, Sampler.input, TransientResource);
+                Clip.Tracks.push_back(AnimationTrack { .Interpolation = Interpolation, .Times = std::vector(std::begin(Times), std::end(Times)) });
+                TrackInputs.push_back(Sampler.input);
+            }
+
+            AnimationTrack &    Track         = Clip.Tracks.at(TrackIndex);
+            std::uint32_t const NumComponents = Path == AnimationPath::ROTATION ? 4U : 3U;
+
+            Track.Targets.push_back(AnimationTarget { .Node = static_cast<std::uint32_t>(ChannelIt.target_node), .FirstLane = Track.NumLanes, .Path = Path });
+
+            PendingChannels.push_back(PendingChannel {
+                    .TrackIndex = static_cast<std::uint32_t>(TrackIndex),
+                    .FirstLane = Track.NumLanes,
+                    .NumComponents = NumComponents,
+                    .OutputAccessor = Sampler.output
+            });
+
+            Track.NumLanes += NumComponents;
+        }
+
+        for (AnimationTrack &TrackIt : Clip.Tracks)
+        {
+            std::size_t const NumValues = std::size(TrackIt.Times) * TrackIt.NumLanes;
+            TrackIt.Values.assign(NumValues, 0.F);
+
+            if (TrackIt.Interpolation == AnimationInterpolation::CUBIC_SPLINE)
+            {
+                TrackIt.InTangents.assign(NumValues, 0.F);
+                TrackIt.OutTangents.assign(NumValues, 0.F);
+            }
+
+            Clip.Duration = std::max(Clip.Duration, TrackIt.Times.back());
+            Clip.MaxLanes = std::max(Clip.MaxLanes, TrackIt.NumLanes);
+        }
+
+        for (auto const &[TrackIndex, FirstLane, NumComponents, OutputAccessor] : PendingChannels)
+        {
+            AnimationTrack &              Track    = Clip.Tracks.at(TrackIndex);
+            std::pmr::vector<float> const Data     = GetAccessorFloatData(Model, OutputAccessor, TransientResource);
+            bool const                    IsCubic  = Track.Interpolation == AnimationInterpolation::CUBIC_SPLINE;
+            std::size_t const             NumKeys  = std::size(Track.Times);
+            std::size_t const             KeyWidth = IsCubic ? NumComponents * 3U : NumComponents;
+
+            if (std::size(Data) < NumKeys * KeyWidth)
+            {
+                continue;
+            }
+
+            for (std::size_t Key = 0U; Key < NumKeys; ++Key)
+            {
+                float const *const Source      = std::data(Data) + Key * KeyWidth;
+                std::size_t const  Destination = Key * Track.NumLanes + FirstLane;
+
+                if (IsCubic)
+                {
+                    std::copy_n(Source, NumComponents, std::data(Track.InTangents) + Destination);
+                    std::copy_n(Source + NumComponents, NumComponents, std::data(Track.Values) + Destination);
+                    std::copy_n(Source + NumComponents * 2U, NumComponents, std::data(Track.OutTangents) + Destination);
+                }
+                else
+                {
+                    std::copy_n(Source, NumComponents, std::data(Track.Values) + Destination);
+                }
+            }
+        }
+
+        Output.push_back(std::move(Clip));
+    }
+
+    return Output;
+}
@@ -22,7 +22,8 @@ void RenderCore::CreateOffscreenResources(SurfaceProperties const &SurfaceProper
                       ImageIter.DestroyResources(Allocator);
                   });
 
-    constexpr VkImageUsageFlags UsageFlags = VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    constexpr VkImageUsageFlags UsageFlags = VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                                             VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
     std::for_each(std::execution::unseq,
                   std::begin(g_OffscreenImages),
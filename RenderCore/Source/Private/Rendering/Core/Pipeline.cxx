@@ -11,12 +11,17 @@ import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.ShaderCompiler;
 import RenderCore.Runtime.SwapChain;
 import RenderCore.Runtime.Scene;
+import RenderCore.Runtime.Skinning;
+import RenderCore.Runtime.VisibilityBuffer;
 import RenderCore.Types.Allocation;
 import RenderCore.Types.UniformBufferObject;
 import RenderCore.Types.Texture;
 import RenderCore.Types.Vertex;
 import RenderCore.Utils.Constants;
 import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.AllocationCallbacks;
+import RenderCore.Utils.Logger;
 
 using namespace RenderCore;
 
@@ -49,58 +54,184 @@ constexpr VkPipelineDepthStencilStateCreateInfo g_DepthStencilState {
 
 constexpr VkPipelineCacheCreateInfo g_PipelineCacheCreateInfo { .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
 
+constexpr auto g_PipelineCachePath        = "Cache/PipelineCache.bin";
+constexpr auto g_PipelineLibraryCachePath = "Cache/PipelineLibraryCache.bin";
+
+std::vector<char> g_PipelineCacheData {};
+std::vector<char> g_PipelineLibraryCacheData {};
+
+std::vector<char> ReadPipelineCacheFile(strzilla::string_view const Path)
+{
+    std::vector<char> Output {};
+
+    if (!std::filesystem::exists(std::data(Path)))
+    {
+        return Output;
+    }
+
+    if (std::ifstream File(std::data(Path), std::ios::binary | std::ios::ate);
+        File.is_open())
+    {
+        Output.resize(static_cast<std::size_t>(File.tellg()));
+        File.seekg(0);
+        File.read(std::data(Output), static_cast<std::streamsize>(std::size(Output)));
+    }
+
+    return Output;
+}
+
+void WritePipelineCacheFile(strzilla::string_view const Path, VkPipelineCache const &Cache)
+{
+    if (Cache == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    std::size_t DataSize { 0U };
+    CheckVulkanResult(vkGetPipelineCacheData(LogicalDevice, Cache, &DataSize, nullptr));
+
+    if (DataSize == 0U)
+    {
+        return;
+    }
+
+    std::vector<char> Data(DataSize);
+    CheckVulkanResult(vkGetPipelineCacheData(LogicalDevice, Cache, &DataSize, std::data(Data)));
+
+    std::filesystem::path const FilePath { std::data(Path) };
+    std::filesystem::create_directories(FilePath.parent_path());
+
+    if (std::ofstream File(FilePath, std::ios::binary | std::ios::trunc);
+        File.is_open())
+    {
+        File.write(std::data(Data), static_cast<std::streamsize>(DataSize));
+    }
+}
+
+bool IsPipelineCacheCompatible(std::vector<char> const &Data)
+{
+    if (std::size(Data) < sizeof(VkPipelineCacheHeaderVersionOne))
+    {
+        return false;
+    }
+
+    VkPipelineCacheHeaderVersionOne Header {};
+    std::copy_n(std::data(Data), sizeof(VkPipelineCacheHeaderVersionOne), reinterpret_cast<char *>(&Header));
+
+    VkPhysicalDeviceProperties DeviceProperties {};
+    vkGetPhysicalDeviceProperties(GetPhysicalDevice(), &DeviceProperties);
+
+    return Header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && Header.vendorID == DeviceProperties.vendorID && Header.deviceID ==
+           DeviceProperties.deviceID && std::ranges::equal(Header.pipelineCacheUUID, DeviceProperties.pipelineCacheUUID);
+}
+
+void CreatePipelineCache(VkDevice const &LogicalDevice, std::vector<char> &InitialData, VkPipelineCache &Cache)
+{
+    VkPipelineCacheCreateInfo CacheCreateInfo = g_PipelineCacheCreateInfo;
+
+    if (IsPipelineCacheCompatible(InitialData))
+    {
+        CacheCreateInfo.initialDataSize = std::size(InitialData);
+        CacheCreateInfo.pInitialData    = std::data(InitialData);
+    }
+
+    CheckVulkanResult(vkCreatePipelineCache(LogicalDevice, &CacheCreateInfo, GetAllocationCallbacks(HostAllocationTag::Pipeline), &Cache));
+
+    InitialData.clear();
+    InitialData.shrink_to_fit();
+}
+
 void PipelineData::DestroyResources(VkDevice const &LogicalDevice, bool const IncludeStatic)
 {
     if (MainPipeline != VK_NULL_HANDLE)
     {
-        vkDestroyPipeline(LogicalDevice, MainPipeline, nullptr);
+        vkDestroyPipeline(LogicalDevice, MainPipeline, GetAllocationCallbacks(HostAllocationTag::Pipeline));
         MainPipeline = VK_NULL_HANDLE;
     }
 
     if (FragmentShaderPipeline != VK_NULL_HANDLE)
     {
-        vkDestroyPipeline(LogicalDevice, FragmentShaderPipeline, nullptr);
+        vkDestroyPipeline(LogicalDevice, FragmentShaderPipeline, GetAllocationCallbacks(HostAllocationTag::Pipeline));
         FragmentShaderPipeline = VK_NULL_HANDLE;
     }
 
+    // The visibility pipelines only exist while the mode is enabled, so they're rebuilt with the dynamic ones
+    for (VkPipeline *const VisibilityIt : { &VisibilityPipeline,
+                                            &VisibilityFragmentShaderPipeline,
+                                            &VisibilityFragmentOutputPipeline,
+                                            &VisibilityResolvePipeline })
+    {
+        if (*VisibilityIt != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(LogicalDevice, *VisibilityIt, GetAllocationCallbacks(HostAllocationTag::Pipeline));
+            *VisibilityIt = VK_NULL_HANDLE;
+        }
+    }
+
     if (!IncludeStatic)
     {
         return;
     }
 
+    if (LightCullingPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(LogicalDevice, LightCullingPipeline, GetAllocationCallbacks(HostAllocationTag::Pipeline));
+        LightCullingPipeline = VK_NULL_HANDLE;
+    }
+
+    if (SkinningPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(LogicalDevice, SkinningPipeline, GetAllocationCallbacks(HostAllocationTag::Pipeline));
+        SkinningPipeline = VK_NULL_HANDLE;
+    }
+
     if (VertexInputPipeline != VK_NULL_HANDLE)
     {
-        vkDestroyPipeline(LogicalDevice, VertexInputPipeline, nullptr);
+        vkDestroyPipeline(LogicalDevice, VertexInputPipeline, GetAllocationCallbacks(HostAllocationTag::Pipeline));
         VertexInputPipeline = VK_NULL_HANDLE;
     }
 
     if (PreRasterizationPipeline != VK_NULL_HANDLE)
     {
-        vkDestroyPipeline(LogicalDevice, PreRasterizationPipeline, nullptr);
+        vkDestroyPipeline(LogicalDevice, PreRasterizationPipeline, GetAllocationCallbacks(HostAllocationTag::Pipeline));
         PreRasterizationPipeline = VK_NULL_HANDLE;
     }
 
     if (FragmentOutputPipeline != VK_NULL_HANDLE)
     {
-        vkDestroyPipeline(LogicalDevice, FragmentOutputPipeline, nullptr);
+        vkDestroyPipeline(LogicalDevice, FragmentOutputPipeline, GetAllocationCallbacks(HostAllocationTag::Pipeline));
         FragmentOutputPipeline = VK_NULL_HANDLE;
     }
 
     if (PipelineLayout != VK_NULL_HANDLE)
     {
-        vkDestroyPipelineLayout(LogicalDevice, PipelineLayout, nullptr);
+        vkDestroyPipelineLayout(LogicalDevice, PipelineLayout, GetAllocationCallbacks(HostAllocationTag::Pipeline));
         PipelineLayout = VK_NULL_HANDLE;
     }
 
+    if (VisibilityResolveLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(LogicalDevice, VisibilityResolveLayout, GetAllocationCallbacks(HostAllocationTag::Pipeline));
+        VisibilityResolveLayout = VK_NULL_HANDLE;
+    }
+
+    if (SkinningLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(LogicalDevice, SkinningLayout, GetAllocationCallbacks(HostAllocationTag::Pipeline));
+        SkinningLayout = VK_NULL_HANDLE;
+    }
+
     if (PipelineCache != VK_NULL_HANDLE)
     {
-        vkDestroyPipelineCache(LogicalDevice, PipelineCache, nullptr);
+        vkDestroyPipelineCache(LogicalDevice, PipelineCache, GetAllocationCallbacks(HostAllocationTag::Pipeline));
         PipelineCache = VK_NULL_HANDLE;
     }
 
     if (PipelineLibraryCache != VK_NULL_HANDLE)
     {
-        vkDestroyPipelineCache(LogicalDevice, PipelineLibraryCache, nullptr);
+        vkDestroyPipelineCache(LogicalDevice, PipelineLibraryCache, GetAllocationCallbacks(HostAllocationTag::Pipeline));
         PipelineLibraryCache = VK_NULL_HANDLE;
     }
 }
@@ -109,7 +240,7 @@ void PipelineData::CreateMainCache(VkDevice const &LogicalDevice)
 {
     if (g_PipelineData.PipelineCache == VK_NULL_HANDLE)
     {
-        CheckVulkanResult(vkCreatePipelineCache(LogicalDevice, &g_PipelineCacheCreateInfo, nullptr, &PipelineCache));
+        CreatePipelineCache(LogicalDevice, g_PipelineCacheData, PipelineCache);
     }
 }
 
@@ -117,7 +248,7 @@ void PipelineData::CreateLibraryCache(VkDevice const &LogicalDevice)
 {
     if (g_PipelineData.PipelineLibraryCache == VK_NULL_HANDLE)
     {
-        CheckVulkanResult(vkCreatePipelineCache(LogicalDevice, &g_PipelineCacheCreateInfo, nullptr, &PipelineLibraryCache));
+        CreatePipelineCache(LogicalDevice, g_PipelineLibraryCacheData, PipelineLibraryCache);
     }
 }
 
@@ -126,6 +257,8 @@ void PipelineDescriptorData::DestroyResources(VmaAllocator const &Allocator, boo
     SceneData.DestroyResources(Allocator, IncludeStatic);
     ModelData.DestroyResources(Allocator, IncludeStatic);
     TextureData.DestroyResources(Allocator, IncludeStatic);
+    VisibilityData.DestroyResources(Allocator, IncludeStatic);
+    MaterialData.DestroyResources(Allocator, IncludeStatic);
 }
 
 void PipelineDescriptorData::SetDescriptorLayoutSize()
@@ -136,9 +269,17 @@ void PipelineDescriptorData::SetDescriptorLayoutSize()
     SceneData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment);
     ModelData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment);
     TextureData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment);
+    VisibilityData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment);
+
+    if (MaterialData.SetLayout != VK_NULL_HANDLE)
+    {
+        MaterialData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment);
+    }
 }
 
-void PipelineDescriptorData::SetupSceneBuffer(BufferAllocation const &SceneAllocation)
+void PipelineDescriptorData::SetupSceneBuffer(BufferAllocation const &SceneAllocation,
+                                              BufferAllocation const &PointLightAllocation,
+                                              BufferAllocation const &ClusterAllocation)
 {
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
@@ -184,6 +325,40 @@ void PipelineDescriptorData::SetupSceneBuffer(BufferAllocation const &SceneAlloc
                            g_DescriptorBufferProperties.uniformBufferDescriptorSize,
                            static_cast<unsigned char *>(SceneData.Buffer.MappedData) + SceneData.LayoutOffset);
     }
+
+    // The clustered light buffers live in the scene set, after the uniform buffer
+    std::array const StorageAllocations { &PointLightAllocation, &ClusterAllocation };
+
+    for (std::uint32_t Binding = 1U; Binding <= std::size(StorageAllocations); ++Binding)
+    {
+        BufferAllocation const &Allocation = *StorageAllocations.at(Binding - 1U);
+
+        VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .buffer = Allocation.Buffer
+        };
+
+        VkDescriptorAddressInfoEXT const StorageDescriptorAddressInfo {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                .address = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo),
+                .range = Allocation.Size,
+                .format = VK_FORMAT_UNDEFINED
+        };
+
+        VkDescriptorGetInfoEXT const StorageDescriptorInfo {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .data = VkDescriptorDataEXT { .pStorageBuffer = &StorageDescriptorAddressInfo }
+        };
+
+        VkDeviceSize BindingOffset { 0U };
+        vkGetDescriptorSetLayoutBindingOffsetEXT(LogicalDevice, SceneData.SetLayout, Binding, &BindingOffset);
+
+        vkGetDescriptorEXT(LogicalDevice,
+                           &StorageDescriptorInfo,
+                           g_DescriptorBufferProperties.storageBufferDescriptorSize,
+                           static_cast<unsigned char *>(SceneData.Buffer.MappedData) + BindingOffset);
+    }
 }
 
 void PipelineDescriptorData::SetupModelsBuffer(std::vector<std::shared_ptr<Object>> const &Objects)
@@ -232,21 +407,48 @@ void PipelineDescriptorData::SetupModelsBuffer(std::vector<std::shared_ptr<Objec
         TextureData.BufferDeviceAddress.deviceAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
     }
 
-    auto const ModelBuffer   = static_cast<unsigned char *>(ModelData.Buffer.MappedData);
-    auto const TextureBuffer = static_cast<unsigned char *>(TextureData.Buffer.MappedData);
-
-    std::uint32_t ObjectCount = 0U;
-
     VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
             .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
             .buffer = GetAllocationBuffer()
     };
 
+    WriteModelsDescriptors(Objects, vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo), GetAllocationImageDescriptor(0U));
+}
+
+// The texture of the object bound to the given type, or the empty image when the mesh has none
+VkDescriptorImageInfo const &GetTextureDescriptor(Object const &ObjectIt, std::uint8_t const Type, VkDescriptorImageInfo const &EmptyImageDescriptor)
+{
+    auto const &Textures        = ObjectIt.GetMesh()->GetTextures();
+    auto const  MatchingTexture = std::ranges::find_if(Textures,
+                                                       [Type](std::shared_ptr<Texture> const &Texture)
+                                                       {
+                                                           auto const Types = Texture->GetTypes();
+                                                           return std::ranges::find_if(Types,
+                                                                                       [Type](TextureType const &TextureType)
+                                                                                       {
+                                                                                           return static_cast<std::uint8_t>(TextureType) == Type;
+                                                                                       }) != std::end(Types);
+                                                       });
+
+    return MatchingTexture != std::cend(Textures) ? (*MatchingTexture)->GetImageDescriptor() : EmptyImageDescriptor;
+}
+
+void PipelineDescriptorData::WriteModelsDescriptors(std::vector<std::shared_ptr<Object>> const &Objects,
+                                                    VkDeviceAddress const                       ModelUniformAddress,
+                                                    VkDescriptorImageInfo const &               EmptyImageDescriptor) const
+{
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    constexpr std::uint8_t NumTextures = static_cast<std::uint8_t>(TextureType::Count);
+
+    auto const ModelBuffer   = static_cast<unsigned char *>(ModelData.Buffer.MappedData);
+    auto const TextureBuffer = static_cast<unsigned char *>(TextureData.Buffer.MappedData);
+
+    std::uint32_t ObjectCount = 0U;
+
     for (std::shared_ptr<Object> const &ObjectIter : Objects)
     {
         {
-            VkDeviceSize const ModelUniformAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
-
             VkDescriptorAddressInfoEXT ModelDescriptorAddressInfo {
                     .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
                     .address = ModelUniformAddress + ObjectIter->GetUniformOffset(),
@@ -267,25 +469,11 @@ void PipelineDescriptorData::SetupModelsBuffer(std::vector<std::shared_ptr<Objec
                                ModelBuffer + BufferOffset);
         }
 
-        auto const &  Textures     = ObjectIter->GetMesh()->GetTextures();
         std::uint32_t TextureCount = 0U;
 
         for (std::uint8_t TypeIter = 0U; TypeIter < NumTextures; ++TypeIter)
         {
-            auto MatchingTexture = std::ranges::find_if(Textures,
-                                                        [TypeIter](std::shared_ptr<Texture> const &Texture)
-                                                        {
-                                                            auto const Types = Texture->GetTypes();
-                                                            return std::ranges::find_if(Types,
-                                                                                        [TypeIter](TextureType const &TextureType)
-                                                                                        {
-                                                                                            return static_cast<std::uint8_t>(TextureType) == TypeIter;
-                                                                                        }) != std::end(Types);
-                                                        });
-
-            auto const &ImageDescriptor = MatchingTexture != std::cend(Textures)
-                                              ? (*MatchingTexture)->GetImageDescriptor()
-                                              : GetAllocationImageDescriptor(0U);
+            VkDescriptorImageInfo const &ImageDescriptor = GetTextureDescriptor(*ObjectIter, TypeIter, EmptyImageDescriptor);
 
             VkDescriptorGetInfoEXT const TextureDescriptorInfo {
                     .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
@@ -307,6 +495,118 @@ void PipelineDescriptorData::SetupModelsBuffer(std::vector<std::shared_ptr<Objec
     }
 }
 
+void PipelineDescriptorData::SetupVisibilityBuffer(std::vector<std::shared_ptr<Object>> const &Objects)
+{
+    VkDevice const &    LogicalDevice = GetLogicalDevice();
+    VmaAllocator const &Allocator     = GetAllocator();
+
+    {
+        constexpr VkBufferUsageFlags BufferUsage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+        // One set per swap chain image: the descriptors are rewritten while recording, and the images behind them are transient
+        VisibilityData.Buffer.Size = g_ImageCount * VisibilityData.LayoutSize;
+        CreateBuffer(VisibilityData.Buffer.Size, BufferUsage, "Visibility Descriptor Buffer", VisibilityData.Buffer.Buffer, VisibilityData.Buffer.Allocation);
+        vmaMapMemory(Allocator, VisibilityData.Buffer.Allocation, &VisibilityData.Buffer.MappedData);
+
+        VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .buffer = VisibilityData.Buffer.Buffer
+        };
+
+        VisibilityData.BufferDeviceAddress.deviceAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
+    }
+
+    constexpr std::uint8_t NumTextures = static_cast<std::uint8_t>(TextureType::Count);
+    auto const             NumMaps     = static_cast<std::uint32_t>(std::size(Objects)) * NumTextures;
+
+    if (std::empty(Objects))
+    {
+        return;
+    }
+
+    // Without the material maps the resolve isn't active, and the scene is drawn by the forward path
+    if (NumMaps > g_MaxVisibilityMaterialMaps)
+    {
+        RENDERCORE_LOG(warning, "Visibility buffer disabled: {} material maps for a limit of {}", NumMaps, g_MaxVisibilityMaterialMaps);
+        return;
+    }
+
+    {
+        constexpr VkBufferUsageFlags BufferUsage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                                                   VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+        // Variable sized binding: only the maps of the loaded objects are allocated, not the size of the whole layout
+        MaterialData.Buffer.Size = MaterialData.LayoutOffset + NumMaps * g_DescriptorBufferProperties.combinedImageSamplerDescriptorSize;
+        CreateBuffer(MaterialData.Buffer.Size, BufferUsage, "Material Descriptor Buffer", MaterialData.Buffer.Buffer, MaterialData.Buffer.Allocation);
+        vmaMapMemory(Allocator, MaterialData.Buffer.Allocation, &MaterialData.Buffer.MappedData);
+
+        VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .buffer = MaterialData.Buffer.Buffer
+        };
+
+        MaterialData.BufferDeviceAddress.deviceAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
+    }
+
+    // The same maps the forward path binds per object, laid out in the order of the scene list to be indexed by the object of each pixel
+    VkDescriptorImageInfo const &EmptyImageDescriptor = GetAllocationImageDescriptor(0U);
+    auto const                   MaterialBuffer       = static_cast<unsigned char *>(MaterialData.Buffer.MappedData);
+
+    for (std::uint32_t ObjectIndex = 0U; ObjectIndex < std::size(Objects); ++ObjectIndex)
+    {
+        for (std::uint8_t TypeIter = 0U; TypeIter < NumTextures; ++TypeIter)
+        {
+            VkDescriptorImageInfo const &ImageDescriptor = GetTextureDescriptor(*Objects.at(ObjectIndex), TypeIter, EmptyImageDescriptor);
+
+            VkDescriptorGetInfoEXT const TextureDescriptorInfo {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                    .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                    .data = VkDescriptorDataEXT { .pCombinedImageSampler = &ImageDescriptor }
+            };
+
+            VkDeviceSize const BufferOffset = MaterialData.LayoutOffset +
+                                              (ObjectIndex * NumTextures + TypeIter) * g_DescriptorBufferProperties.combinedImageSamplerDescriptorSize;
+
+            vkGetDescriptorEXT(LogicalDevice,
+                               &TextureDescriptorInfo,
+                               g_DescriptorBufferProperties.combinedImageSamplerDescriptorSize,
+                               MaterialBuffer + BufferOffset);
+        }
+    }
+}
+
+void PipelineDescriptorData::WriteVisibilityDescriptors(std::uint32_t const ImageIndex,
+                                                        VkImageView const & VisibilityView,
+                                                        VkImageView const & ColorView) const
+{
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    std::array const Views { VisibilityView, ColorView };
+
+    for (std::uint32_t Binding = 0U; Binding < std::size(Views); ++Binding)
+    {
+        VkDescriptorImageInfo const ImageInfo {
+                .sampler = VK_NULL_HANDLE,
+                .imageView = Views.at(Binding),
+                .imageLayout = VK_IMAGE_LAYOUT_GENERAL
+        };
+
+        VkDescriptorGetInfoEXT const StorageDescriptorInfo {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                .data = VkDescriptorDataEXT { .pStorageImage = &ImageInfo }
+        };
+
+        VkDeviceSize BindingOffset { 0U };
+        vkGetDescriptorSetLayoutBindingOffsetEXT(LogicalDevice, VisibilityData.SetLayout, Binding, &BindingOffset);
+
+        vkGetDescriptorEXT(LogicalDevice,
+                           &StorageDescriptorInfo,
+                           g_DescriptorBufferProperties.storageImageDescriptorSize,
+                           static_cast<unsigned char *>(VisibilityData.Buffer.MappedData) + ImageIndex * VisibilityData.LayoutSize + BindingOffset);
+    }
+}
+
 void RenderCore::CreatePipelineDynamicResources()
 {
     std::vector<VkPipelineShaderStageCreateInfo> ShaderStagesInfo {};
@@ -329,7 +629,7 @@ void RenderCore::CreatePipelineDynamicResources()
     CreateMainPipeline(g_PipelineData, ShaderStagesInfo, VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, g_DepthStencilState, g_MultisampleState);
 }
 
-void RenderCore::CreatePipelineLibraries()
+void RenderCore::CreatePipelineLibraries(SurfaceProperties const &SurfaceProperties)
 {
     std::vector<VkPipelineShaderStageCreateInfo> ShaderStagesInfo {};
     std::vector<VkShaderModuleCreateInfo>        ShaderModuleInfo {};
@@ -386,29 +686,48 @@ void RenderCore::CreatePipelineLibraries()
                                                                  VertexAttributes::Color,
                                                                  VertexAttributes::Tangent,
                                                          }),
-            .ShaderStages = ShaderStagesInfo
+            .ShaderStages = ShaderStagesInfo,
+            .ColorFormat = SurfaceProperties.Format.format,
+            .DepthFormat = SurfaceProperties.DepthFormat
     };
 
     CreatePipelineLibraries(g_PipelineData, Arguments, VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, true);
 }
 
-void CreateDescriptorSetLayout(VkDescriptorSetLayoutBinding const &Binding, std::uint32_t const Bindings, VkDescriptorSetLayout &DescriptorSetLayout)
+void CreateDescriptorSetLayout(std::span<VkDescriptorSetLayoutBinding const> const LayoutBindings,
+                               VkDescriptorSetLayout &                            DescriptorSetLayout,
+                               std::span<VkDescriptorBindingFlags const> const    BindingFlags = {})
 {
-    std::vector LayoutBindings(Bindings, Binding);
-    for (std::uint32_t Index = 0U; Index < Bindings; ++Index)
-    {
-        LayoutBindings.at(Index).binding = Index;
-    }
+    VkDescriptorSetLayoutBindingFlagsCreateInfo const BindingFlagsInfo {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .bindingCount = static_cast<std::uint32_t>(std::size(BindingFlags)),
+            .pBindingFlags = std::data(BindingFlags)
+    };
 
     VkDescriptorSetLayoutCreateInfo const DescriptorSetLayoutInfo {
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = std::empty(BindingFlags) ? nullptr : &BindingFlagsInfo,
             .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
             .bindingCount = static_cast<std::uint32_t>(std::size(LayoutBindings)),
             .pBindings = std::data(LayoutBindings)
     };
 
     VkDevice const &LogicalDevice = GetLogicalDevice();
-    CheckVulkanResult(vkCreateDescriptorSetLayout(LogicalDevice, &DescriptorSetLayoutInfo, nullptr, &DescriptorSetLayout));
+    CheckVulkanResult(vkCreateDescriptorSetLayout(LogicalDevice,
+                                                  &DescriptorSetLayoutInfo,
+                                                  GetAllocationCallbacks(HostAllocationTag::Descriptors),
+                                                  &DescriptorSetLayout));
+}
+
+void CreateDescriptorSetLayout(VkDescriptorSetLayoutBinding const &Binding, std::uint32_t const Bindings, VkDescriptorSetLayout &DescriptorSetLayout)
+{
+    std::vector LayoutBindings(Bindings, Binding);
+    for (std::uint32_t Index = 0U; Index < Bindings; ++Index)
+    {
+        LayoutBindings.at(Index).binding = Index;
+    }
+
+    CreateDescriptorSetLayout(LayoutBindings, DescriptorSetLayout);
 }
 
 void RenderCore::SetupPipelineLayouts()
@@ -432,27 +751,365 @@ void RenderCore::SetupPipelineLayouts()
             }
     };
 
-    CreateDescriptorSetLayout(LayoutBindings.at(0U), 1U, g_DescriptorData.SceneData.SetLayout);
+    // Scene uniforms, then the clustered point lights and their per cluster lists, also read by the light culling
+    constexpr std::array SceneLayoutBindings {
+            VkDescriptorSetLayoutBinding
+            {
+                    .binding = 0U,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                    .descriptorCount = 1U,
+                    .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT,
+                    .pImmutableSamplers = nullptr
+            },
+            VkDescriptorSetLayoutBinding
+            {
+                    .binding = 1U,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .descriptorCount = 1U,
+                    .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT,
+                    .pImmutableSamplers = nullptr
+            },
+            VkDescriptorSetLayoutBinding
+            {
+                    .binding = 2U,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .descriptorCount = 1U,
+                    .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT,
+                    .pImmutableSamplers = nullptr
+            }
+    };
+
+    CreateDescriptorSetLayout(SceneLayoutBindings, g_DescriptorData.SceneData.SetLayout);
     CreateDescriptorSetLayout(LayoutBindings.at(0U), 1U, g_DescriptorData.ModelData.SetLayout);
     CreateDescriptorSetLayout(LayoutBindings.at(1U), 5U, g_DescriptorData.TextureData.SetLayout);
 
+    // The visibility buffer and the color it's resolved to, both written and read by the resolve only
+    constexpr std::array VisibilityLayoutBindings {
+            VkDescriptorSetLayoutBinding
+            {
+                    .binding = 0U,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                    .descriptorCount = 1U,
+                    .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                    .pImmutableSamplers = nullptr
+            },
+            VkDescriptorSetLayoutBinding
+            {
+                    .binding = 1U,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                    .descriptorCount = 1U,
+                    .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                    .pImmutableSamplers = nullptr
+            }
+    };
+
+    CreateDescriptorSetLayout(VisibilityLayoutBindings, g_DescriptorData.VisibilityData.SetLayout);
+
+    if (IsVisibilityBufferSupported())
+    {
+        // Every material map of the scene, indexed by the object of each pixel in the resolve
+        constexpr VkDescriptorSetLayoutBinding MaterialLayoutBinding {
+                .binding = 0U,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .descriptorCount = g_MaxVisibilityMaterialMaps,
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .pImmutableSamplers = nullptr
+        };
+
+        constexpr VkDescriptorBindingFlags MaterialBindingFlags = VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+
+        CreateDescriptorSetLayout(std::span { &MaterialLayoutBinding, 1U },
+                                  g_DescriptorData.MaterialData.SetLayout,
+                                  std::span { &MaterialBindingFlags, 1U });
+    }
+
     std::array const DescriptorLayouts {
             g_DescriptorData.SceneData.SetLayout,
             g_DescriptorData.ModelData.SetLayout,
             g_DescriptorData.TextureData.SetLayout
     };
 
+    // The object index written by the visibility pass; the default fragment shader doesn't declare it
+    constexpr VkPushConstantRange ObjectIndexRange {
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .offset = 0U,
+            .size = sizeof(std::uint32_t)
+    };
+
     VkPipelineLayoutCreateInfo const PipelineLayoutCreateInfo {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
             .setLayoutCount = static_cast<std::uint32_t>(std::size(DescriptorLayouts)),
-            .pSetLayouts = std::data(DescriptorLayouts)
+            .pSetLayouts = std::data(DescriptorLayouts),
+            .pushConstantRangeCount = 1U,
+            .pPushConstantRanges = &ObjectIndexRange
     };
 
     VkDevice const &LogicalDevice = GetLogicalDevice();
-    CheckVulkanResult(vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutCreateInfo, nullptr, &g_PipelineData.PipelineLayout));
+    CheckVulkanResult(vkCreatePipelineLayout(LogicalDevice,
+                                             &PipelineLayoutCreateInfo,
+                                             GetAllocationCallbacks(HostAllocationTag::Pipeline),
+                                             &g_PipelineData.PipelineLayout));
+
+    // Only built when the device can index the material maps, as the resolve reads them
+    if (IsVisibilityBufferSupported())
+    {
+        std::array const VisibilityResolveLayouts {
+                g_DescriptorData.SceneData.SetLayout,
+                g_DescriptorData.VisibilityData.SetLayout,
+                g_DescriptorData.MaterialData.SetLayout
+        };
+
+        constexpr VkPushConstantRange ResolveConstantsRange {
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .offset = 0U,
+                .size = sizeof(VisibilityResolveConstants)
+        };
+
+        VkPipelineLayoutCreateInfo const VisibilityResolveLayoutCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .setLayoutCount = static_cast<std::uint32_t>(std::size(VisibilityResolveLayouts)),
+                .pSetLayouts = std::data(VisibilityResolveLayouts),
+                .pushConstantRangeCount = 1U,
+                .pPushConstantRanges = &ResolveConstantsRange
+        };
+
+        CheckVulkanResult(vkCreatePipelineLayout(LogicalDevice,
+                                                 &VisibilityResolveLayoutCreateInfo,
+                                                 GetAllocationCallbacks(HostAllocationTag::Pipeline),
+                                                 &g_PipelineData.VisibilityResolveLayout));
+    }
+
+    // Everything the skinning reads and writes is addressed from the push constants
+    constexpr VkPushConstantRange SkinningConstantsRange {
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0U,
+            .size = sizeof(SkinningConstants)
+    };
+
+    VkPipelineLayoutCreateInfo const SkinningLayoutCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 0U,
+            .pSetLayouts = nullptr,
+            .pushConstantRangeCount = 1U,
+            .pPushConstantRanges = &SkinningConstantsRange
+    };
+
+    CheckVulkanResult(vkCreatePipelineLayout(LogicalDevice,
+                                             &SkinningLayoutCreateInfo,
+                                             GetAllocationCallbacks(HostAllocationTag::Pipeline),
+                                             &g_PipelineData.SkinningLayout));
+
     g_DescriptorData.SetDescriptorLayoutSize();
 }
 
+ShaderStageData const *FindShaderStage(std::vector<ShaderStageData> const &StageData, VkShaderStageFlagBits const Stage)
+{
+    auto const MatchingStage = std::ranges::find_if(StageData,
+                                                    [Stage](ShaderStageData const &StageIt)
+                                                    {
+                                                        return StageIt.StageInfo.stage == Stage;
+                                                    });
+
+    return MatchingStage != std::cend(StageData) && !std::empty(MatchingStage->ShaderCode) ? &*MatchingStage : nullptr;
+}
+
+void CreateComputePipeline(ShaderStageData const &ComputeStage, VkPipelineLayout const &Layout, VkPipeline &Pipeline)
+{
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+    g_PipelineData.CreateMainCache(LogicalDevice);
+
+    VkShaderModuleCreateInfo const ShaderModuleInfo {
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .codeSize = std::size(ComputeStage.ShaderCode) * sizeof(std::uint32_t),
+            .pCode = std::data(ComputeStage.ShaderCode)
+    };
+
+    VkPipelineShaderStageCreateInfo StageInfo = ComputeStage.StageInfo;
+    StageInfo.pNext                           = &ShaderModuleInfo;
+
+    VkComputePipelineCreateInfo const ComputePipelineCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+            .stage = StageInfo,
+            .layout = Layout
+    };
+
+    CheckVulkanResult(vkCreateComputePipelines(LogicalDevice,
+                                               g_PipelineData.PipelineCache,
+                                               1U,
+                                               &ComputePipelineCreateInfo,
+                                               GetAllocationCallbacks(HostAllocationTag::Pipeline),
+                                               &Pipeline));
+}
+
+// The culling is optional: without a compute stage, the clusters are binned on the host
+void RenderCore::CreateLightCullingPipeline()
+{
+    ShaderStageData const *const ComputeStage = FindShaderStage(GetStageData(), VK_SHADER_STAGE_COMPUTE_BIT);
+
+    if (ComputeStage == nullptr)
+    {
+        return;
+    }
+
+    RENDERCORE_PROFILE_SCOPE("Light Culling Pipeline");
+
+    CreateComputePipeline(*ComputeStage, g_PipelineData.PipelineLayout, g_PipelineData.LightCullingPipeline);
+}
+
+// Without it, skinned objects are drawn in their bind pose
+void RenderCore::CreateSkinningPipeline()
+{
+    ShaderStageData const *const ComputeStage = FindShaderStage(GetSkinningStageData(), VK_SHADER_STAGE_COMPUTE_BIT);
+
+    if (ComputeStage == nullptr)
+    {
+        return;
+    }
+
+    RENDERCORE_PROFILE_SCOPE("Skinning Pipeline");
+
+    CreateComputePipeline(*ComputeStage, g_PipelineData.SkinningLayout, g_PipelineData.SkinningPipeline);
+}
+
+// Linked from the vertex input and pre rasterization libraries of the main pipeline, so both passes rasterize the same triangles
+void RenderCore::CreateVisibilityPipelines()
+{
+    auto const &                 StageData     = GetVisibilityStageData();
+    ShaderStageData const *const FragmentStage = FindShaderStage(StageData, VK_SHADER_STAGE_FRAGMENT_BIT);
+    ShaderStageData const *const ComputeStage  = FindShaderStage(StageData, VK_SHADER_STAGE_COMPUTE_BIT);
+
+    if (FragmentStage == nullptr || ComputeStage == nullptr || !IsVisibilityBufferSupported())
+    {
+        return;
+    }
+
+    RENDERCORE_PROFILE_SCOPE("Visibility Pipelines");
+
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+    g_PipelineData.CreateMainCache(LogicalDevice);
+    g_PipelineData.CreateLibraryCache(LogicalDevice);
+
+    VkFormat const DepthFormat = GetDepthImage().Format;
+
+    VkPipelineRenderingCreateInfo const RenderingCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+            .colorAttachmentCount = 1U,
+            .pColorAttachmentFormats = &g_VisibilityFormat,
+            .depthAttachmentFormat = DepthFormat,
+            .stencilAttachmentFormat = DepthFormat
+    };
+
+    // Fragment output library
+    {
+        VkGraphicsPipelineLibraryCreateInfoEXT FragmentOutputLibrary {
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+                .pNext = &RenderingCreateInfo,
+                .flags = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+        };
+
+        // Integer attachments can't be blended
+        constexpr VkPipelineColorBlendAttachmentState ColorBlendAttachment {
+                .blendEnable = VK_FALSE,
+                .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+        };
+
+        VkPipelineColorBlendStateCreateInfo const ColorBlendState {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+                .logicOpEnable = VK_FALSE,
+                .logicOp = VK_LOGIC_OP_COPY,
+                .attachmentCount = 1U,
+                .pAttachments = &ColorBlendAttachment,
+                .blendConstants = { 0.F, 0.F, 0.F, 0.F }
+        };
+
+        VkGraphicsPipelineCreateInfo const FragmentOutputCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                .pNext = &FragmentOutputLibrary,
+                .flags = g_PipelineFlags | VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+                .pMultisampleState = &g_MultisampleState,
+                .pColorBlendState = &ColorBlendState,
+                .layout = g_PipelineData.PipelineLayout
+        };
+
+        CheckVulkanResult(vkCreateGraphicsPipelines(LogicalDevice,
+                                                    g_PipelineData.PipelineLibraryCache,
+                                                    1U,
+                                                    &FragmentOutputCreateInfo,
+                                                    GetAllocationCallbacks(HostAllocationTag::Pipeline),
+                                                    &g_PipelineData.VisibilityFragmentOutputPipeline));
+    }
+
+    // Fragment shader library
+    {
+        VkShaderModuleCreateInfo const ShaderModuleInfo {
+                .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+                .codeSize = std::size(FragmentStage->ShaderCode) * sizeof(std::uint32_t),
+                .pCode = std::data(FragmentStage->ShaderCode)
+        };
+
+        VkPipelineShaderStageCreateInfo StageInfo = FragmentStage->StageInfo;
+        StageInfo.pNext                           = &ShaderModuleInfo;
+
+        VkGraphicsPipelineLibraryCreateInfoEXT FragmentLibrary {
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+                .pNext = &RenderingCreateInfo,
+                .flags = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT
+        };
+
+        VkGraphicsPipelineCreateInfo const FragmentShaderPipelineCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                .pNext = &FragmentLibrary,
+                .flags = g_PipelineFlags | VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+                .stageCount = 1U,
+                .pStages = &StageInfo,
+                .pMultisampleState = &g_MultisampleState,
+                .pDepthStencilState = &g_DepthStencilState,
+                .layout = g_PipelineData.PipelineLayout
+        };
+
+        CheckVulkanResult(vkCreateGraphicsPipelines(LogicalDevice,
+                                                    g_PipelineData.PipelineCache,
+                                                    1U,
+                                                    &FragmentShaderPipelineCreateInfo,
+                                                    GetAllocationCallbacks(HostAllocationTag::Pipeline),
+                                                    &g_PipelineData.VisibilityFragmentShaderPipeline));
+    }
+
+    // Visibility pipeline
+    {
+        std::vector const Libraries {
+                g_PipelineData.VertexInputPipeline,
+                g_PipelineData.PreRasterizationPipeline,
+                g_PipelineData.VisibilityFragmentOutputPipeline,
+                g_PipelineData.VisibilityFragmentShaderPipeline
+        };
+
+        VkPipelineLibraryCreateInfoKHR PipelineLibraryCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+                .pNext = &RenderingCreateInfo,
+                .libraryCount = static_cast<std::uint32_t>(std::size(Libraries)),
+                .pLibraries = std::data(Libraries)
+        };
+
+        VkGraphicsPipelineCreateInfo const GraphicsPipelineCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                .pNext = &PipelineLibraryCreateInfo,
+                .flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+                .layout = g_PipelineData.PipelineLayout
+        };
+
+        CheckVulkanResult(vkCreateGraphicsPipelines(LogicalDevice,
+                                                    g_PipelineData.PipelineCache,
+                                                    1U,
+                                                    &GraphicsPipelineCreateInfo,
+                                                    GetAllocationCallbacks(HostAllocationTag::Pipeline),
+                                                    &g_PipelineData.VisibilityPipeline));
+    }
+
+    CreateComputePipeline(*ComputeStage, g_PipelineData.VisibilityResolveLayout, g_PipelineData.VisibilityResolvePipeline);
+}
+
 void RenderCore::ReleasePipelineResources(bool const IncludeStatic)
 {
     if (g_PipelineData.IsValid())
@@ -465,11 +1122,25 @@ void RenderCore::ReleasePipelineResources(bool const IncludeStatic)
     g_DescriptorData.DestroyResources(Allocator, IncludeStatic);
 }
 
+void RenderCore::LoadPipelineCacheData()
+{
+    g_PipelineCacheData        = ReadPipelineCacheFile(g_PipelineCachePath);
+    g_PipelineLibraryCacheData = ReadPipelineCacheFile(g_PipelineLibraryCachePath);
+}
+
+void RenderCore::SavePipelineCacheData()
+{
+    WritePipelineCacheFile(g_PipelineCachePath, g_PipelineData.PipelineCache);
+    WritePipelineCacheFile(g_PipelineLibraryCachePath, g_PipelineData.PipelineLibraryCache);
+}
+
 void RenderCore::CreatePipelineLibraries(PipelineData &                          Data,
                                          PipelineLibraryCreationArguments const &Arguments,
                                          VkPipelineCreateFlags const             Flags,
                                          bool const                              EnableDepth)
 {
+    RENDERCORE_PROFILE_SCOPE("Pipeline Libraries");
+
     VkDevice const &LogicalDevice = GetLogicalDevice();
     Data.CreateLibraryCache(LogicalDevice);
 
@@ -506,7 +1177,7 @@ void RenderCore::CreatePipelineLibraries(PipelineData &
                                                     Data.PipelineLibraryCache,
                                                     1U,
                                                     &VertexInputCreateInfo,
-                                                    nullptr,
+                                                    GetAllocationCallbacks(HostAllocationTag::Pipeline),
                                                     &Data.VertexInputPipeline));
     }
 
@@ -545,20 +1216,25 @@ void RenderCore::CreatePipelineLibraries(PipelineData &
                                                     Data.PipelineLibraryCache,
                                                     1U,
                                                     &PreRasterizationInfo,
-                                                    nullptr,
+                                                    GetAllocationCallbacks(HostAllocationTag::Pipeline),
                                                     &Data.PreRasterizationPipeline));
     }
 
     // Fragment output library
     {
-        VkFormat const SwapChainImageFormat = GetSwapChainImageFormat();
-        VkFormat const DepthFormat          = EnableDepth ? GetDepthImage().Format : VK_FORMAT_UNDEFINED;
+        VkFormat const ColorFormat = Arguments.ColorFormat != VK_FORMAT_UNDEFINED ? Arguments.ColorFormat : GetSwapChainImageFormat();
+        VkFormat       DepthFormat = VK_FORMAT_UNDEFINED;
+
+        if (EnableDepth)
+        {
+            DepthFormat = Arguments.DepthFormat != VK_FORMAT_UNDEFINED ? Arguments.DepthFormat : GetDepthImage().Format;
+        }
 
         VkPipelineRenderingCreateInfo const RenderingCreateInfo {
                 .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
                 .pNext = nullptr,
                 .colorAttachmentCount = 1U,
-                .pColorAttachmentFormats = &SwapChainImageFormat,
+                .pColorAttachmentFormats = &ColorFormat,
                 .depthAttachmentFormat = DepthFormat,
                 .stencilAttachmentFormat = DepthFormat
         };
@@ -591,7 +1267,7 @@ void RenderCore::CreatePipelineLibraries(PipelineData &
                                                     Data.PipelineLibraryCache,
                                                     1U,
                                                     &FragmentOutputCreateInfo,
-                                                    nullptr,
+                                                    GetAllocationCallbacks(HostAllocationTag::Pipeline),
                                                     &Data.FragmentOutputPipeline));
     }
 }
@@ -602,6 +1278,8 @@ void RenderCore::CreateMainPipeline(PipelineData &
                                     VkPipelineDepthStencilStateCreateInfo const &       DepthStencilState,
                                     VkPipelineMultisampleStateCreateInfo const &        MultisampleState)
 {
+    RENDERCORE_PROFILE_SCOPE("Pipeline Link");
+
     VkDevice const &LogicalDevice = GetLogicalDevice();
     Data.CreateMainCache(LogicalDevice);
 
@@ -639,7 +1317,7 @@ void RenderCore::CreateMainPipeline(PipelineData &
                                                     Data.PipelineCache,
                                                     1U,
                                                     &FragmentShaderPipelineCreateInfo,
-                                                    nullptr,
+                                                    GetAllocationCallbacks(HostAllocationTag::Pipeline),
                                                     &Data.FragmentShaderPipeline));
     }
 
@@ -666,6 +1344,11 @@ void RenderCore::CreateMainPipeline(PipelineData &
                 .layout = Data.PipelineLayout
         };
 
-        CheckVulkanResult(vkCreateGraphicsPipelines(LogicalDevice, Data.PipelineCache, 1U, &GraphicsPipelineCreateInfo, nullptr, &Data.MainPipeline));
+        CheckVulkanResult(vkCreateGraphicsPipelines(LogicalDevice,
+                                                    Data.PipelineCache,
+                                                    1U,
+                                                    &GraphicsPipelineCreateInfo,
+                                                    GetAllocationCallbacks(HostAllocationTag::Pipeline),
+                                                    &Data.MainPipeline));
     }
 }
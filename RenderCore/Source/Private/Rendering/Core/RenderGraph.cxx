@@ -0,0 +1,527 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.RenderGraph;
+
+import RenderCore.Runtime.Memory;
+import RenderCore.Utils.EnumHelpers;
+import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+struct TransientImage
+{
+    TransientImageDescription Description {};
+    ImageAllocation           Allocation {};
+    RenderGraphImageState     State {};
+};
+
+// Physical images behind transient resources; kept between frames and shared by resources whose lifetimes don't overlap
+std::vector<TransientImage> g_TransientImages {};
+
+RenderGraphImageState GetAccessState(RenderGraphAccess const Access, bool const IsWrite)
+{
+    switch (Access)
+    {
+        case RenderGraphAccess::ColorAttachment:
+            return RenderGraphImageState {
+                    .Layout = g_AttachmentLayout,
+                    .Stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    .Access = IsWrite ? VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT,
+                    .IsWrite = IsWrite
+            };
+
+        case RenderGraphAccess::DepthAttachment:
+            return RenderGraphImageState {
+                    .Layout = g_AttachmentLayout,
+                    .Stages = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                    .Access = IsWrite ? VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                    .IsWrite = IsWrite
+            };
+
+        case RenderGraphAccess::ShaderRead:
+            return RenderGraphImageState {
+                    .Layout = g_ReadLayout,
+                    .Stages = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    .Access = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                    .IsWrite = false
+            };
+
+        case RenderGraphAccess::Storage:
+            return RenderGraphImageState {
+                    .Layout = VK_IMAGE_LAYOUT_GENERAL,
+                    .Stages = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    .Access = IsWrite ? VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT : VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                    .IsWrite = IsWrite
+            };
+
+        case RenderGraphAccess::TransferRead:
+            return RenderGraphImageState {
+                    .Layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    .Stages = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+                    .Access = VK_ACCESS_2_TRANSFER_READ_BIT,
+                    .IsWrite = false
+            };
+
+        case RenderGraphAccess::TransferWrite:
+            return RenderGraphImageState {
+                    .Layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .Stages = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+                    .Access = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                    .IsWrite = true
+            };
+
+        // Whatever wrote the image last, a blit included, is ordered before the render finished semaphore, which is signaled after all commands
+        case RenderGraphAccess::Present:
+            return RenderGraphImageState { .Layout = g_PresentLayout, .Stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT };
+
+        default:
+            return RenderGraphImageState {};
+    }
+}
+
+VkImageAspectFlags GetBarrierAspect(RenderGraphImage const &Image)
+{
+    VkImageAspectFlags Output = Image.Aspect;
+
+    if (HasFlag<VkImageAspectFlags>(Output, g_DepthAspect) && DepthHasStencil(Image.Allocation.Format))
+    {
+        Output |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+
+    return Output;
+}
+
+void TransitionImage(RenderGraphImage const &                 Image,
+                     RenderGraphImageState &                  Current,
+                     RenderGraphImageState const &            Requested,
+                     std::pmr::vector<VkImageMemoryBarrier2> &Barriers)
+{
+    // Reads in the same layout don't need a barrier between them, but a later write has to wait for all of them
+    if (Current.Layout == Requested.Layout && !Current.IsWrite && !Requested.IsWrite)
+    {
+        Current.Stages |= Requested.Stages;
+        Current.Access |= Requested.Access;
+        return;
+    }
+
+    Barriers.push_back(VkImageMemoryBarrier2 {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = Current.Stages,
+            .srcAccessMask = Current.IsWrite ? Current.Access : VK_ACCESS_2_NONE,
+            .dstStageMask = Requested.Stages,
+            .dstAccessMask = Requested.Access,
+            .oldLayout = Current.Layout,
+            .newLayout = Requested.Layout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = Image.Allocation.Image,
+            .subresourceRange = {
+                    .aspectMask = GetBarrierAspect(Image),
+                    .baseMipLevel = 0U,
+                    .levelCount = VK_REMAINING_MIP_LEVELS,
+                    .baseArrayLayer = 0U,
+                    .layerCount = VK_REMAINING_ARRAY_LAYERS
+            }
+    });
+
+    Current = Requested;
+}
+
+void RecordBarriers(VkCommandBuffer const &CommandBuffer, std::pmr::vector<VkImageMemoryBarrier2> const &Barriers)
+{
+    if (std::empty(Barriers))
+    {
+        return;
+    }
+
+    VkDependencyInfo const DependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .imageMemoryBarrierCount = static_cast<std::uint32_t>(std::size(Barriers)),
+            .pImageMemoryBarriers = std::data(Barriers)
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+}
+
+std::uint32_t AcquireTransientImage(TransientImageDescription const &Description,
+                                    std::uint32_t const               FirstPass,
+                                    std::pmr::vector<std::uint32_t> & BusyUntil)
+{
+    for (std::uint32_t Index = 0U; Index < std::size(g_TransientImages); ++Index)
+    {
+        bool const IsAvailable = BusyUntil.at(Index) == std::numeric_limits<std::uint32_t>::max() || BusyUntil.at(Index) < FirstPass;
+
+        if (IsAvailable && g_TransientImages.at(Index).Description == Description)
+        {
+            return Index;
+        }
+    }
+
+    TransientImage &NewImage   = g_TransientImages.emplace_back(TransientImage { .Description = Description });
+    NewImage.Allocation.Extent = Description.Extent;
+    NewImage.Allocation.Format = Description.Format;
+
+    CreateImage(Description.Format,
+                Description.Extent,
+                g_ImageTiling,
+                Description.Usage,
+                g_TextureMemoryUsage,
+                "RENDER_GRAPH_TRANSIENT_IMAGE",
+                NewImage.Allocation.Image,
+                NewImage.Allocation.Allocation);
+
+    CreateImageView(NewImage.Allocation.Image, Description.Format, Description.Aspect, NewImage.Allocation.View);
+
+    BusyUntil.push_back(std::numeric_limits<std::uint32_t>::max());
+
+    return static_cast<std::uint32_t>(std::size(g_TransientImages) - 1U);
+}
+
+RenderGraphPass::~RenderGraphPass()
+{
+    if (m_Destroy)
+    {
+        m_Destroy(m_Callable, m_Accesses.get_allocator().resource());
+    }
+}
+
+RenderGraphPass &RenderGraphPass::Read(RenderGraphResource const Resource, RenderGraphAccess const Access)
+{
+    m_Accesses.push_back(RenderGraphAccessEntry { .Resource = Resource, .Access = Access, .IsWrite = false });
+    return *this;
+}
+
+RenderGraphPass &RenderGraphPass::Write(RenderGraphResource const Resource, RenderGraphAccess const Access)
+{
+    m_Accesses.push_back(RenderGraphAccessEntry { .Resource = Resource, .Access = Access, .IsWrite = true });
+    return *this;
+}
+
+RenderGraphPass &RenderGraphPass::SetHasSideEffects()
+{
+    m_HasSideEffects = true;
+    return *this;
+}
+
+RenderGraph::RenderGraph(std::pmr::memory_resource *const Resource)
+    : m_Resource(Resource)
+{
+}
+
+RenderGraphResource RenderGraph::ImportImage(strzilla::string_view const Name,
+                                             ImageAllocation const &     Allocation,
+                                             VkImageAspectFlags const    Aspect,
+                                             VkPipelineStageFlags2 const InitialStages,
+                                             VkAccessFlags2 const        InitialWriteAccess)
+{
+    RenderGraphData &Data = GetData();
+
+    // Imported images are treated as discarded at the start of the graph, after the work of InitialStages;
+    // the writes in InitialWriteAccess are made available before the first transition, as the previous frame may still be writing the image
+    Data.Images.push_back(RenderGraphImage {
+            .Name = Name,
+            .Allocation = Allocation,
+            .Aspect = Aspect,
+            .InitialState = RenderGraphImageState {
+                    .Stages = InitialStages,
+                    .Access = InitialWriteAccess,
+                    .IsWrite = InitialWriteAccess != VK_ACCESS_2_NONE
+            }
+    });
+
+    m_IsCompiled = false;
+    return static_cast<RenderGraphResource>(std::size(Data.Images) - 1U);
+}
+
+RenderGraphResource RenderGraph::CreateTransientImage(strzilla::string_view const Name, TransientImageDescription const &Description)
+{
+    RenderGraphData &Data = GetData();
+
+    Data.Images.push_back(RenderGraphImage {
+            .Name = Name,
+            .Allocation = ImageAllocation { .Extent = Description.Extent, .Format = Description.Format },
+            .Aspect = Description.Aspect,
+            .Description = Description,
+            .IsTransient = true
+    });
+
+    m_IsCompiled = false;
+    return static_cast<RenderGraphResource>(std::size(Data.Images) - 1U);
+}
+
+void RenderGraph::ExportImage(RenderGraphResource const Resource, RenderGraphAccess const Access)
+{
+    GetData().Images.at(Resource).ExportAccess = Access;
+    m_IsCompiled                               = false;
+}
+
+void RenderGraph::Compile()
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    RenderGraphData &Data      = GetData();
+    auto const       NumPasses = static_cast<std::uint32_t>(std::size(Data.Passes));
+
+    // Culling: walking backwards from the exported images, a pass only survives if something after it consumes what it writes
+    std::pmr::vector<bool> IsNeeded(std::size(Data.Images), false, m_Resource);
+
+    for (std::size_t Index = 0U; Index < std::size(Data.Images); ++Index)
+    {
+        IsNeeded.at(Index) = Data.Images.at(Index).ExportAccess != RenderGraphAccess::None;
+    }
+
+    for (std::uint32_t PassIndex = NumPasses; PassIndex > 0U; --PassIndex)
+    {
+        RenderGraphPass &Pass = Data.Passes.at(PassIndex - 1U);
+
+        Pass.m_IsCulled = !Pass.m_HasSideEffects && std::ranges::none_of(Pass.m_Accesses,
+                                                                          [&IsNeeded](RenderGraphAccessEntry const &Entry)
+                                                                          {
+                                                                              return Entry.IsWrite && IsNeeded.at(Entry.Resource);
+                                                                          });
+
+        if (Pass.m_IsCulled)
+        {
+            continue;
+        }
+
+        for (RenderGraphAccessEntry const &Entry : Pass.m_Accesses)
+        {
+            IsNeeded.at(Entry.Resource) = true;
+        }
+    }
+
+    // Lifetimes of the resources used by the remaining passes
+    for (RenderGraphImage &Image : Data.Images)
+    {
+        Image.FirstPass     = std::numeric_limits<std::uint32_t>::max();
+        Image.LastPass      = 0U;
+        Image.PhysicalIndex = std::numeric_limits<std::uint32_t>::max();
+    }
+
+    for (std::uint32_t PassIndex = 0U; PassIndex < NumPasses; ++PassIndex)
+    {
+        if (Data.Passes.at(PassIndex).m_IsCulled)
+        {
+            continue;
+        }
+
+        for (RenderGraphAccessEntry const &Entry : Data.Passes.at(PassIndex).m_Accesses)
+        {
+            RenderGraphImage &Image = Data.Images.at(Entry.Resource);
+            Image.FirstPass         = std::min(Image.FirstPass, PassIndex);
+            Image.LastPass          = std::max(Image.LastPass, PassIndex);
+        }
+    }
+
+    // Aliasing: transient resources take the first compatible physical image that is free by the time they are first used
+    std::pmr::vector<RenderGraphResource> TransientResources { m_Resource };
+
+    for (RenderGraphResource Resource = 0U; Resource < std::size(Data.Images); ++Resource)
+    {
+        if (RenderGraphImage const &Image = Data.Images.at(Resource);
+            Image.IsTransient && Image.FirstPass != std::numeric_limits<std::uint32_t>::max())
+        {
+            TransientResources.push_back(Resource);
+        }
+    }
+
+    std::ranges::sort(TransientResources,
+                      [&Data](RenderGraphResource const Lhs, RenderGraphResource const Rhs)
+                      {
+                          return Data.Images.at(Lhs).FirstPass < Data.Images.at(Rhs).FirstPass;
+                      });
+
+    std::pmr::vector<std::uint32_t> BusyUntil(std::size(g_TransientImages), std::numeric_limits<std::uint32_t>::max(), m_Resource);
+
+    for (RenderGraphResource const Resource : TransientResources)
+    {
+        RenderGraphImage &  Image         = Data.Images.at(Resource);
+        std::uint32_t const PhysicalIndex = AcquireTransientImage(Image.Description, Image.FirstPass, BusyUntil);
+
+        BusyUntil.at(PhysicalIndex) = Image.LastPass;
+        Image.PhysicalIndex         = PhysicalIndex;
+        Image.Allocation            = g_TransientImages.at(PhysicalIndex).Allocation;
+    }
+
+    // Barriers: one batch before each pass, from the state the previous accesses left each image in
+    Data.TransientFinalStates.resize(std::size(g_TransientImages));
+
+    for (std::size_t Index = 0U; Index < std::size(g_TransientImages); ++Index)
+    {
+        Data.TransientFinalStates.at(Index) = g_TransientImages.at(Index).State;
+    }
+
+    std::pmr::vector<RenderGraphImageState> States(std::size(Data.Images), m_Resource);
+    std::pmr::vector<bool>                  IsFirstAccess(std::size(Data.Images), true, m_Resource);
+
+    for (RenderGraphPass &Pass : Data.Passes)
+    {
+        Pass.m_Barriers.clear();
+
+        if (Pass.m_IsCulled)
+        {
+            continue;
+        }
+
+        std::ranges::sort(Pass.m_Accesses,
+                          [](RenderGraphAccessEntry const &Lhs, RenderGraphAccessEntry const &Rhs)
+                          {
+                              return Lhs.Resource < Rhs.Resource;
+                          });
+
+        for (auto EntryIt = std::begin(Pass.m_Accesses); EntryIt != std::end(Pass.m_Accesses);)
+        {
+            RenderGraphResource const Resource  = EntryIt->Resource;
+            RenderGraphImageState     Requested = GetAccessState(EntryIt->Access, EntryIt->IsWrite);
+
+            // Several accesses to the same image in one pass are merged into a single state
+            for (++EntryIt; EntryIt != std::end(Pass.m_Accesses) && EntryIt->Resource == Resource; ++EntryIt)
+            {
+                RenderGraphImageState const Other = GetAccessState(EntryIt->Access, EntryIt->IsWrite);
+
+                Requested.Layout = Requested.Layout == Other.Layout ? Requested.Layout : VK_IMAGE_LAYOUT_GENERAL;
+                Requested.Stages |= Other.Stages;
+                Requested.Access |= Other.Access;
+                Requested.IsWrite |= Other.IsWrite;
+            }
+
+            RenderGraphImage const &Image   = Data.Images.at(Resource);
+            RenderGraphImageState & Current = States.at(Resource);
+
+            if (IsFirstAccess.at(Resource))
+            {
+                IsFirstAccess.at(Resource) = false;
+
+                if (Image.IsTransient)
+                {
+                    // Contents of an aliased image are never inherited, but its previous users still have to finish
+                    Current        = Data.TransientFinalStates.at(Image.PhysicalIndex);
+                    Current.Layout = g_UndefinedLayout;
+                }
+                else
+                {
+                    Current        = Image.InitialState;
+                    Current.Stages = Current.Stages != VK_PIPELINE_STAGE_2_NONE ? Current.Stages : Requested.Stages;
+                }
+            }
+
+            TransitionImage(Image, Current, Requested, Pass.m_Barriers);
+
+            if (Image.IsTransient)
+            {
+                Data.TransientFinalStates.at(Image.PhysicalIndex) = Current;
+            }
+        }
+    }
+
+    Data.FinalBarriers.clear();
+
+    for (RenderGraphResource Resource = 0U; Resource < std::size(Data.Images); ++Resource)
+    {
+        RenderGraphImage const &Image = Data.Images.at(Resource);
+
+        if (Image.ExportAccess == RenderGraphAccess::None || Image.Allocation.Image == VK_NULL_HANDLE)
+        {
+            continue;
+        }
+
+        RenderGraphImageState &     Current   = States.at(Resource);
+        RenderGraphImageState const Requested = GetAccessState(Image.ExportAccess, false);
+
+        if (IsFirstAccess.at(Resource))
+        {
+            Current        = Image.InitialState;
+            Current.Stages = Current.Stages != VK_PIPELINE_STAGE_2_NONE ? Current.Stages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        }
+
+        TransitionImage(Image, Current, Requested, Data.FinalBarriers);
+    }
+
+    m_IsCompiled = true;
+}
+
+void RenderGraph::Execute(VkCommandBuffer const &CommandBuffer)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    if (!m_IsCompiled)
+    {
+        Compile();
+    }
+
+    RenderGraphData const &Data = GetData();
+
+    for (RenderGraphPass const &Pass : Data.Passes)
+    {
+        if (Pass.m_IsCulled)
+        {
+            continue;
+        }
+
+        RecordBarriers(CommandBuffer, Pass.m_Barriers);
+
+        if (Pass.m_Execute)
+        {
+            RENDERCORE_PROFILE_SCOPE(std::data(Pass.m_Name));
+            Pass.m_Execute(Pass.m_Callable, CommandBuffer, *this);
+        }
+    }
+
+    RecordBarriers(CommandBuffer, Data.FinalBarriers);
+
+    for (std::size_t Index = 0U; Index < std::min(std::size(Data.TransientFinalStates), std::size(g_TransientImages)); ++Index)
+    {
+        g_TransientImages.at(Index).State = Data.TransientFinalStates.at(Index);
+    }
+}
+
+void RenderGraph::Reset()
+{
+    m_Data.reset();
+    m_IsCompiled = false;
+}
+
+ImageAllocation const &RenderGraph::GetImage(RenderGraphResource const Resource) const
+{
+    return m_Data.value().Images.at(Resource).Allocation;
+}
+
+std::uint32_t RenderGraph::GetNumCulledPasses() const
+{
+    if (!m_Data)
+    {
+        return 0U;
+    }
+
+    return static_cast<std::uint32_t>(std::ranges::count_if(m_Data->Passes,
+                                                            [](RenderGraphPass const &Pass)
+                                                            {
+                                                                return Pass.m_IsCulled;
+                                                            }));
+}
+
+RenderGraphData &RenderGraph::GetData()
+{
+    if (!m_Data)
+    {
+        m_Data.emplace(m_Resource);
+    }
+
+    return *m_Data;
+}
+
+void RenderCore::ReleaseRenderGraphResources()
+{
+    for (TransientImage &ImageIt : g_TransientImages)
+    {
+        ImageIt.Allocation.DestroyResources(GetAllocator());
+    }
+
+    g_TransientImages.clear();
+}
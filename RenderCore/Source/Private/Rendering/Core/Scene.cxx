@@ -20,17 +20,26 @@ module RenderCore.Runtime.Scene;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Device;
 import RenderCore.Runtime.Command;
+import RenderCore.Runtime.Model;
 import RenderCore.Factories.Mesh;
 import RenderCore.Factories.Texture;
 import RenderCore.Types.UniformBufferObject;
 import RenderCore.Types.Texture;
 import RenderCore.Types.Mesh;
+import RenderCore.Types.Resource;
+import RenderCore.Types.Skeleton;
 import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.AllocationCallbacks;
+import RenderCore.Utils.Logger;
 
 using namespace RenderCore;
 
 std::mutex g_ObjectMutex {};
 
+// First block of the load arena; it grows from the default resource when a model needs more
+constexpr std::size_t g_SceneLoadArenaSize { 4U * 1024U * 1024U };
+
 void RenderCore::CreateSceneUniformBuffer()
 {
     constexpr VkDeviceSize BufferSize = sizeof(SceneUniformData);
@@ -62,7 +71,7 @@ void RenderCore::CreateImageSampler()
             .unnormalizedCoordinates = VK_FALSE
     };
 
-    CheckVulkanResult(vkCreateSampler(GetLogicalDevice(), &SamplerCreateInfo, nullptr, &g_Sampler));
+    CheckVulkanResult(vkCreateSampler(GetLogicalDevice(), &SamplerCreateInfo, GetAllocationCallbacks(HostAllocationTag::Descriptors), &g_Sampler));
 }
 
 void RenderCore::CreateDepthResources(SurfaceProperties const &SurfaceProperties)
@@ -117,8 +126,12 @@ void RenderCore::AllocateEmptyTexture(VkFormat const TextureFormat)
 
 void RenderCore::LoadScene(strzilla::string_view const ModelPath)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     tinygltf::Model Model {};
     {
+        RENDERCORE_PROFILE_SCOPE("LoadScene Parse");
+
         tinygltf::TinyGLTF          ModelLoader {};
         std::string                 Error {};
         std::string                 Warning {};
@@ -128,27 +141,40 @@ void RenderCore::LoadScene(strzilla::string_view const ModelPath)
                                                      : ModelLoader.LoadBinaryFromFile(&Model, &Error, &Warning, std::data(ModelPath));
         if (!std::empty(Error))
         {
-            BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Error: '" << Error << "'";
+            RENDERCORE_LOG(error, "Error: '{}'", Error);
         }
 
         if (!std::empty(Warning))
         {
-            BOOST_LOG_TRIVIAL(warning) << "[" << __func__ << "]: Warning: '" << Warning << "'";
+            RENDERCORE_LOG(warning, "Warning: '{}'", Warning);
         }
 
         if (!LoadResult)
         {
-            BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Failed to load model from path: '" << ModelPath << "'";
+            RENDERCORE_LOG(error, "Failed to load model from path: '{}'", std::data(ModelPath));
             return;
         }
     }
 
+    // Everything that only lives while the model is loaded comes from this arena, released at once after the upload
+    std::pmr::monotonic_buffer_resource LoadArena { g_SceneLoadArenaSize };
+
     VkCommandPool                CommandPool { VK_NULL_HANDLE };
     std::vector<VkCommandBuffer> CommandBuffers { VK_NULL_HANDLE };
 
-    auto const &                                                [QueueIndex, Queue] = GetGraphicsQueue();
-    std::unordered_map<VkBuffer, VmaAllocation>                 BufferAllocations {};
-    std::unordered_map<std::uint32_t, std::shared_ptr<Texture>> TextureMap {};
+    auto const &                                                      [QueueIndex, Queue] = GetGraphicsQueue();
+    std::pmr::unordered_map<VkBuffer, VmaAllocation>                 BufferAllocations { &LoadArena };
+    std::pmr::unordered_map<std::uint32_t, std::shared_ptr<Texture>> TextureMap { &LoadArena };
+
+    // Shared by every skinned object of the model, so its joints are evaluated once per frame
+    std::shared_ptr<Skeleton> const ModelSkeleton = std::empty(Model.skins) ? nullptr : ConstructSkeleton(Model);
+
+    // The first clip plays in a loop, as a loaded model is expected to show its animation; the others are started through the skeleton
+    if (ModelSkeleton && !std::empty(Model.animations))
+    {
+        ModelSkeleton->SetAnimations(ConstructAnimations(Model, *ModelSkeleton, &LoadArena));
+        ModelSkeleton->PlayAnimation(0U);
+    }
 
     InitializeSingleCommandQueue(CommandPool, CommandBuffers, QueueIndex);
     {
@@ -196,18 +222,25 @@ void RenderCore::LoadScene(strzilla::string_view const ModelPath)
                         .Node = Node,
                         .Mesh = LoadedMesh,
                         .Primitive = PrimitiveIter,
-                        .TextureMap = TextureMap
+                        .TextureMap = TextureMap,
+                        .TransientResource = &LoadArena
                 };
 
                 if (std::shared_ptr<Mesh> NewMesh = ConstructMesh(Arguments);
                     NewMesh)
                 {
                     std::uint32_t const ObjectID  = FetchID();
-                    auto                NewObject = std::make_shared<Object>(ObjectID, ModelPath);
+                    auto                NewObject = MakePooledResource<Object>(ObjectID, ModelPath);
 
-                    NewMesh->Optimize();
+                    NewMesh->Optimize(&LoadArena);
                     NewObject->SetMesh(std::move(NewMesh));
 
+                    if (ModelSkeleton && Node.skin >= 0 && PrimitiveIter.attributes.contains("JOINTS_0") &&
+                        PrimitiveIter.attributes.contains("WEIGHTS_0"))
+                    {
+                        NewObject->SetSkin(ModelSkeleton, static_cast<std::uint32_t>(Node.skin));
+                    }
+
                     g_Objects.push_back(std::move(NewObject));
                 }
             }
@@ -222,6 +255,10 @@ void RenderCore::LoadScene(strzilla::string_view const ModelPath)
     {
         vmaDestroyBuffer(Allocator, Buffer, Allocation);
     }
+
+    BufferAllocations.clear();
+    TextureMap.clear();
+    LoadArena.release();
 }
 
 void RenderCore::UnloadObjects(std::vector<std::uint32_t> const &ObjectIDs)
@@ -257,7 +294,7 @@ void RenderCore::ReleaseSceneResources()
 
     if (g_Sampler != VK_NULL_HANDLE)
     {
-        vkDestroySampler(LogicalDevice, g_Sampler, nullptr);
+        vkDestroySampler(LogicalDevice, g_Sampler, GetAllocationCallbacks(HostAllocationTag::Descriptors));
         g_Sampler = VK_NULL_HANDLE;
     }
 
@@ -283,6 +320,8 @@ void RenderCore::DestroyObjects()
 
 void RenderCore::TickObjects(float const DeltaTime)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     std::lock_guard Lock { g_ObjectMutex };
 
     std::for_each(std::execution::unseq,
@@ -297,21 +336,9 @@ void RenderCore::TickObjects(float const DeltaTime)
                   });
 }
 
-void RenderCore::UpdateSceneUniformBuffer()
+void RenderCore::UpdateSceneUniformBuffer(SceneUniformData const &SceneData)
 {
-    if (g_Camera.IsRenderDirty() || g_Illumination.IsRenderDirty())
-    {
-        constexpr auto SceneUBOSize = sizeof(SceneUniformData);
-
-        SceneUniformData const UpdatedUBO {
-                .ProjectionView = g_Camera.GetProjectionMatrix() * g_Camera.GetViewMatrix(),
-                .LightPosition = g_Illumination.GetPosition(),
-                .LightColor = g_Illumination.GetColor() * g_Illumination.GetIntensity(),
-                .AmbientLight = g_Illumination.GetAmbient()
-        };
-
-        std::memcpy(m_UniformBufferAllocation.first.MappedData, &UpdatedUBO, SceneUBOSize);
-    }
+    std::memcpy(m_UniformBufferAllocation.first.MappedData, &SceneData, sizeof(SceneUniformData));
 }
 
 void RenderCore::UpdateObjectsUniformBuffer()
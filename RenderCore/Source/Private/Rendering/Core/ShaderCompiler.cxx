@@ -13,8 +13,20 @@ module;
 #include <spirv-tools/libspirv.hpp>
 #endif
 
+#if RENDERCORE_EMBEDDED_SHADERS
+#include "DEFAULT_SHADER_comp.hpp"
+#include "DEFAULT_SHADER_frag.hpp"
+#include "DEFAULT_SHADER_vert.hpp"
+#include "SKINNING_SHADER_comp.hpp"
+#include "VISIBILITY_SHADER_comp.hpp"
+#include "VISIBILITY_SHADER_frag.hpp"
+#endif
+
 module RenderCore.Runtime.ShaderCompiler;
 
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.Logger;
+
 using namespace RenderCore;
 
 bool CompileInternal(ShaderType const            ShaderType,
@@ -47,9 +59,10 @@ bool CompileInternal(ShaderType const            ShaderType,
         auto const InfoLog(strzilla::string { "Info Log: " } + Shader.getInfoLog());
         auto const DebugLog(strzilla::string { "Debug Log: " } + Shader.getInfoDebugLog());
 
-        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: " << std::format("Failed to parse shader:\n{}\n{}",
-                                                                            std::data(InfoLog),
-                                                                            std::data(DebugLog));
+        RENDERCORE_LOG(error,
+                       "Failed to parse shader:\n{}\n{}",
+                       std::data(InfoLog),
+                       std::data(DebugLog));
         return false;
     }
 
@@ -63,15 +76,16 @@ bool CompileInternal(ShaderType const            ShaderType,
         auto const InfoLog(strzilla::string { "Info Log: " } + Shader.getInfoLog());
         auto const DebugLog(strzilla::string { "Debug Log: " } + Shader.getInfoDebugLog());
 
-        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: " << std::format("Failed to parse shader:\n{}\n{}",
-                                                                            std::data(InfoLog),
-                                                                            std::data(DebugLog));
+        RENDERCORE_LOG(error,
+                       "Failed to parse shader:\n{}\n{}",
+                       std::data(InfoLog),
+                       std::data(DebugLog));
         return false;
     }
 
     #ifdef _DEBUG
     // Uncomment to print the shader code
-    // BOOST_LOG_TRIVIAL(debug) << "[" << __func__ << "]: Compiling shader:\n" << Source;
+    // RENDERCORE_LOG(debug, "Compiling shader:\n{}", std::data(Source));
     #endif
 
     spv::SpvBuildLogger Logger;
@@ -81,7 +95,7 @@ bool CompileInternal(ShaderType const            ShaderType,
     if (strzilla::string const GeneratedLogs = Logger.getAllMessages();
         !std::empty(GeneratedLogs))
     {
-        BOOST_LOG_TRIVIAL(info) << "[" << __func__ << "]: Shader compilation result log:\n" << GeneratedLogs;
+        RENDERCORE_LOG(info, "Shader compilation result log:\n{}", std::data(GeneratedLogs));
     }
 
     return !std::empty(OutSPIRVCode);
@@ -110,13 +124,13 @@ bool ValidateSPIRV(std::vector<std::uint32_t> const &SPIRVData)
             {
                 case SPV_MSG_FATAL:
                 case SPV_MSG_INTERNAL_ERROR:
-                case SPV_MSG_ERROR: BOOST_LOG_TRIVIAL(error) << "[" << _func_internal_ << "]: " << std::format("Error: {}\n", Message);
+                case SPV_MSG_ERROR: PushLogRecord<boost::log::trivial::error>(_func_internal_, "Error: {}\n", Message);
                     break;
 
-                case SPV_MSG_WARNING: BOOST_LOG_TRIVIAL(warning) << "[" << _func_internal_ << "]: " << std::format("Warning: {}\n", Message);
+                case SPV_MSG_WARNING: PushLogRecord<boost::log::trivial::warning>(_func_internal_, "Warning: {}\n", Message);
                     break;
 
-                case SPV_MSG_INFO: BOOST_LOG_TRIVIAL(info) << "[" << _func_internal_ << "]: " << std::format("Info: {}\n", Message);
+                case SPV_MSG_INFO: PushLogRecord<boost::log::trivial::info>(_func_internal_, "Info: {}\n", Message);
                     break;
 
                 default:
@@ -130,7 +144,7 @@ bool ValidateSPIRV(std::vector<std::uint32_t> const &SPIRVData)
     // Uncomment to print SPIR-V disassembly
     // if (strzilla::string DisassemblySPIRVData; SPIRVToolsInstance.Disassemble(SPIRVData, &DisassemblySPIRVData))
     // {
-    //     BOOST_LOG_TRIVIAL(debug) << "[" << __func__ << "]: Generated SPIR-V shader disassembly:\n" << DisassemblySPIRVData;
+    //     RENDERCORE_LOG(debug, "Generated SPIR-V shader disassembly:\n{}", DisassemblySPIRVData);
     // }
 
     return SPIRVToolsInstance.Validate(SPIRVData);
@@ -144,6 +158,8 @@ bool RenderCore::Compile(strzilla::string_view const Source,
                          EShLanguage const           Language,
                          std::vector<std::uint32_t> &OutSPIRVCode)
 {
+    RENDERCORE_PROFILE_SCOPE("Shader Compile");
+
     std::filesystem::path const Path { std::data(Source) };
     std::stringstream           ShaderSource;
     std::ifstream               File { Path };
@@ -228,17 +244,46 @@ bool RenderCore::CompileOrLoadIfExists(strzilla::string_view const Source,
 
 void RenderCore::CompileDefaultShaders()
 {
+    constexpr auto EntryPoint = "main";
+
+    #if RENDERCORE_EMBEDDED_SHADERS
+    auto const StageEmbedded = [EntryPoint](std::vector<ShaderStageData> &       Target,
+                                            std::span<std::uint32_t const> const ShaderCode,
+                                            VkShaderStageFlagBits const          Stage)
+    {
+        Target.push_back(ShaderStageData {
+                .StageInfo = VkPipelineShaderStageCreateInfo {
+                        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                        .stage = Stage,
+                        .pName = EntryPoint
+                },
+                .ShaderCode = std::vector<std::uint32_t>(std::begin(ShaderCode), std::end(ShaderCode))
+        });
+    };
+
+    StageEmbedded(g_StageInfos, g_EmbeddedDefaultVertexShader, VK_SHADER_STAGE_VERTEX_BIT);
+    StageEmbedded(g_StageInfos, g_EmbeddedDefaultFragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT);
+    StageEmbedded(g_StageInfos, g_EmbeddedDefaultComputeShader, VK_SHADER_STAGE_COMPUTE_BIT);
+    StageEmbedded(g_VisibilityStageInfos, g_EmbeddedVisibilityFragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT);
+    StageEmbedded(g_VisibilityStageInfos, g_EmbeddedVisibilityComputeShader, VK_SHADER_STAGE_COMPUTE_BIT);
+    StageEmbedded(g_SkinningStageInfos, g_EmbeddedSkinningComputeShader, VK_SHADER_STAGE_COMPUTE_BIT);
+    #else
     constexpr auto GlslVersion = 450;
-    constexpr auto EntryPoint  = "main";
 
-    auto const CompileAndStage = [EntryPoint, GlslVersion](strzilla::string_view const Shader, EShLanguage const Language)
+    auto const CompileAndStage = [EntryPoint, GlslVersion](std::vector<ShaderStageData> &Target,
+                                                           strzilla::string_view const   Shader,
+                                                           EShLanguage const             Language)
     {
-        if (auto &[StageInfo, ShaderCode] = g_StageInfos.emplace_back();
+        if (auto &[StageInfo, ShaderCode] = Target.emplace_back();
             CompileOrLoadIfExists(Shader, ShaderType::GLSL, EntryPoint, GlslVersion, Language, ShaderCode))
         {
             StageInfo = VkPipelineShaderStageCreateInfo {
                     .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-                    .stage = Language == EShLangVertex ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT,
+                    .stage = Language == EShLangVertex
+                                 ? VK_SHADER_STAGE_VERTEX_BIT
+                                 : Language == EShLangCompute
+                                       ? VK_SHADER_STAGE_COMPUTE_BIT
+                                       : VK_SHADER_STAGE_FRAGMENT_BIT,
                     .pName = EntryPoint
             };
         }
@@ -246,17 +291,31 @@ void RenderCore::CompileDefaultShaders()
 
     // constexpr auto TaskLang { EShLangTask };
     // constexpr auto TaskShader { DEFAULT_TASK_SHADER };
-    // CompileAndStage(TaskShader, TaskLang);
+    // CompileAndStage(g_StageInfos, TaskShader, TaskLang);
 
     // constexpr auto MeshLang { EShLangMesh };
     // constexpr auto MeshShader { DEFAULT_MESH_SHADER };
-    // CompileAndStage(MeshShader, MeshLang);
+    // CompileAndStage(g_StageInfos, MeshShader, MeshLang);
 
     constexpr auto VertexLang { EShLangVertex };
     constexpr auto VertexShader { DEFAULT_VERTEX_SHADER };
-    CompileAndStage(VertexShader, VertexLang);
+    CompileAndStage(g_StageInfos, VertexShader, VertexLang);
 
     constexpr auto FragmentLang { EShLangFragment };
     constexpr auto FragmentShader { DEFAULT_FRAGMENT_SHADER };
-    CompileAndStage(FragmentShader, FragmentLang);
+    CompileAndStage(g_StageInfos, FragmentShader, FragmentLang);
+
+    constexpr auto ComputeLang { EShLangCompute };
+    constexpr auto ComputeShader { DEFAULT_COMPUTE_SHADER };
+    CompileAndStage(g_StageInfos, ComputeShader, ComputeLang);
+
+    constexpr auto VisibilityFragmentShader { VISIBILITY_FRAGMENT_SHADER };
+    CompileAndStage(g_VisibilityStageInfos, VisibilityFragmentShader, FragmentLang);
+
+    constexpr auto VisibilityComputeShader { VISIBILITY_COMPUTE_SHADER };
+    CompileAndStage(g_VisibilityStageInfos, VisibilityComputeShader, ComputeLang);
+
+    constexpr auto SkinningComputeShader { SKINNING_COMPUTE_SHADER };
+    CompileAndStage(g_SkinningStageInfos, SkinningComputeShader, ComputeLang);
+    #endif
 }
@@ -0,0 +1,275 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.Skinning;
+
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Skeleton;
+import RenderCore.Types.Vertex;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+// Objects of the same skin share its palette, so each joint is evaluated once per frame however many primitives it moves
+struct SkinPalette
+{
+    std::uint32_t SkeletonIndex { 0U };
+    std::uint32_t SkinIndex { 0U };
+    std::uint32_t JointOffset { 0U };
+    std::uint32_t NumJoints { 0U };
+};
+
+std::vector<std::shared_ptr<Skeleton>> g_Skeletons {};
+std::vector<std::uint8_t>              g_UpdatedSkeletons {};
+std::vector<SkinPalette>               g_SkinPalettes {};
+std::vector<glm::mat4>                 g_JointMatrices {};
+VkDeviceSize                           g_JointSlotSize { 0U };
+SkinningConstants                      g_SkinningConstants {};
+
+void ReserveSkinningBuffer(BufferAllocation &          Allocation,
+                           VkDeviceSize const          Size,
+                           VkBufferUsageFlags const    UsageFlags,
+                           strzilla::string_view const Identifier,
+                           bool const                  MapMemory)
+{
+    if (Allocation.Size >= Size)
+    {
+        return;
+    }
+
+    VmaAllocator const &Allocator = GetAllocator();
+    Allocation.DestroyResources(Allocator);
+
+    Allocation.Size = Size;
+    CreateBuffer(Size, UsageFlags, Identifier, Allocation.Buffer, Allocation.Allocation);
+
+    if (MapMemory)
+    {
+        vmaMapMemory(Allocator, Allocation.Allocation, &Allocation.MappedData);
+    }
+}
+
+void UpdateSkinPalette(SkinPalette const &Palette)
+{
+    std::span const Output { std::data(g_JointMatrices) + Palette.JointOffset, Palette.NumJoints };
+    g_Skeletons.at(Palette.SkeletonIndex)->GetJointMatrices(Palette.SkinIndex, Output);
+}
+
+// Rebuilt with the pipeline refresh, after the models buffer: the jobs read the bind pose vertices from it
+void RenderCore::UpdateSkinnedObjects(std::vector<std::shared_ptr<Object>> const &Objects)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    g_Skeletons.clear();
+    g_SkinPalettes.clear();
+
+    std::vector<GPUSkinningJob> Jobs {};
+    std::uint32_t               NumJoints { 0U };
+    std::uint32_t               NumVertices { 0U };
+
+    for (std::shared_ptr<Object> const &ObjectIt : Objects)
+    {
+        std::shared_ptr<Mesh> const &MeshIt = ObjectIt->GetMesh();
+
+        if (!ObjectIt->IsSkinned() || !MeshIt || ObjectIt->IsPendingDestroy())
+        {
+            continue;
+        }
+
+        std::shared_ptr<Skeleton> const &SkeletonIt = ObjectIt->GetSkeleton();
+        std::uint32_t const              SkinIndex  = ObjectIt->GetSkinIndex();
+        auto                             Owner      = std::ranges::find(g_Skeletons, SkeletonIt);
+
+        if (Owner == std::end(g_Skeletons))
+        {
+            Owner = g_Skeletons.insert(Owner, SkeletonIt);
+        }
+
+        auto const SkeletonIndex = static_cast<std::uint32_t>(std::distance(std::begin(g_Skeletons), Owner));
+        auto       Palette       = std::ranges::find_if(g_SkinPalettes,
+                                                        [SkeletonIndex, SkinIndex](SkinPalette const &PaletteIt)
+                                                        {
+                                                            return PaletteIt.SkeletonIndex == SkeletonIndex && PaletteIt.SkinIndex == SkinIndex;
+                                                        });
+
+        if (Palette == std::end(g_SkinPalettes))
+        {
+            auto const NumSkinJoints = static_cast<std::uint32_t>(std::size(SkeletonIt->GetSkins().at(SkinIndex).JointNodes));
+
+            Palette = g_SkinPalettes.insert(Palette,
+                                            SkinPalette {
+                                                    .SkeletonIndex = SkeletonIndex,
+                                                    .SkinIndex = SkinIndex,
+                                                    .JointOffset = NumJoints,
+                                                    .NumJoints = NumSkinJoints
+                                            });
+
+            NumJoints += NumSkinJoints;
+        }
+
+        VkDeviceSize const OutputOffset = NumVertices * sizeof(Vertex);
+        ObjectIt->SetSkinnedVertexOffset(OutputOffset);
+
+        Jobs.push_back(GPUSkinningJob {
+                .SourceOffset = static_cast<std::uint32_t>(MeshIt->GetVertexOffset()),
+                .OutputOffset = static_cast<std::uint32_t>(OutputOffset),
+                .JointOffset = Palette->JointOffset,
+                .FirstVertex = NumVertices
+        });
+
+        NumVertices += MeshIt->GetNumVertices();
+    }
+
+    if (std::empty(Jobs) || NumVertices == 0U)
+    {
+        ReleaseSkinningResources();
+        return;
+    }
+
+    constexpr VkBufferUsageFlags StorageUsage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    g_JointSlotSize                           = std::max(NumJoints, 1U) * sizeof(glm::mat4);
+
+    ReserveSkinningBuffer(g_SkinnedVertexBuffer,
+                          NumVertices * sizeof(Vertex),
+                          StorageUsage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                          "SKINNED_VERTICES",
+                          false);
+    ReserveSkinningBuffer(g_JointMatrixBuffer, g_JointSlotSize * g_ImageCount, StorageUsage, "JOINT_MATRICES", true);
+    ReserveSkinningBuffer(g_SkinningJobBuffer, std::size(Jobs) * sizeof(GPUSkinningJob), StorageUsage, "SKINNING_JOBS", true);
+
+    std::memcpy(g_SkinningJobBuffer.MappedData, std::data(Jobs), std::size(Jobs) * sizeof(GPUSkinningJob));
+
+    // The rest pose, or the last animated one, fills every slot: a frame recorded before the next capture still finds valid joints
+    g_JointMatrices.assign(NumJoints, glm::mat4 { 1.F });
+
+    for (std::shared_ptr<Skeleton> const &SkeletonIt : g_Skeletons)
+    {
+        SkeletonIt->UpdateGlobalMatrices();
+    }
+
+    std::ranges::for_each(g_SkinPalettes, &UpdateSkinPalette);
+
+    for (std::uint8_t SlotIndex = 0U; SlotIndex < g_ImageCount; ++SlotIndex)
+    {
+        UpdateJointMatrices(g_JointMatrices, SlotIndex);
+    }
+
+    g_UpdatedSkeletons.assign(std::size(g_Skeletons), 0U);
+
+    g_SkinningConstants = SkinningConstants {
+            .SourceAddress = GetBufferDeviceAddress(GetAllocationBuffer()),
+            .OutputAddress = GetBufferDeviceAddress(g_SkinnedVertexBuffer.Buffer),
+            .JointsAddress = GetBufferDeviceAddress(g_JointMatrixBuffer.Buffer),
+            .JobsAddress = GetBufferDeviceAddress(g_SkinningJobBuffer.Buffer),
+            .NumJobs = static_cast<std::uint32_t>(std::size(Jobs)),
+            .NumVertices = NumVertices
+    };
+}
+
+void RenderCore::ReleaseSkinningResources()
+{
+    VmaAllocator const &Allocator = GetAllocator();
+
+    g_SkinnedVertexBuffer.DestroyResources(Allocator);
+    g_JointMatrixBuffer.DestroyResources(Allocator);
+    g_SkinningJobBuffer.DestroyResources(Allocator);
+
+    g_Skeletons.clear();
+    g_UpdatedSkeletons.clear();
+    g_SkinPalettes.clear();
+    g_JointMatrices.clear();
+    g_JointSlotSize     = 0U;
+    g_SkinningConstants = SkinningConstants {};
+}
+
+// Must run on the thread that animates the skeletons, with the frame state capture: only the palettes of moved skeletons are evaluated
+void RenderCore::CaptureJointMatrices(std::vector<glm::mat4> &Output)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    for (std::size_t SkeletonIndex = 0U; SkeletonIndex < std::size(g_Skeletons); ++SkeletonIndex)
+    {
+        g_UpdatedSkeletons.at(SkeletonIndex) = g_Skeletons.at(SkeletonIndex)->UpdateGlobalMatrices() ? 1U : 0U;
+    }
+
+    for (SkinPalette const &PaletteIt : g_SkinPalettes)
+    {
+        if (g_UpdatedSkeletons.at(PaletteIt.SkeletonIndex) != 0U)
+        {
+            UpdateSkinPalette(PaletteIt);
+        }
+    }
+
+    Output.assign(std::begin(g_JointMatrices), std::end(g_JointMatrices));
+}
+
+// A state captured before the skinned objects were rebuilt doesn't match the palettes, and the slot keeps its last joints
+void RenderCore::UpdateJointMatrices(std::span<glm::mat4 const> const Matrices, std::uint32_t const ImageIndex)
+{
+    if (!g_JointMatrixBuffer.IsValid() || std::empty(Matrices) || std::size(Matrices) != std::size(g_JointMatrices))
+    {
+        return;
+    }
+
+    void *const Slot = static_cast<unsigned char *>(g_JointMatrixBuffer.MappedData) + ImageIndex * g_JointSlotSize;
+    std::memcpy(Slot, std::data(Matrices), Matrices.size_bytes());
+}
+
+void RenderCore::RecordSkinning(VkCommandBuffer const &CommandBuffer, std::uint32_t const ImageIndex)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    // The posed vertices may still be read by the previous frame, either as vertex input or in the visibility resolve
+    VkBufferMemoryBarrier2 VertexBarrier {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .srcAccessMask = VK_ACCESS_2_NONE,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = g_SkinnedVertexBuffer.Buffer,
+            .offset = 0U,
+            .size = VK_WHOLE_SIZE
+    };
+
+    VkDependencyInfo const DependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = 1U,
+            .pBufferMemoryBarriers = &VertexBarrier
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+
+    SkinningConstants Constants = g_SkinningConstants;
+    Constants.JointsAddress += ImageIndex * g_JointSlotSize;
+
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, GetSkinningPipeline());
+    vkCmdPushConstants(CommandBuffer, GetSkinningLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0U, sizeof(SkinningConstants), &Constants);
+
+    // Every skinned object in a single dispatch
+    vkCmdDispatch(CommandBuffer, (Constants.NumVertices + g_SkinningGroupSize - 1U) / g_SkinningGroupSize, 1U, 1U);
+
+    VertexBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    VertexBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    VertexBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    VertexBarrier.dstAccessMask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+}
+
+bool RenderCore::IsSkinningActive()
+{
+    return GetSkinningPipeline() != VK_NULL_HANDLE && g_SkinnedVertexBuffer.IsValid();
+}
+
+std::vector<std::shared_ptr<Skeleton>> const &RenderCore::GetSkinnedSkeletons()
+{
+    return g_Skeletons;
+}
@@ -0,0 +1,344 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.StressScene;
+
+import RenderCore.Runtime.Command;
+import RenderCore.Runtime.Device;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Scene;
+import RenderCore.Factories.Texture;
+import RenderCore.Types.Illumination;
+import RenderCore.Types.Material;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Resource;
+import RenderCore.Types.Texture;
+import RenderCore.Types.Transform;
+import RenderCore.Types.Vertex;
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.Logger;
+
+using namespace RenderCore;
+
+constexpr strzilla::string_view g_StressScenePath { "StressScene" };
+
+class StressSceneRandom
+{
+    std::uint32_t m_State { 1U };
+
+public:
+    explicit StressSceneRandom(std::uint32_t const Seed)
+        : m_State(Seed == 0U ? 1U : Seed)
+    {
+    }
+
+    [[nodiscard]] float Next(float const Min, float const Max)
+    {
+        m_State ^= m_State << 13U;
+        m_State ^= m_State >> 17U;
+        m_State ^= m_State << 5U;
+
+        return Min + static_cast<float>(m_State >> 8U) / static_cast<float>(1U << 24U) * (Max - Min);
+    }
+};
+
+StressSceneObject::StressSceneObject(std::uint32_t const         ID,
+                                     strzilla::string_view const Path,
+                                     glm::vec3 const &           Origin,
+                                     float const                 OrbitRadius,
+                                     float const                 OrbitSpeed,
+                                     float const                 Phase)
+    : Object(ID, Path)
+  , m_Origin(Origin)
+  , m_OrbitRadius(OrbitRadius)
+  , m_OrbitSpeed(OrbitSpeed)
+  , m_Phase(Phase)
+{
+}
+
+void StressSceneObject::Tick(double const DeltaTime)
+{
+    m_ElapsedTime += DeltaTime;
+
+    float const Angle = static_cast<float>(m_ElapsedTime) * m_OrbitSpeed + m_Phase;
+
+    SetPosition(m_Origin + glm::vec3(std::cos(Angle), 0.F, std::sin(Angle)) * m_OrbitRadius);
+    SetRotation(glm::vec3(0.F, glm::degrees(Angle), 0.F));
+}
+
+std::shared_ptr<Mesh> GenerateStressMesh(std::uint32_t const MeshIndex, std::uint32_t const TrianglesPerMesh, StressSceneRandom &Random)
+{
+    // Displaced UV sphere: 2 * Stacks * Slices triangles, with Slices = 2 * Stacks
+    auto const Stacks = std::max(2U, static_cast<std::uint32_t>(std::sqrt(static_cast<float>(TrianglesPerMesh) / 4.F)));
+    auto const Slices = std::max(3U, TrianglesPerMesh / (2U * Stacks));
+
+    float const Amplitude      = Random.Next(0.05F, 0.3F);
+    float const StackFrequency = Random.Next(1.F, 8.F);
+    float const SliceFrequency = std::floor(Random.Next(1.F, 8.F));
+    float const Offset         = Random.Next(0.F, glm::two_pi<float>());
+
+    std::vector<Vertex> Vertices {};
+    Vertices.reserve((Stacks + 1U) * (Slices + 1U));
+
+    for (std::uint32_t StackIt = 0U; StackIt <= Stacks; ++StackIt)
+    {
+        float const V     = static_cast<float>(StackIt) / static_cast<float>(Stacks);
+        float const Theta = V * glm::pi<float>();
+
+        for (std::uint32_t SliceIt = 0U; SliceIt <= Slices; ++SliceIt)
+        {
+            float const U   = static_cast<float>(SliceIt) / static_cast<float>(Slices);
+            float const Phi = U * glm::two_pi<float>();
+
+            glm::vec3 const Direction { std::sin(Theta) * std::cos(Phi), std::cos(Theta), std::sin(Theta) * std::sin(Phi) };
+            float const     Radius = 1.F + Amplitude * std::sin(StackFrequency * Theta + Offset) * std::cos(SliceFrequency * Phi);
+
+            Vertices.push_back(Vertex {
+                    .Position = Direction * Radius,
+                    .Normal = Direction,
+                    .TextureCoordinate = glm::vec2(U, V),
+                    .Color = glm::vec4(1.F),
+                    .Tangent = glm::vec4(-std::sin(Phi), 0.F, std::cos(Phi), 1.F)
+            });
+        }
+    }
+
+    std::vector<std::uint32_t> Indices {};
+    Indices.reserve(Stacks * Slices * 6U);
+
+    for (std::uint32_t StackIt = 0U; StackIt < Stacks; ++StackIt)
+    {
+        for (std::uint32_t SliceIt = 0U; SliceIt < Slices; ++SliceIt)
+        {
+            std::uint32_t const Top    = StackIt * (Slices + 1U) + SliceIt;
+            std::uint32_t const Bottom = Top + Slices + 1U;
+
+            Indices.insert(std::end(Indices), { Top, Bottom, Top + 1U, Top + 1U, Bottom, Bottom + 1U });
+        }
+    }
+
+    strzilla::string const MeshName = std::format("StressMesh_{:03d}", MeshIndex);
+    auto                   NewMesh  = MakePooledResource<Mesh>(FetchID(), g_StressScenePath, MeshName);
+
+    NewMesh->SetVertices(std::move(Vertices));
+    NewMesh->SetIndices(std::move(Indices));
+    NewMesh->Optimize();
+    NewMesh->SetupBounds();
+
+    return NewMesh;
+}
+
+std::shared_ptr<Texture> GenerateCheckerTexture(std::uint32_t const                  TextureIndex,
+                                                std::uint32_t const                  TextureSize,
+                                                StressSceneRandom &                  Random,
+                                                VkCommandBuffer const &              CommandBuffer,
+                                                TextureConstructionOutputParameters &Output)
+{
+    constexpr std::uint32_t NumCells { 8U };
+    std::uint32_t const     CellSize = std::max(1U, TextureSize / NumCells);
+
+    std::array<std::array<std::uint8_t, 4U>, 2U> Colors {};
+
+    for (auto &ColorIt : Colors)
+    {
+        ColorIt = {
+                static_cast<std::uint8_t>(Random.Next(32.F, 255.F)),
+                static_cast<std::uint8_t>(Random.Next(32.F, 255.F)),
+                static_cast<std::uint8_t>(Random.Next(32.F, 255.F)),
+                255U
+        };
+    }
+
+    tinygltf::Image Image {};
+    Image.name      = std::format("StressTexture_{:03d}", TextureIndex);
+    Image.uri       = std::data(g_StressScenePath);
+    Image.width     = static_cast<int>(TextureSize);
+    Image.height    = static_cast<int>(TextureSize);
+    Image.component = 4;
+    Image.image.resize(static_cast<std::size_t>(TextureSize) * TextureSize * 4U);
+
+    for (std::uint32_t Row = 0U; Row < TextureSize; ++Row)
+    {
+        for (std::uint32_t Column = 0U; Column < TextureSize; ++Column)
+        {
+            auto const &Color = Colors.at((Row / CellSize + Column / CellSize) % 2U);
+            std::ranges::copy(Color, std::begin(Image.image) + (static_cast<std::size_t>(Row) * TextureSize + Column) * 4U);
+        }
+    }
+
+    std::shared_ptr<Texture> NewTexture = ConstructTexture(TextureConstructionInputParameters {
+                                                                   .ID = FetchID(),
+                                                                   .Image = Image,
+                                                                   .AllocationCmdBuffer = CommandBuffer
+                                                           },
+                                                           Output);
+
+    if (NewTexture)
+    {
+        NewTexture->AppendType(TextureType::BaseColor);
+    }
+
+    return NewTexture;
+}
+
+void RenderCore::GenerateStressScene(StressSceneSettings const &Settings)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    auto const Start = std::chrono::steady_clock::now();
+
+    StressSceneRandom Random { Settings.Seed };
+
+    std::uint32_t const NumMeshes    = std::max(Settings.NumMeshes, 1U);
+    std::uint32_t const NumMaterials = std::max(Settings.NumMaterials, 1U);
+    std::uint32_t const TextureSize  = std::clamp(Settings.TextureSize, 8U, 4096U);
+    std::uint32_t const NumMoving    = static_cast<std::uint32_t>(static_cast<float>(Settings.NumObjects) * std::clamp(Settings.MovingFraction, 0.F, 1.F));
+
+    std::vector<MaterialData> Materials {};
+    Materials.reserve(NumMaterials);
+
+    for (std::uint32_t MaterialIt = 0U; MaterialIt < NumMaterials; ++MaterialIt)
+    {
+        Materials.push_back(MaterialData {
+                .BaseColorFactor = glm::vec4(Random.Next(0.4F, 1.F), Random.Next(0.4F, 1.F), Random.Next(0.4F, 1.F), 1.F),
+                .EmissiveFactor = glm::vec3(0.F),
+                .MetallicFactor = Random.Next(0.F, 1.F),
+                .RoughnessFactor = Random.Next(0.1F, 1.F),
+                .AlphaCutoff = 0.5F,
+                .NormalScale = 1.F,
+                .OcclusionStrength = 1.F,
+                .AlphaMode = AlphaMode::ALPHA_OPAQUE,
+                .DoubleSided = false
+        });
+    }
+
+    VkCommandPool                CommandPool { VK_NULL_HANDLE };
+    std::vector<VkCommandBuffer> CommandBuffers { VK_NULL_HANDLE };
+
+    auto const &                                [QueueIndex, Queue] = GetGraphicsQueue();
+    std::unordered_map<VkBuffer, VmaAllocation> BufferAllocations {};
+    std::vector<std::shared_ptr<Texture>>       Textures {};
+
+    InitializeSingleCommandQueue(CommandPool, CommandBuffers, QueueIndex);
+    {
+        VkCommandBuffer const &CommandBuffer = CommandBuffers.at(0U);
+
+        for (std::uint32_t TextureIt = 0U; TextureIt < Settings.NumTextures; ++TextureIt)
+        {
+            TextureConstructionOutputParameters Output {};
+
+            if (std::shared_ptr<Texture> NewTexture = GenerateCheckerTexture(TextureIt, TextureSize, Random, CommandBuffer, Output);
+                NewTexture)
+            {
+                Textures.push_back(std::move(NewTexture));
+                BufferAllocations.emplace(Output.StagingBuffer, Output.StagingAllocation);
+            }
+        }
+
+        std::vector<std::shared_ptr<Mesh>> Meshes {};
+        Meshes.reserve(NumMeshes);
+
+        for (std::uint32_t MeshIt = 0U; MeshIt < NumMeshes; ++MeshIt)
+        {
+            std::shared_ptr<Mesh> NewMesh = GenerateStressMesh(MeshIt, std::max(Settings.TrianglesPerMesh, 8U), Random);
+            NewMesh->SetMaterialData(Materials.at(MeshIt % NumMaterials));
+
+            if (!std::empty(Textures))
+            {
+                NewMesh->SetTextures({ Textures.at(MeshIt % std::size(Textures)) });
+            }
+
+            Meshes.push_back(std::move(NewMesh));
+        }
+
+        std::vector<std::shared_ptr<Object>> &Objects = GetObjects();
+        Objects.reserve(std::size(Objects) + Settings.NumObjects);
+
+        float const Extent = std::max(Settings.SceneExtent, 1.F);
+
+        for (std::uint32_t ObjectIt = 0U; ObjectIt < Settings.NumObjects; ++ObjectIt)
+        {
+            glm::vec3 const Position { Random.Next(-Extent, Extent), Random.Next(-Extent, Extent) * 0.25F, Random.Next(-Extent, Extent) };
+
+            // Spread the moving objects evenly through the scene instead of grouping them at the beginning
+            bool const IsMoving = (static_cast<std::uint64_t>(ObjectIt) + 1U) * NumMoving / Settings.NumObjects >
+                                  static_cast<std::uint64_t>(ObjectIt) * NumMoving / Settings.NumObjects;
+
+            std::shared_ptr<Object> NewObject { nullptr };
+
+            if (IsMoving)
+            {
+                float const OrbitRadius = Random.Next(1.F, 10.F);
+                float const OrbitSpeed  = Random.Next(0.25F, 2.F);
+                float const Phase       = Random.Next(0.F, glm::two_pi<float>());
+
+                NewObject = MakePooledResource<StressSceneObject>(FetchID(), g_StressScenePath, Position, OrbitRadius, OrbitSpeed, Phase);
+            }
+            else
+            {
+                NewObject = MakePooledResource<Object>(FetchID(), g_StressScenePath);
+            }
+
+            NewObject->SetPosition(Position);
+            NewObject->SetRotation(glm::vec3(0.F, Random.Next(0.F, 360.F), 0.F));
+            NewObject->SetScale(glm::vec3(Random.Next(0.5F, 2.F)));
+            NewObject->SetMesh(Meshes.at(ObjectIt % NumMeshes));
+
+            if (Settings.NumInstances > 1U)
+            {
+                NewObject->SetNumInstance(Settings.NumInstances);
+
+                for (std::uint32_t InstanceIt = 0U; InstanceIt < Settings.NumInstances; ++InstanceIt)
+                {
+                    Transform InstanceTransform {};
+                    InstanceTransform.SetPosition(glm::vec3(static_cast<float>(InstanceIt) * 2.5F, 0.F, 0.F));
+                    NewObject->SetInstanceTransform(InstanceIt, InstanceTransform);
+                }
+            }
+
+            Objects.push_back(std::move(NewObject));
+        }
+
+        AllocateModelsBuffers(Objects);
+    }
+    FinishSingleCommandQueue(Queue, CommandPool, CommandBuffers);
+
+    // The stress scene owns the point lights, so the ones of a previous scene don't leak into the next one
+    Illumination &Illumination = GetIllumination();
+    Illumination.ClearPointLights();
+
+    float const Extent = std::max(Settings.SceneExtent, 1.F);
+
+    for (std::uint32_t LightIt = 0U; LightIt < Settings.NumPointLights; ++LightIt)
+    {
+        glm::vec3 const Position { Random.Next(-Extent, Extent), Random.Next(-Extent, Extent) * 0.25F, Random.Next(-Extent, Extent) };
+
+        Illumination.AddPointLight(PointLight {
+                .Position = Position,
+                .Radius = Random.Next(10.F, 30.F),
+                .Color = glm::vec3(Random.Next(0.2F, 1.F), Random.Next(0.2F, 1.F), Random.Next(0.2F, 1.F)),
+                .Intensity = Random.Next(50.F, 200.F)
+        });
+    }
+
+    VmaAllocator const &Allocator = GetAllocator();
+    for (auto &[Buffer, Allocation] : BufferAllocations)
+    {
+        vmaDestroyBuffer(Allocator, Buffer, Allocation);
+    }
+
+    double const ElapsedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+    RENDERCORE_LOG(info,
+                   "Generated {} objects ({} moving), {} meshes, {} materials, {} textures, {} point lights in {:.3f} ms",
+                   Settings.NumObjects,
+                   NumMoving,
+                   NumMeshes,
+                   std::min(NumMeshes, NumMaterials),
+                   std::size(Textures),
+                   Settings.NumPointLights,
+                   ElapsedTime);
+}
@@ -12,6 +12,8 @@ import RenderCore.Runtime.Instance;
 import RenderCore.Runtime.Synchronization;
 import RenderCore.Runtime.Memory;
 import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.AllocationCallbacks;
 
 using namespace RenderCore;
 
@@ -31,7 +33,7 @@ void RenderCore::CreateSwapChain(SurfaceProperties const &SurfaceProperties, VkS
             .imageColorSpace = g_CachedProperties.Format.colorSpace,
             .imageExtent = g_CachedProperties.Extent,
             .imageArrayLayers = 1U,
-            .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+            .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
             .imageSharingMode = QueueFamilyIndicesCount > 1U ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
             .queueFamilyIndexCount = QueueFamilyIndicesCount,
             .pQueueFamilyIndices = std::data(QueueFamilyIndices),
@@ -44,11 +46,11 @@ void RenderCore::CreateSwapChain(SurfaceProperties const &SurfaceProperties, VkS
 
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
-    CheckVulkanResult(vkCreateSwapchainKHR(LogicalDevice, &SwapChainCreateInfo, nullptr, &g_SwapChain));
+    CheckVulkanResult(vkCreateSwapchainKHR(LogicalDevice, &SwapChainCreateInfo, GetAllocationCallbacks(HostAllocationTag::SwapChain), &g_SwapChain));
 
     if (g_OldSwapChain != VK_NULL_HANDLE)
     {
-        vkDestroySwapchainKHR(LogicalDevice, g_OldSwapChain, nullptr);
+        vkDestroySwapchainKHR(LogicalDevice, g_OldSwapChain, GetAllocationCallbacks(HostAllocationTag::SwapChain));
         g_OldSwapChain = VK_NULL_HANDLE;
     }
 
@@ -74,6 +76,8 @@ void RenderCore::CreateSwapChain(SurfaceProperties const &SurfaceProperties, VkS
 
 bool RenderCore::RequestSwapChainImage(std::uint32_t &Output)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     VkDevice const &   LogicalDevice = GetLogicalDevice();
     std::uint8_t const SyncIndex     = Output + 1U >= g_ImageCount ? 0U : Output + 1U;
     VkSemaphore const &Semaphore     = GetImageAvailableSemaphore(SyncIndex);
@@ -99,6 +103,8 @@ void RenderCore::CreateSwapChainImageViews(std::array<ImageAllocation, g_ImageCo
 
 void RenderCore::PresentFrame(std::uint32_t const ImageIndice)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     VkPresentInfoKHR const PresentInfo {
             .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
             .waitSemaphoreCount = 1U,
@@ -122,13 +128,13 @@ void RenderCore::ReleaseSwapChainResources()
 
     if (g_SwapChain != VK_NULL_HANDLE)
     {
-        vkDestroySwapchainKHR(LogicalDevice, g_SwapChain, nullptr);
+        vkDestroySwapchainKHR(LogicalDevice, g_SwapChain, GetAllocationCallbacks(HostAllocationTag::SwapChain));
         g_SwapChain = VK_NULL_HANDLE;
     }
 
     if (g_OldSwapChain != VK_NULL_HANDLE)
     {
-        vkDestroySwapchainKHR(LogicalDevice, g_OldSwapChain, nullptr);
+        vkDestroySwapchainKHR(LogicalDevice, g_OldSwapChain, GetAllocationCallbacks(HostAllocationTag::SwapChain));
         g_OldSwapChain = VK_NULL_HANDLE;
     }
 
@@ -10,6 +10,7 @@ import RenderCore.Renderer;
 import RenderCore.Runtime.Device;
 import RenderCore.Runtime.Command;
 import RenderCore.Utils.Helpers;
+import RenderCore.Utils.AllocationCallbacks;
 
 using namespace RenderCore;
 
@@ -35,18 +36,18 @@ void RenderCore::CreateSynchronizationObjects()
     constexpr VkSemaphoreCreateInfo SemaphoreCreateInfo { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
     for (auto &Semaphore : g_ImageAvailableSemaphores)
     {
-        CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &Semaphore));
+        CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, GetAllocationCallbacks(HostAllocationTag::Synchronization), &Semaphore));
     }
 
     for (auto &Semaphore : g_RenderFinishedSemaphores)
     {
-        CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &Semaphore));
+        CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, GetAllocationCallbacks(HostAllocationTag::Synchronization), &Semaphore));
     }
 
     constexpr VkFenceCreateInfo FenceCreateInfo { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, .flags = VK_FENCE_CREATE_SIGNALED_BIT };
     for (auto &Fence : g_Fences)
     {
-        CheckVulkanResult(vkCreateFence(LogicalDevice, &FenceCreateInfo, nullptr, &Fence));
+        CheckVulkanResult(vkCreateFence(LogicalDevice, &FenceCreateInfo, GetAllocationCallbacks(HostAllocationTag::Synchronization), &Fence));
     }
 
     CheckVulkanResult(vkResetFences(LogicalDevice, static_cast<std::uint32_t>(std::size(g_Fences)), data(g_Fences)));
@@ -61,7 +62,7 @@ void RenderCore::ReleaseSynchronizationObjects()
     {
         if (Semaphore != VK_NULL_HANDLE)
         {
-            vkDestroySemaphore(LogicalDevice, Semaphore, nullptr);
+            vkDestroySemaphore(LogicalDevice, Semaphore, GetAllocationCallbacks(HostAllocationTag::Synchronization));
             Semaphore = VK_NULL_HANDLE;
         }
     }
@@ -70,7 +71,7 @@ void RenderCore::ReleaseSynchronizationObjects()
     {
         if (Semaphore != VK_NULL_HANDLE)
         {
-            vkDestroySemaphore(LogicalDevice, Semaphore, nullptr);
+            vkDestroySemaphore(LogicalDevice, Semaphore, GetAllocationCallbacks(HostAllocationTag::Synchronization));
             Semaphore = VK_NULL_HANDLE;
         }
     }
@@ -79,7 +80,7 @@ void RenderCore::ReleaseSynchronizationObjects()
     {
         if (Fence != VK_NULL_HANDLE)
         {
-            vkDestroyFence(LogicalDevice, Fence, nullptr);
+            vkDestroyFence(LogicalDevice, Fence, GetAllocationCallbacks(HostAllocationTag::Synchronization));
             Fence = VK_NULL_HANDLE;
         }
     }
@@ -98,8 +99,8 @@ void RenderCore::ResetSemaphores()
     {
         if (Semaphore != VK_NULL_HANDLE)
         {
-            vkDestroySemaphore(LogicalDevice, Semaphore, nullptr);
-            CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &Semaphore));
+            vkDestroySemaphore(LogicalDevice, Semaphore, GetAllocationCallbacks(HostAllocationTag::Synchronization));
+            CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, GetAllocationCallbacks(HostAllocationTag::Synchronization), &Semaphore));
         }
     }
 
@@ -107,8 +108,8 @@ void RenderCore::ResetSemaphores()
     {
         if (Semaphore != VK_NULL_HANDLE)
         {
-            vkDestroySemaphore(LogicalDevice, Semaphore, nullptr);
-            CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &Semaphore));
+            vkDestroySemaphore(LogicalDevice, Semaphore, GetAllocationCallbacks(HostAllocationTag::Synchronization));
+            CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, GetAllocationCallbacks(HostAllocationTag::Synchronization), &Semaphore));
         }
     }
 }
@@ -0,0 +1,171 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.VisibilityBuffer;
+
+import RenderCore.Renderer;
+import RenderCore.Runtime.Device;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Skinning;
+import RenderCore.Types.Mesh;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+// Both buffers only change when the scene is reloaded, which goes through a pipeline refresh
+VisibilityResolveConstants g_ResolveConstants {};
+
+void RenderCore::UpdateVisibilityObjects(std::vector<std::shared_ptr<Object>> const &Objects)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    VmaAllocator const &Allocator  = GetAllocator();
+    VkDeviceSize const  BufferSize = std::max<VkDeviceSize>(std::size(Objects), 1U) * sizeof(GPUVisibilityObject);
+
+    if (g_VisibilityObjectBuffer.Size < BufferSize)
+    {
+        constexpr VkBufferUsageFlags UsageFlags = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        g_VisibilityObjectBuffer.DestroyResources(Allocator);
+
+        g_VisibilityObjectBuffer.Size = BufferSize;
+        CreateBuffer(BufferSize, UsageFlags, "VISIBILITY_OBJECTS", g_VisibilityObjectBuffer.Buffer, g_VisibilityObjectBuffer.Allocation);
+        vmaMapMemory(Allocator, g_VisibilityObjectBuffer.Allocation, &g_VisibilityObjectBuffer.MappedData);
+    }
+
+    // Indexed as the draws are: the visibility pass writes the index of the object in the scene list
+    auto *const Output = static_cast<GPUVisibilityObject *>(g_VisibilityObjectBuffer.MappedData);
+
+    for (std::size_t ObjectIndex = 0U; ObjectIndex < std::size(Objects); ++ObjectIndex)
+    {
+        std::shared_ptr<Object> const &ObjectIt = Objects.at(ObjectIndex);
+        std::shared_ptr<Mesh> const &  MeshIt   = ObjectIt->GetMesh();
+        bool const                     IsPosed  = ObjectIt->IsSkinned() && IsSkinningActive();
+
+        Output[ObjectIndex] = GPUVisibilityObject {
+                .VertexOffset = IsPosed
+                                    ? static_cast<std::uint32_t>(ObjectIt->GetSkinnedVertexOffset())
+                                    : MeshIt
+                                          ? static_cast<std::uint32_t>(MeshIt->GetVertexOffset())
+                                          : 0U,
+                .IndexOffset = MeshIt ? static_cast<std::uint32_t>(MeshIt->GetIndexOffset()) : 0U,
+                .UniformOffset = ObjectIt->GetUniformOffset(),
+                .IsSkinned = IsPosed ? 1U : 0U
+        };
+    }
+
+    g_ResolveConstants.GeometryAddress = GetBufferDeviceAddress(GetAllocationBuffer());
+    g_ResolveConstants.SkinnedAddress  = GetBufferDeviceAddress(GetSkinnedVertexBuffer().Buffer);
+    g_ResolveConstants.ObjectsAddress  = GetBufferDeviceAddress(g_VisibilityObjectBuffer.Buffer);
+}
+
+void RenderCore::ReleaseVisibilityBufferResources()
+{
+    g_VisibilityObjectBuffer.DestroyResources(GetAllocator());
+    g_ResolveConstants = VisibilityResolveConstants {};
+}
+
+void RenderCore::RecordVisibilityResolve(VkCommandBuffer const &CommandBuffer,
+                                         std::uint32_t const    ImageIndex,
+                                         ImageAllocation const &Visibility,
+                                         ImageAllocation const &Color,
+                                         VkExtent2D const &     RenderExtent)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    PipelineDescriptorData const &DescriptorData = GetPipelineDescriptorData();
+    DescriptorData.WriteVisibilityDescriptors(ImageIndex, Visibility.View, Color.View);
+
+    std::array const BufferBindingInfos {
+            VkDescriptorBufferBindingInfoEXT {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                    .address = DescriptorData.SceneData.BufferDeviceAddress.deviceAddress,
+                    .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+            },
+            VkDescriptorBufferBindingInfoEXT {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                    .address = DescriptorData.VisibilityData.BufferDeviceAddress.deviceAddress,
+                    .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+            },
+            VkDescriptorBufferBindingInfoEXT {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                    .address = DescriptorData.MaterialData.BufferDeviceAddress.deviceAddress,
+                    .usage = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+            }
+    };
+
+    constexpr std::array BufferIndices { 0U, 1U, 2U };
+
+    std::array const BufferOffsets {
+            DescriptorData.SceneData.LayoutOffset,
+            ImageIndex * DescriptorData.VisibilityData.LayoutSize,
+            VkDeviceSize { 0U }
+    };
+
+    VkPipelineLayout const &PipelineLayout = GetVisibilityResolveLayout();
+
+    VisibilityResolveConstants Constants = g_ResolveConstants;
+    Constants.Extent                     = glm::uvec2 { RenderExtent.width, RenderExtent.height };
+
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, GetVisibilityResolvePipeline());
+    vkCmdBindDescriptorBuffersEXT(CommandBuffer, static_cast<std::uint32_t>(std::size(BufferBindingInfos)), std::data(BufferBindingInfos));
+
+    vkCmdSetDescriptorBufferOffsetsEXT(CommandBuffer,
+                                       VK_PIPELINE_BIND_POINT_COMPUTE,
+                                       PipelineLayout,
+                                       0U,
+                                       static_cast<std::uint32_t>(std::size(BufferIndices)),
+                                       std::data(BufferIndices),
+                                       std::data(BufferOffsets));
+
+    vkCmdPushConstants(CommandBuffer, PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0U, sizeof(VisibilityResolveConstants), &Constants);
+
+    vkCmdDispatch(CommandBuffer,
+                  (RenderExtent.width + g_VisibilityResolveGroupSize - 1U) / g_VisibilityResolveGroupSize,
+                  (RenderExtent.height + g_VisibilityResolveGroupSize - 1U) / g_VisibilityResolveGroupSize,
+                  1U);
+}
+
+// Same size blit: only converts the resolved color to the format of the scene target
+void RenderCore::RecordVisibilityCopy(VkCommandBuffer const &CommandBuffer,
+                                      ImageAllocation const &Source,
+                                      ImageAllocation const &Target,
+                                      VkExtent2D const &     RenderExtent)
+{
+    VkOffset3D const Extent { static_cast<std::int32_t>(RenderExtent.width), static_cast<std::int32_t>(RenderExtent.height), 1 };
+
+    VkImageBlit2 const BlitRegion {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2,
+            .srcSubresource = { .aspectMask = g_ImageAspect, .mipLevel = 0U, .baseArrayLayer = 0U, .layerCount = 1U },
+            .srcOffsets = { VkOffset3D { 0, 0, 0 }, Extent },
+            .dstSubresource = { .aspectMask = g_ImageAspect, .mipLevel = 0U, .baseArrayLayer = 0U, .layerCount = 1U },
+            .dstOffsets = { VkOffset3D { 0, 0, 0 }, Extent }
+    };
+
+    VkBlitImageInfo2 const BlitInfo {
+            .sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2,
+            .srcImage = Source.Image,
+            .srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .dstImage = Target.Image,
+            .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .regionCount = 1U,
+            .pRegions = &BlitRegion,
+            .filter = VK_FILTER_NEAREST
+    };
+
+    vkCmdBlitImage2(CommandBuffer, &BlitInfo);
+}
+
+bool RenderCore::IsVisibilityBufferActive()
+{
+    PipelineDescriptorData const &DescriptorData = GetPipelineDescriptorData();
+
+    return Renderer::GetUseVisibilityBuffer() && IsVisibilityBufferSupported() && GetVisibilityPipeline() != VK_NULL_HANDLE &&
+           GetVisibilityResolvePipeline() != VK_NULL_HANDLE && DescriptorData.VisibilityData.IsValid() && DescriptorData.MaterialData.IsValid() &&
+           g_VisibilityObjectBuffer.IsValid();
+}
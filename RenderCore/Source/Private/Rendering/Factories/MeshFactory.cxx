@@ -7,21 +7,38 @@ module;
 module RenderCore.Factories.Mesh;
 
 import RenderCore.Runtime.Model;
+import RenderCore.Types.Resource;
+import RenderCore.Utils.Profiler;
 
 using namespace RenderCore;
 
 std::shared_ptr<Mesh> RenderCore::ConstructMesh(MeshConstructionInputParameters const &Arguments)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     if (Arguments.Primitive.material < 0)
     {
         return nullptr;
     }
 
-    strzilla::string const MeshName = std::format("{}_{:03d}", std::empty(Arguments.Mesh.name) ? "None" : Arguments.Mesh.name, Arguments.ID);
-    auto              NewMesh  = std::make_shared<Mesh>(Arguments.ID, Arguments.Path, MeshName);
+    // The ID is kept apart from the interned name, as it's unique to every mesh ever loaded
+    strzilla::string_view const MeshName = std::empty(Arguments.Mesh.name)
+                                               ? "None"
+                                               : strzilla::string_view { std::data(Arguments.Mesh.name), std::size(Arguments.Mesh.name) };
+
+    auto const NewMesh = MakePooledResource<Mesh>(Arguments.ID, Arguments.Path, MeshName, Arguments.ID);
+    SetVertexAttributes(NewMesh, Arguments.Model, Arguments.Primitive, Arguments.TransientResource);
+
+    // glTF ignores the transform of a skinned mesh's node: its joints place it
+    if (Arguments.Node.skin >= 0)
+    {
+        SetPrimitiveTransform(NewMesh, tinygltf::Node {});
+    }
+    else
+    {
+        SetPrimitiveTransform(NewMesh, Arguments.Node);
+    }
 
-    SetVertexAttributes(NewMesh, Arguments.Model, Arguments.Primitive);
-    SetPrimitiveTransform(NewMesh, Arguments.Node);
     AllocatePrimitiveIndices(NewMesh, Arguments.Model, Arguments.Primitive);
 
     tinygltf::Material const &MeshMaterial = Arguments.Model.materials.at(Arguments.Primitive.material);
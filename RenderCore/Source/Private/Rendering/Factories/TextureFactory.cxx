@@ -10,19 +10,25 @@ module RenderCore.Factories.Texture;
 
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Scene;
+import RenderCore.Utils.Profiler;
 
 using namespace RenderCore;
 
 std::shared_ptr<Texture> RenderCore::ConstructTexture(TextureConstructionInputParameters const &Parameters,
                                                       TextureConstructionOutputParameters &     Output)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     if (std::empty(Parameters.Image.image))
     {
         return nullptr;
     }
 
-    strzilla::string const TextureName = std::format("{}_{:03d}", std::empty(Parameters.Image.name) ? "None" : Parameters.Image.name, Parameters.ID);
-    auto              NewTexture  = std::shared_ptr<Texture>(new Texture { Parameters.ID, Parameters.Image.uri, TextureName }, TextureDeleter {});
+    strzilla::string_view const TextureName = std::empty(Parameters.Image.name)
+                                                  ? "None"
+                                                  : strzilla::string_view { std::data(Parameters.Image.name), std::size(Parameters.Image.name) };
+
+    auto NewTexture = std::shared_ptr<Texture>(new Texture { Parameters.ID, Parameters.Image.uri, TextureName, Parameters.ID }, TextureDeleter {});
 
     auto [Index, Buffer, Allocation] = AllocateTexture(Parameters.AllocationCmdBuffer,
                                                        std::data(Parameters.Image.image),
@@ -6,29 +6,83 @@ module;
 
 module RenderCore.Renderer;
 
+import RenderCore.Runtime.Animation;
+import RenderCore.Runtime.Capture;
+import RenderCore.Runtime.ClusteredLighting;
 import RenderCore.Runtime.Command;
 import RenderCore.Runtime.Device;
+import RenderCore.Runtime.DynamicResolution;
+import RenderCore.Runtime.FrameState;
+import RenderCore.Runtime.ImageExport;
 import RenderCore.Runtime.Instance;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Model;
 import RenderCore.Runtime.Offscreen;
 import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.RenderGraph;
 import RenderCore.Runtime.Scene;
 import RenderCore.Runtime.ShaderCompiler;
+import RenderCore.Runtime.Skinning;
+import RenderCore.Runtime.StressScene;
 import RenderCore.Runtime.SwapChain;
 import RenderCore.Runtime.Synchronization;
+import RenderCore.Runtime.VisibilityBuffer;
 import RenderCore.Types.Allocation;
+import RenderCore.Types.Illumination;
 import RenderCore.Factories.Texture;
 import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
+import RenderCore.Utils.AllocationCallbacks;
+import RenderCore.Utils.APICalls;
+import RenderCore.Utils.JobGraph;
+import RenderCore.Utils.Logger;
 
 using namespace RenderCore;
 
-void Renderer::DrawFrame(double const DeltaTime)
+std::uint64_t   g_SceneGeneration { 0U };
+SceneFrameState g_LockstepFrameState {};
+FrameStateQueue g_FrameStateQueue {};
+std::jthread    g_RenderThread {};
+
+double GetStartupElapsedTime(std::chrono::steady_clock::time_point const &TimePoint)
 {
-    std::lock_guard const Lock { g_RendererMutex };
+    return std::chrono::duration<double, std::milli>(TimePoint - g_StartupTimePoint).count();
+}
 
-    g_FrameTime = static_cast<float>(DeltaTime);
+template <typename FunctorType>
+void MeasureStartupStep(strzilla::string_view const Name, FunctorType &&Functor)
+{
+    auto const Begin = std::chrono::steady_clock::now();
+    Functor();
+    auto const End = std::chrono::steady_clock::now();
+
+    std::lock_guard const Lock { g_StartupTimingsMutex };
+    g_StartupTimings.push_back(StartupStepTiming {
+            .Name = strzilla::string { Name },
+            .StartOffset = GetStartupElapsedTime(Begin),
+            .Duration = std::chrono::duration<double, std::milli>(End - Begin).count()
+    });
+}
+
+void PrintStartupReport()
+{
+    std::lock_guard const Lock { g_StartupTimingsMutex };
+
+    for (auto const &[Name, StartOffset, Duration] : g_StartupTimings)
+    {
+        RENDERCORE_LOG(info,
+                       "{}: started at {:.3f} ms, took {:.3f} ms",
+                       std::data(Name),
+                       StartOffset,
+                       Duration);
+    }
+
+    RENDERCORE_LOG(info, "Time to first frame: {:.3f} ms", g_TimeToFirstFrame);
+}
 
+// Handles the pending state changes; returns whether the renderer can record a frame
+bool UpdateRendererState()
+{
     DispatchQueue(g_NextTickDispatchQueue);
 
     if (HasAnyFlag(g_ObjectsManagementStateFlags))
@@ -45,9 +99,12 @@ void Renderer::DrawFrame(double const DeltaTime)
     {
         if (HasFlag(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_DESTRUCTION))
         {
+            RENDERCORE_PROFILE_SCOPE("Resources Destruction");
+
             CheckVulkanResult(vkDeviceWaitIdle(GetLogicalDevice()));
 
             g_ImageIndex = g_ImageCount;
+            ++g_SceneGeneration;
 
             for (std::uint8_t Iterator = 0U; Iterator < g_ImageCount; ++Iterator)
             {
@@ -57,6 +114,8 @@ void Renderer::DrawFrame(double const DeltaTime)
             ResetFenceStatus();
             DestroySwapChainImages();
             DestroyOffscreenImages();
+            DestroyScaledColorImage();
+            ReleaseRenderGraphResources();
             ReleasePipelineResources(false);
 
             if (HasAnyFlag(g_ObjectsManagementStateFlags,
@@ -83,7 +142,13 @@ void Renderer::DrawFrame(double const DeltaTime)
                     LoadScene(ModelPath);
                 }
 
+                for (auto const &Settings : g_StressScenesToGenerate)
+                {
+                    GenerateStressScene(Settings);
+                }
+
                 g_ModelsToLoad.clear();
+                g_StressScenesToGenerate.clear();
                 RemoveFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_LOAD);
             }
 
@@ -94,23 +159,47 @@ void Renderer::DrawFrame(double const DeltaTime)
         if (!HasAnyFlag(g_StateFlags, RendererStateFlags::INVALID_SIZE | RendererStateFlags::PENDING_DEVICE_PROPERTIES_UPDATE) &&
             HasFlag(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_CREATION))
         {
+            RENDERCORE_PROFILE_SCOPE("Resources Creation");
+
             auto const SurfaceProperties = GetSurfaceProperties();
 
             if (!SurfaceProperties.IsValid())
             {
                 AddFlags(g_StateFlags, RendererStateFlags::INVALID_SIZE);
-                return;
+                return false;
             }
 
             auto const SurfaceCapabilities = GetSurfaceCapabilities();
+            bool const IsInitializing      = !HasFlag(g_StateFlags, RendererStateFlags::INITIALIZED);
 
-            CreateSwapChain(SurfaceProperties, SurfaceCapabilities);
-            CreateDepthResources(SurfaceProperties);
+            std::future<void> PipelineLibrariesCreation {};
 
-            if (!HasFlag(g_StateFlags, RendererStateFlags::INITIALIZED))
+            if (IsInitializing)
             {
-                SetupPipelineLayouts();
-                CreatePipelineLibraries();
+                PipelineLibrariesCreation = std::async(std::launch::async,
+                                                       [SurfaceProperties]
+                                                       {
+                                                           MeasureStartupStep("Pipeline libraries",
+                                                                              [&SurfaceProperties]
+                                                                              {
+                                                                                  SetupPipelineLayouts();
+                                                                                  CreatePipelineLibraries(SurfaceProperties);
+                                                                                  CreateLightCullingPipeline();
+                                                                                  CreateSkinningPipeline();
+                                                                              });
+                                                       });
+            }
+
+            MeasureStartupStep(IsInitializing ? "Swap chain" : "Swap chain refresh",
+                               [&SurfaceProperties, &SurfaceCapabilities]
+                               {
+                                   CreateSwapChain(SurfaceProperties, SurfaceCapabilities);
+                                   CreateDepthResources(SurfaceProperties);
+                               });
+
+            if (IsInitializing)
+            {
+                PipelineLibrariesCreation.get();
 
                 if (g_OnInitializeCallback)
                 {
@@ -125,6 +214,8 @@ void Renderer::DrawFrame(double const DeltaTime)
                 CreateOffscreenResources(SurfaceProperties);
             }
 
+            CreateScaledColorImage(SurfaceProperties);
+
             if (g_OnRefreshCallback)
             {
                 g_OnRefreshCallback();
@@ -136,29 +227,213 @@ void Renderer::DrawFrame(double const DeltaTime)
 
         if (HasFlag(g_StateFlags, RendererStateFlags::PENDING_PIPELINE_REFRESH))
         {
+            RENDERCORE_PROFILE_SCOPE("Pipeline Refresh");
+
             CreatePipelineDynamicResources();
             PipelineDescriptorData &PipelineDescriptor = GetPipelineDescriptorData();
-            PipelineDescriptor.SetupSceneBuffer(GetSceneUniformBuffer());
+            PipelineDescriptor.SetupSceneBuffer(GetSceneUniformBuffer(), GetPointLightBuffer(), GetClusterBuffer());
             PipelineDescriptor.SetupModelsBuffer(GetObjects());
             SetNumObjectsPerThread(GetNumAllocations());
+            UpdateSkinnedObjects(GetObjects());
+
+            // Only built while enabled and supported by the device: toggling the mode goes through a resources update
+            if (g_UseVisibilityBuffer && IsVisibilityBufferSupported())
+            {
+                CreateVisibilityPipelines();
+                PipelineDescriptor.SetupVisibilityBuffer(GetObjects());
+                UpdateVisibilityObjects(GetObjects());
+            }
 
             RemoveFlags(g_StateFlags, RendererStateFlags::PENDING_PIPELINE_REFRESH);
         }
     }
 
-    if (!HasAnyFlag(g_StateFlags, InvalidStatesToRender) && RequestSwapChainImage(g_ImageIndex))
+    return !HasAnyFlag(g_StateFlags, InvalidStatesToRender);
+}
+
+void PresentRecordedFrame()
+{
+    SubmitCommandBuffers(g_ImageIndex);
+    PresentFrame(g_ImageIndex);
+
+    if (g_TimeToFirstFrame <= 0.)
     {
+        g_TimeToFirstFrame = GetStartupElapsedTime(std::chrono::steady_clock::now());
+        PrintStartupReport();
+    }
+}
+
+// A state captured before objects were loaded or unloaded doesn't match the scene indices anymore, so it's dropped
+bool AcquireFrameForState(SceneFrameState const &State)
+{
+    if (UpdateRendererState() && State.SceneGeneration == g_SceneGeneration && RequestSwapChainImage(g_ImageIndex))
+    {
+        return true;
+    }
+
+    RestoreFrameStateDirtiness(State);
+    return false;
+}
+
+void RenderFrameState(SceneFrameState const &State)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    {
+        std::lock_guard const Lock { g_RendererMutex };
+
+        AdvanceAPICallFrame();
+
+        if (!AcquireFrameForState(State))
+        {
+            return;
+        }
+
         if (g_OnDrawCallback)
         {
             g_OnDrawCallback();
         }
+    }
+
+    // Recording only reads the state and the resources owned by this thread, so the application ticks the next frame meanwhile
+    JobGraph &FrameJobGraph = GetFrameJobGraph(g_ImageIndex);
+    FrameJobGraph.Reset();
+
+    if (State.IsSceneDirty)
+    {
+        UpdateSceneUniformBuffer(State.SceneData);
+        UpdateClusteredLighting(State.PointLights, State.SceneData);
+    }
+
+    UpdateJointMatrices(State.JointMatrices, g_ImageIndex);
+    RecordCommandBuffers(g_ImageIndex, State);
+    FrameJobGraph.Wait();
+
+    std::lock_guard const Lock { g_RendererMutex };
+    PresentRecordedFrame();
+}
+
+void RenderThreadLoop(std::stop_token const StopToken)
+{
+    RENDERCORE_PROFILE_THREAD("Frame Render Thread");
+
+    while (!StopToken.stop_requested())
+    {
+        SceneFrameState const *const State = g_FrameStateQueue.BeginRead();
+
+        if (!State)
+        {
+            break;
+        }
+
+        RenderFrameState(*State);
+        g_FrameStateQueue.EndRead();
+    }
+}
+
+// Waits while both states are queued, so the application runs at most one frame ahead of the recording
+void ProduceFrameState(float const DeltaTime)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    SceneFrameState *const State = g_FrameStateQueue.BeginWrite();
+
+    if (!State)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard const Lock { g_RendererMutex };
+
+        g_FrameTime = DeltaTime;
+        Renderer::Tick();
+        TickAnimations(DeltaTime);
+
+        CaptureFrameState(*State, DeltaTime);
+        State->SceneGeneration = g_SceneGeneration;
+    }
+
+    g_FrameStateQueue.EndWrite();
+}
+
+void StopRenderThread()
+{
+    if (!g_RenderThread.joinable())
+    {
+        return;
+    }
+
+    g_RenderThread.request_stop();
+    g_FrameStateQueue.Close();
+    g_RenderThread.join();
+    g_FrameStateQueue.Reset();
+
+    g_UseRenderThread = false;
+}
+
+void Renderer::DrawFrame(double const DeltaTime)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    if (g_UseRenderThread)
+    {
+        ProduceFrameState(static_cast<float>(DeltaTime));
+        return;
+    }
 
-        UpdateSceneUniformBuffer();
-        Tick();
+    std::lock_guard const Lock { g_RendererMutex };
+
+    AdvanceAPICallFrame();
+
+    g_FrameTime = static_cast<float>(DeltaTime);
+
+    if (UpdateRendererState() && RequestSwapChainImage(g_ImageIndex))
+    {
+        if (g_OnDrawCallback)
+        {
+            g_OnDrawCallback();
+        }
 
-        RecordCommandBuffers(g_ImageIndex);
-        SubmitCommandBuffers(g_ImageIndex);
-        PresentFrame(g_ImageIndex);
+        // Tick, animation, state capture and per-batch recording run as the frame graph; this thread starts the primary buffer meanwhile and builds
+        // the render graph once the state is captured
+        JobGraph &FrameJobGraph = GetFrameJobGraph(g_ImageIndex);
+        FrameJobGraph.Reset();
+
+        JobHandle const TickJob    = FrameJobGraph.AddJob("Tick", &Renderer::Tick);
+        JobHandle const CaptureJob = FrameJobGraph.AddContinuation(TickJob,
+                                                                   "CaptureFrameState",
+                                                                   []
+                                                                   {
+                                                                       CaptureFrameState(g_LockstepFrameState, g_FrameTime);
+                                                                   });
+
+        ScheduleAnimations(FrameJobGraph, TickJob, CaptureJob, g_FrameTime);
+
+        FrameJobGraph.AddContinuation(CaptureJob,
+                                      "UpdateSceneUniformBuffer",
+                                      []
+                                      {
+                                          if (g_LockstepFrameState.IsSceneDirty)
+                                          {
+                                              UpdateSceneUniformBuffer(g_LockstepFrameState.SceneData);
+                                              UpdateClusteredLighting(g_LockstepFrameState.PointLights, g_LockstepFrameState.SceneData);
+                                          }
+                                      });
+
+        FrameJobGraph.AddContinuation(CaptureJob,
+                                      "UpdateJointMatrices",
+                                      []
+                                      {
+                                          UpdateJointMatrices(g_LockstepFrameState.JointMatrices, g_ImageIndex);
+                                      });
+
+        FrameJobGraph.Dispatch();
+
+        RecordCommandBuffers(g_ImageIndex, g_LockstepFrameState, CaptureJob);
+        FrameJobGraph.Wait();
+
+        PresentRecordedFrame();
     }
 }
 
@@ -175,20 +450,77 @@ bool Renderer::Initialize()
         return false;
     }
 
-    CheckVulkanResult(volkInitialize());
-    [[maybe_unused]] bool const _ = CreateVulkanInstance();
-    CreateVulkanSurface();
-    InitializeDevice(GetSurface());
-    volkLoadDevice(GetLogicalDevice());
-
-    InitializeCommandsResources(GetGraphicsQueue().first);
-    CreateSynchronizationObjects();
-    CreateMemoryAllocator();
-    CreateSceneUniformBuffer();
-    CreateImageSampler();
-    CompileDefaultShaders();
+    InitializeLogger();
+    RENDERCORE_PROFILE_THREAD("Render Thread");
+
+    {
+        std::lock_guard const Lock { g_StartupTimingsMutex };
+        g_StartupTimings.clear();
+        g_StartupTimePoint = std::chrono::steady_clock::now();
+        g_TimeToFirstFrame = 0.;
+    }
+
+    // Shader compilation and the pipeline cache loading doesn't depend on the device, so they run while the device is being created
+    std::future<void> ShaderCompilation = std::async(std::launch::async,
+                                                     []
+                                                     {
+                                                         MeasureStartupStep("Default shaders", &CompileDefaultShaders);
+                                                     });
+
+    std::future<void> PipelineCacheLoading = std::async(std::launch::async,
+                                                        []
+                                                        {
+                                                            MeasureStartupStep("Pipeline cache loading", &LoadPipelineCacheData);
+                                                        });
+
+    MeasureStartupStep("Instance",
+                       []
+                       {
+                           CheckVulkanResult(volkInitialize());
+                           [[maybe_unused]] bool const _ = CreateVulkanInstance();
+                           CreateVulkanSurface();
+                       });
+
+    MeasureStartupStep("Device",
+                       []
+                       {
+                           InitializeDevice(GetSurface());
+                           volkLoadDevice(GetLogicalDevice());
+                           InstallAPICallHooks();
+                       });
+
+    std::future<void> MemoryInitialization = std::async(std::launch::async,
+                                                        []
+                                                        {
+                                                            MeasureStartupStep("Memory resources",
+                                                                               []
+                                                                               {
+                                                                                   CreateMemoryAllocator();
+                                                                                   CreateSceneUniformBuffer();
+                                                                                   CreateClusteredLightingResources();
+                                                                                   CreateImageSampler();
+                                                                               });
+                                                        });
+
+    MeasureStartupStep("Command resources",
+                       []
+                       {
+                           InitializeCommandsResources(GetGraphicsQueue().first);
+                           CreateSynchronizationObjects();
+                           CreateTimestampQueryPool();
+                       });
+
+    MemoryInitialization.get();
+
     auto const SurfaceProperties = GetSurfaceProperties();
-    AllocateEmptyTexture(SurfaceProperties.Format.format);
+    MeasureStartupStep("Empty texture",
+                       [&SurfaceProperties]
+                       {
+                           AllocateEmptyTexture(SurfaceProperties.Format.format);
+                       });
+
+    ShaderCompilation.get();
+    PipelineCacheLoading.get();
 
     AddFlags(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_CREATION);
 
@@ -202,8 +534,13 @@ void Renderer::Shutdown()
         return;
     }
 
+    StopRenderThread();
+
     std::lock_guard const Lock { g_RendererMutex };
 
+    g_LockstepFrameState.Objects.clear();
+
+    ReleaseImageExportResources();
     ReleaseSynchronizationObjects();
     ReleaseCommandsResources();
 
@@ -213,14 +550,25 @@ void Renderer::Shutdown()
     }
 
     DestroyOffscreenImages();
+    DestroyScaledColorImage();
+    ReleaseRenderGraphResources();
+    ReleaseTimestampQueryPool();
 
     ReleaseSwapChainResources();
     ReleaseShaderResources();
     ReleaseSceneResources();
+    ReleaseClusteredLightingResources();
+    ReleaseVisibilityBufferResources();
+    ReleaseAnimationResources();
+    ReleaseSkinningResources();
+    SavePipelineCacheData();
     ReleasePipelineResources(true);
     ReleaseMemoryResources();
     ReleaseDeviceResources();
     DestroyVulkanInstance();
+    PrintHostAllocationReport();
+    PrintAPICallReport();
+    ShutdownLogger();
 
     g_StateFlags = RendererStateFlags::NONE;
 }
@@ -248,6 +596,28 @@ void Renderer::SetRenderOffscreen(bool const Value)
     RequestUpdateResources();
 }
 
+void Renderer::SetDynamicResolution(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        DynamicResolutionSettings Settings = GetDynamicResolutionSettings();
+        Settings.Enabled                   = Value;
+        SetDynamicResolutionSettings(Settings);
+    });
+
+    RequestUpdateResources();
+}
+
+void Renderer::SetDynamicResolutionTargetGPUTime(float const Milliseconds)
+{
+    DispatchToNextTick([Milliseconds]
+    {
+        DynamicResolutionSettings Settings = GetDynamicResolutionSettings();
+        Settings.TargetGPUTime             = std::max(Milliseconds, 0.1F);
+        SetDynamicResolutionSettings(Settings);
+    });
+}
+
 void Renderer::SetUseDefaultSync(bool const Value)
 {
     DispatchToNextTick([Value]
@@ -261,6 +631,53 @@ void Renderer::SetUseDefaultSync(bool const Value)
     RequestUpdateResources();
 }
 
+// Must be called from the thread that calls DrawFrame; with the render thread, callbacks run on it and DrawFrame only ticks the scene
+void Renderer::SetUseRenderThread(bool const Value)
+{
+    if (g_UseRenderThread == Value)
+    {
+        return;
+    }
+
+    if (Value)
+    {
+        g_FrameStateQueue.Open();
+        g_UseRenderThread = true;
+        g_RenderThread    = std::jthread { &RenderThreadLoop };
+    }
+    else
+    {
+        StopRenderThread();
+    }
+}
+
+// Without the compute light culling pipeline, the clusters are always binned on the host
+void Renderer::SetUseGPULightCulling(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        if (g_UseGPULightCulling != Value)
+        {
+            g_UseGPULightCulling = Value;
+            RenderCore::GetIllumination().SetRenderDirty(true);
+        }
+    });
+}
+
+// The resolve samples the same material maps as the forward path; a scene with more maps than it can index stays on the forward path
+void Renderer::SetUseVisibilityBuffer(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        if (g_UseVisibilityBuffer != Value)
+        {
+            g_UseVisibilityBuffer = Value;
+        }
+    });
+
+    RequestUpdateResources();
+}
+
 std::shared_ptr<Object> Renderer::GetObjectByID(std::uint32_t const ObjectID)
 {
     return *std::ranges::find_if(GetObjects(),
@@ -287,7 +704,54 @@ std::vector<VkImageView> Renderer::GetOffscreenImages()
 void Renderer::SaveOffscreenFrameToImage(strzilla::string_view const Path)
 {
     ImageAllocation const &OffscreenImage = RenderCore::GetOffscreenImages().at(g_ImageIndex);
-    SaveImageToFile(OffscreenImage.Image, Path, OffscreenImage.Extent);
+    SaveImageToFile(OffscreenImage.Image, Path, OffscreenImage.Extent, OffscreenImage.Format);
+}
+
+void Renderer::SaveTiledCaptureToImage(strzilla::string_view const Path, VkExtent2D const &Extent, std::uint32_t const MaxTileSize)
+{
+    DispatchToNextTick([Path = strzilla::string { Path }, Extent, MaxTileSize]
+    {
+        [[maybe_unused]] bool const _ = CaptureTiledImage(Path, TiledCaptureSettings { .Extent = Extent, .MaxTileSize = MaxTileSize });
+    });
+}
+
+// Must be called from the thread that calls DrawFrame: the render thread records outside of the renderer mutex, so it's drained first and stays idle
+// until the next state, which can't be produced during the batch
+bool Renderer::RenderBatch(BatchRenderRequest const &Request)
+{
+    if (g_UseRenderThread)
+    {
+        g_FrameStateQueue.WaitUntilEmpty();
+    }
+
+    std::lock_guard const Lock { g_RendererMutex };
+
+    constexpr RendererStateFlags PendingStates = RendererStateFlags::PENDING_RESOURCES_DESTRUCTION | RendererStateFlags::PENDING_RESOURCES_CREATION |
+                                                 RendererStateFlags::PENDING_PIPELINE_REFRESH;
+
+    if (!HasFlag(g_StateFlags, RendererStateFlags::INITIALIZED) || HasAnyFlag(g_StateFlags, PendingStates))
+    {
+        RENDERCORE_LOG(warning, "Renderer is not ready for batch rendering");
+        return false;
+    }
+
+    return RenderCore::RenderBatch(Request);
+}
+
+std::vector<StartupStepTiming> Renderer::GetStartupTimings()
+{
+    std::lock_guard const Lock { g_StartupTimingsMutex };
+    return g_StartupTimings;
+}
+
+std::vector<APICallStats> Renderer::GetAPICallStats()
+{
+    return RenderCore::GetAPICallStats();
+}
+
+FrameAllocationStats Renderer::GetFrameAllocationStats()
+{
+    return RenderCore::GetFrameAllocationStats();
 }
 
 std::vector<std::shared_ptr<Texture>> Renderer::LoadImages(std::vector<strzilla::string_view> &&Paths)
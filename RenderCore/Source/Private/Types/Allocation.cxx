@@ -7,6 +7,7 @@ module;
 module RenderCore.Types.Allocation;
 
 import RenderCore.Runtime.Device;
+import RenderCore.Utils.AllocationCallbacks;
 
 using namespace RenderCore;
 
@@ -23,7 +24,7 @@ void ImageAllocation::DestroyResources(VmaAllocator const &Allocator)
 
     if (View != VK_NULL_HANDLE)
     {
-        vkDestroyImageView(LogicalDevice, View, nullptr);
+        vkDestroyImageView(LogicalDevice, View, GetAllocationCallbacks(HostAllocationTag::Memory));
         View = VK_NULL_HANDLE;
 
         if (Image != VK_NULL_HANDLE)
@@ -77,7 +78,7 @@ void DescriptorData::DestroyResources(VmaAllocator const &Allocator, bool const
         if (SetLayout != VK_NULL_HANDLE)
         {
             VkDevice const &LogicalDevice = GetLogicalDevice();
-            vkDestroyDescriptorSetLayout(LogicalDevice, SetLayout, nullptr);
+            vkDestroyDescriptorSetLayout(LogicalDevice, SetLayout, GetAllocationCallbacks(HostAllocationTag::Descriptors));
             SetLayout = VK_NULL_HANDLE;
         }
 
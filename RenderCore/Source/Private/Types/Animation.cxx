@@ -0,0 +1,87 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Types.Animation;
+
+using namespace RenderCore;
+
+// The keys are found once for the whole track; the blends below run over contiguous rows of lanes, which the compiler vectorizes
+void AnimationTrack::Sample(float const Time, std::span<float> const Output) const
+{
+    std::size_t const NumKeys = std::size(Times);
+
+    if (NumKeys == 0U || std::size(Output) < NumLanes)
+    {
+        return;
+    }
+
+    float *const       Destination = std::data(Output);
+    float const *const FirstRow    = std::data(Values);
+
+    if (NumKeys == 1U || Time <= Times.front())
+    {
+        std::copy_n(FirstRow, NumLanes, Destination);
+        return;
+    }
+
+    if (Time >= Times.back())
+    {
+        std::copy_n(FirstRow + (NumKeys - 1U) * NumLanes, NumLanes, Destination);
+        return;
+    }
+
+    auto const        NextKey = static_cast<std::size_t>(std::distance(std::begin(Times), std::ranges::upper_bound(Times, Time)));
+    std::size_t const Key     = NextKey - 1U;
+    float const       Delta   = Times.at(NextKey) - Times.at(Key);
+    float const       Factor  = Delta > 0.F ? (Time - Times.at(Key)) / Delta : 0.F;
+
+    float const *const Previous = FirstRow + Key * NumLanes;
+    float const *const Next     = FirstRow + NextKey * NumLanes;
+
+    switch (Interpolation)
+    {
+        case AnimationInterpolation::STEP:
+            std::copy_n(Previous, NumLanes, Destination);
+            break;
+        case AnimationInterpolation::LINEAR:
+            for (std::uint32_t Lane = 0U; Lane < NumLanes; ++Lane)
+            {
+                Destination[Lane] = Previous[Lane] + (Next[Lane] - Previous[Lane]) * Factor;
+            }
+
+            // glTF rotations are interpolated spherically, along the shortest arc: their lanes are written again over the blend above
+            for (AnimationTarget const &TargetIt : Targets)
+            {
+                if (TargetIt.Path != AnimationPath::ROTATION)
+                {
+                    continue;
+                }
+
+                glm::quat const Rotation = glm::slerp(glm::make_quat(Previous + TargetIt.FirstLane), glm::make_quat(Next + TargetIt.FirstLane), Factor);
+                std::copy_n(glm::value_ptr(Rotation), 4U, Destination + TargetIt.FirstLane);
+            }
+            break;
+        case AnimationInterpolation::CUBIC_SPLINE:
+        {
+            // Hermite basis of the glTF spec, the tangents scaled by the duration of the interval
+            float const FactorSquared = Factor * Factor;
+            float const FactorCubed   = FactorSquared * Factor;
+            float const PreviousValue = 2.F * FactorCubed - 3.F * FactorSquared + 1.F;
+            float const PreviousOut   = (FactorCubed - 2.F * FactorSquared + Factor) * Delta;
+            float const NextValue     = -2.F * FactorCubed + 3.F * FactorSquared;
+            float const NextIn        = (FactorCubed - FactorSquared) * Delta;
+
+            float const *const OutTangent = std::data(OutTangents) + Key * NumLanes;
+            float const *const InTangent  = std::data(InTangents) + NextKey * NumLanes;
+
+            for (std::uint32_t Lane = 0U; Lane < NumLanes; ++Lane)
+            {
+                Destination[Lane] = Previous[Lane] * PreviousValue + OutTangent[Lane] * PreviousOut + Next[Lane] * NextValue + InTangent[Lane] * NextIn;
+            }
+            break;
+        }
+    }
+}
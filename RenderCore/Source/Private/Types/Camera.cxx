@@ -37,11 +37,18 @@ glm::mat4 Camera::GetViewMatrix() const
 
 glm::mat4 Camera::GetProjectionMatrix() const
 {
-    VkExtent2D const &SwapChainExtent = GetSwapChainExtent();
-    glm::mat4         Projection      = glm::perspective(glm::radians(m_FieldOfView),
-                                                         static_cast<float>(SwapChainExtent.width) / static_cast<float>(SwapChainExtent.height),
-                                                         m_NearPlane,
-                                                         m_FarPlane);
+    if (VkExtent2D const &SwapChainExtent = GetSwapChainExtent();
+        SwapChainExtent.height > 0U)
+    {
+        m_CurrentAspectRatio = static_cast<float>(SwapChainExtent.width) / static_cast<float>(SwapChainExtent.height);
+    }
+
+    return GetProjectionMatrix(m_CurrentAspectRatio);
+}
+
+glm::mat4 Camera::GetProjectionMatrix(float const AspectRatio) const
+{
+    glm::mat4 Projection = glm::perspective(glm::radians(m_FieldOfView), AspectRatio, m_NearPlane, m_FarPlane);
     Projection[1][1] *= -1;
 
     return Projection;
@@ -183,3 +190,19 @@ bool Camera::CanDrawObject(std::shared_ptr<Object> const &Object) const
 
     return IsInsideCameraFrustum(Object) && IsInAllowedDistance(Object);
 }
+
+bool Camera::CanDrawObject(std::shared_ptr<Object> const &Object, std::array<glm::vec4, 6U> const &FrustumPlanes) const
+{
+    if (Object->IsPendingDestroy() || !IsInAllowedDistance(Object))
+    {
+        return false;
+    }
+
+    Bounds const &MeshBounds = Object->GetMesh()->GetBounds();
+
+    return std::ranges::all_of(FrustumPlanes,
+                               [&MeshBounds](glm::vec4 const &PlaneIt)
+                               {
+                                   return BoxIntersectsPlane(MeshBounds, PlaneIt);
+                               });
+}
@@ -17,32 +17,30 @@ Mesh::Mesh(std::uint32_t const ID, strzilla::string_view const Path)
 {
 }
 
-Mesh::Mesh(std::uint32_t const ID, strzilla::string_view const Path, strzilla::string_view const Name)
-    : Resource(ID, Path, Name)
+Mesh::Mesh(std::uint32_t const ID, strzilla::string_view const Path, strzilla::string_view const Name, std::uint32_t const NameSuffix)
+    : Resource(ID, Path, Name, NameSuffix)
 {
 }
 
-void Mesh::Optimize()
+// The remap table comes from the given resource, and both buffers are remapped in place: the vertices only shrink, so they keep their storage
+void Mesh::Optimize(std::pmr::memory_resource *const TransientResource)
 {
     std::size_t const IndexCount  = m_NumTriangles * 3;
     std::size_t const VertexCount = std::size(m_Vertices);
 
-    std::vector<unsigned int> Remap(IndexCount);
-    std::size_t const         NewVertexCount = meshopt_generateVertexRemap(std::data(Remap),
-                                                                           std::data(m_Indices),
-                                                                           IndexCount,
-                                                                           std::data(m_Vertices),
-                                                                           VertexCount,
-                                                                           sizeof(Vertex));
+    std::pmr::vector<unsigned int> Remap(VertexCount, TransientResource);
+    std::size_t const              NewVertexCount = meshopt_generateVertexRemap(std::data(Remap),
+                                                                                std::data(m_Indices),
+                                                                                IndexCount,
+                                                                                std::data(m_Vertices),
+                                                                                VertexCount,
+                                                                                sizeof(Vertex));
 
-    std::vector<Vertex>       NewVertices(NewVertexCount);
-    std::vector<unsigned int> NewIndices(IndexCount);
+    meshopt_remapIndexBuffer(std::data(m_Indices), std::data(m_Indices), IndexCount, std::data(Remap));
+    meshopt_remapVertexBuffer(std::data(m_Vertices), std::data(m_Vertices), VertexCount, sizeof(Vertex), std::data(Remap));
 
-    meshopt_remapIndexBuffer(std::data(NewIndices), std::data(m_Indices), IndexCount, std::data(Remap));
-    meshopt_remapVertexBuffer(std::data(NewVertices), std::data(m_Vertices), VertexCount, sizeof(Vertex), std::data(Remap));
-
-    m_Vertices     = std::move(NewVertices);
-    m_Indices      = std::move(NewIndices);
+    m_Vertices.resize(NewVertexCount);
+    m_Indices.resize(IndexCount);
     m_NumTriangles = static_cast<std::uint32_t>(std::size(m_Indices) / 3U);
 
     meshopt_optimizeVertexCache(std::data(m_Indices), std::data(m_Indices), IndexCount, std::size(m_Vertices));
@@ -81,9 +79,16 @@ void Mesh::SetupBounds()
 
 void Mesh::BindBuffers(VkCommandBuffer const &CommandBuffer, std::uint32_t const NumInstances) const
 {
-    VkBuffer const &AllocationBuffer = GetAllocationBuffer();
+    BindBuffers(CommandBuffer, NumInstances, GetAllocationBuffer(), m_VertexOffset);
+}
 
-    vkCmdBindVertexBuffers(CommandBuffer, 0U, 1U, &AllocationBuffer, &m_VertexOffset);
-    vkCmdBindIndexBuffer(CommandBuffer, AllocationBuffer, m_IndexOffset, VK_INDEX_TYPE_UINT32);
+// Skinned objects read their posed vertices from another buffer, while the indices stay shared with the mesh
+void Mesh::BindBuffers(VkCommandBuffer const & CommandBuffer,
+                       std::uint32_t const     NumInstances,
+                       VkBuffer const &        VertexBuffer,
+                       VkDeviceSize const      VertexOffset) const
+{
+    vkCmdBindVertexBuffers(CommandBuffer, 0U, 1U, &VertexBuffer, &VertexOffset);
+    vkCmdBindIndexBuffer(CommandBuffer, GetAllocationBuffer(), m_IndexOffset, VK_INDEX_TYPE_UINT32);
     vkCmdDrawIndexed(CommandBuffer, static_cast<std::uint32_t>(std::size(m_Indices)), NumInstances, 0U, 0U, 0U);
 }
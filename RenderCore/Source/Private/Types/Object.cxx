@@ -9,6 +9,7 @@ module RenderCore.Types.Object;
 import RenderCore.Renderer;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Skinning;
 import RenderCore.Types.UniformBufferObject;
 
 using namespace RenderCore;
@@ -35,43 +36,57 @@ void Object::SetupUniformDescriptor()
     m_MappedData        = GetAllocationMappedData();
 }
 
+ModelUniformData Object::GetUniformData(Transform const &Transform) const
+{
+    return ModelUniformData {
+            .Model = Transform.GetMatrix() * m_Mesh->GetTransform().GetMatrix(),
+            .BaseColorFactor = m_Mesh->GetMaterialData().BaseColorFactor,
+            .EmissiveFactor = m_Mesh->GetMaterialData().EmissiveFactor,
+            .MetallicFactor = static_cast<double>(m_Mesh->GetMaterialData().MetallicFactor),
+            .RoughnessFactor = static_cast<double>(m_Mesh->GetMaterialData().RoughnessFactor),
+            .AlphaCutoff = static_cast<double>(m_Mesh->GetMaterialData().AlphaCutoff),
+            .NormalScale = static_cast<double>(m_Mesh->GetMaterialData().NormalScale),
+            .OcclusionStrength = static_cast<double>(m_Mesh->GetMaterialData().OcclusionStrength),
+            .AlphaMode = static_cast<std::int32_t>(m_Mesh->GetMaterialData().AlphaMode),
+            .DoubleSided = static_cast<std::int32_t>(m_Mesh->GetMaterialData().DoubleSided)
+    };
+}
+
 void Object::UpdateUniformBuffers() const
 {
-    if (!m_MappedData)
+    if (m_MappedData && m_IsRenderDirty)
     {
-        return;
+        UpdateUniformBuffers(GetUniformData(m_Transform));
+        m_IsRenderDirty = false;
     }
+}
 
-    if (m_IsRenderDirty)
+void Object::UpdateUniformBuffers(ModelUniformData const &UniformData) const
+{
+    if (!m_MappedData)
     {
-        constexpr auto ModelUBOSize = sizeof(ModelUniformData);
-
-        ModelUniformData const UpdatedModelUBO {
-                .Model = m_Transform.GetMatrix() * m_Mesh->GetTransform().GetMatrix(),
-                .BaseColorFactor = m_Mesh->GetMaterialData().BaseColorFactor,
-                .EmissiveFactor = m_Mesh->GetMaterialData().EmissiveFactor,
-                .MetallicFactor = static_cast<double>(m_Mesh->GetMaterialData().MetallicFactor),
-                .RoughnessFactor = static_cast<double>(m_Mesh->GetMaterialData().RoughnessFactor),
-                .AlphaCutoff = static_cast<double>(m_Mesh->GetMaterialData().AlphaCutoff),
-                .NormalScale = static_cast<double>(m_Mesh->GetMaterialData().NormalScale),
-                .OcclusionStrength = static_cast<double>(m_Mesh->GetMaterialData().OcclusionStrength),
-                .AlphaMode = static_cast<std::int32_t>(m_Mesh->GetMaterialData().AlphaMode),
-                .DoubleSided = static_cast<std::int32_t>(m_Mesh->GetMaterialData().DoubleSided)
-        };
-
-        std::memcpy(static_cast<char *>(m_MappedData) + GetUniformOffset(), &UpdatedModelUBO, ModelUBOSize);
-        m_IsRenderDirty = false;
+        return;
     }
+
+    std::memcpy(static_cast<char *>(m_MappedData) + GetUniformOffset(), &UniformData, sizeof(ModelUniformData));
 }
 
 void Object::DrawObject(VkCommandBuffer const &CommandBuffer, VkPipelineLayout const &PipelineLayout, std::uint32_t const ObjectIndex) const
+{
+    DrawObject(CommandBuffer, PipelineLayout, ObjectIndex, std::empty(m_InstanceTransform) ? 1U : GetNumInstances());
+}
+
+void Object::DrawObject(VkCommandBuffer const & CommandBuffer,
+                        VkPipelineLayout const &PipelineLayout,
+                        std::uint32_t const     ObjectIndex,
+                        std::uint32_t const     NumInstances) const
 {
     if (!m_Mesh)
     {
         return;
     }
 
-    auto const &[SceneData, ModelData, TextureData] = GetPipelineDescriptorData();
+    auto const &[SceneData, ModelData, TextureData, VisibilityData, MaterialData] = GetPipelineDescriptorData();
 
     std::array const BufferBindingInfos {
             VkDescriptorBufferBindingInfoEXT
@@ -112,5 +127,13 @@ void Object::DrawObject(VkCommandBuffer const &CommandBuffer, VkPipelineLayout c
                                        std::data(BufferIndices),
                                        std::data(BufferOffsets));
 
-    m_Mesh->BindBuffers(CommandBuffer, std::empty(m_InstanceTransform) ? 1U : GetNumInstances());
+    // Without the skinning pass, the posed buffer is never written and the bind pose is drawn instead
+    if (IsSkinned() && IsSkinningActive())
+    {
+        m_Mesh->BindBuffers(CommandBuffer, NumInstances, GetSkinnedVertexBuffer().Buffer, m_SkinnedVertexOffset);
+    }
+    else
+    {
+        m_Mesh->BindBuffers(CommandBuffer, NumInstances);
+    }
 }
\ No newline at end of file
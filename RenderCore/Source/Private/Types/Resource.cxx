@@ -16,14 +16,28 @@ strzilla::string NameParser(strzilla::string_view const Path)
 
 Resource::Resource(std::uint32_t const ID, strzilla::string_view const Path)
     : m_ID(ID)
-  , m_Path(Path)
-  , m_Name(NameParser(m_Path))
+  , m_Path(InternString(Path))
+  , m_Name(InternString(NameParser(Path)))
 {
 }
 
-Resource::Resource(std::uint32_t const ID, strzilla::string_view const Path, strzilla::string_view const Name)
+Resource::Resource(std::uint32_t const ID, strzilla::string_view const Path, strzilla::string_view const Name, std::uint32_t const NameSuffix)
     : m_ID(ID)
-  , m_Path(Path)
-  , m_Name(Name)
+  , m_Path(InternString(Path))
+  , m_Name(InternString(Name))
+  , m_NameSuffix(NameSuffix)
 {
 }
+
+strzilla::string Resource::GetName() const
+{
+    strzilla::string const &Name = GetInternedString(m_Name);
+    return m_NameSuffix == g_NoNameSuffix ? Name : strzilla::string { std::format("{}_{:03d}", std::data(Name), m_NameSuffix) };
+}
+
+// Never destroyed: resources held by other globals may still be released during the static destruction
+std::pmr::memory_resource *RenderCore::GetResourcePool()
+{
+    static auto *const ResourcePool = new std::pmr::synchronized_pool_resource {};
+    return ResourcePool;
+}
@@ -0,0 +1,171 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Types.Skeleton;
+
+using namespace RenderCore;
+
+void Skeleton::SetNodes(std::vector<std::int32_t> const &Parents,
+                        std::vector<glm::vec3> const &   Translations,
+                        std::vector<glm::quat> const &   Rotations,
+                        std::vector<glm::vec3> const &   Scales)
+{
+    m_Parents      = Parents;
+    m_Translations = Translations;
+    m_Rotations    = Rotations;
+    m_Scales       = Scales;
+    m_GlobalMatrices.assign(std::size(m_Parents), glm::mat4 { 1.F });
+
+    // glTF doesn't sort the nodes: walking from the roots gives an order where every parent is resolved before its children
+    std::vector<std::vector<std::uint32_t>> Children(std::size(m_Parents));
+    std::vector<std::uint32_t>              PendingNodes {};
+
+    for (std::uint32_t Node = 0U; Node < GetNumNodes(); ++Node)
+    {
+        if (std::int32_t const Parent = m_Parents.at(Node);
+            Parent >= 0)
+        {
+            Children.at(Parent).push_back(Node);
+        }
+        else
+        {
+            PendingNodes.push_back(Node);
+        }
+    }
+
+    m_UpdateOrder.clear();
+    m_UpdateOrder.reserve(std::size(m_Parents));
+
+    while (!std::empty(PendingNodes))
+    {
+        std::uint32_t const Node = PendingNodes.back();
+        PendingNodes.pop_back();
+
+        m_UpdateOrder.push_back(Node);
+        PendingNodes.insert(std::end(PendingNodes), std::begin(Children.at(Node)), std::end(Children.at(Node)));
+    }
+
+    m_IsDirty = true;
+}
+
+void Skeleton::SetAnimations(std::vector<AnimationClip> &&Animations)
+{
+    m_Animations     = std::move(Animations);
+    m_AnimationState = AnimationState {};
+
+    std::uint32_t MaxLanes { 0U };
+
+    for (AnimationClip const &ClipIt : m_Animations)
+    {
+        MaxLanes = std::max(MaxLanes, ClipIt.MaxLanes);
+    }
+
+    m_SampledLanes.assign(MaxLanes, 0.F);
+}
+
+void Skeleton::PlayAnimation(std::uint32_t const ClipIndex, bool const IsLooping)
+{
+    if (ClipIndex >= std::size(m_Animations))
+    {
+        return;
+    }
+
+    m_AnimationState.ClipIndex = static_cast<std::int32_t>(ClipIndex);
+    m_AnimationState.Time      = 0.F;
+    m_AnimationState.IsPaused  = false;
+    m_AnimationState.IsLooping = IsLooping;
+    m_IsVisible                = true;
+}
+
+// Writes straight into the local transforms: the next capture finds the skeleton dirty and propagates them to the joints
+void Skeleton::Animate(float const DeltaTime)
+{
+    if (!IsAnimating())
+    {
+        return;
+    }
+
+    AnimationClip const &Clip = m_Animations.at(m_AnimationState.ClipIndex);
+    float &              Time = m_AnimationState.Time;
+    bool                 HasFinished { false };
+    Time += DeltaTime * m_AnimationState.Speed;
+
+    if (m_AnimationState.IsLooping && Clip.Duration > 0.F)
+    {
+        Time = std::fmod(Time, Clip.Duration);
+        Time = Time < 0.F ? Time + Clip.Duration : Time;
+    }
+    else
+    {
+        Time        = std::clamp(Time, 0.F, Clip.Duration);
+        HasFinished = m_AnimationState.Speed >= 0.F ? Time >= Clip.Duration : Time <= 0.F;
+    }
+
+    // Culled skeletons keep their clock running, so they resume in step once the capture finds them in view again
+    if (!std::exchange(m_IsVisible, false))
+    {
+        return;
+    }
+
+    for (AnimationTrack const &TrackIt : Clip.Tracks)
+    {
+        std::span const Lanes { std::data(m_SampledLanes), TrackIt.NumLanes };
+        TrackIt.Sample(Time, Lanes);
+
+        for (auto const &[Node, FirstLane, Path] : TrackIt.Targets)
+        {
+            float const *const Value = std::data(Lanes) + FirstLane;
+
+            switch (Path)
+            {
+                case AnimationPath::TRANSLATION:
+                    m_Translations.at(Node) = glm::make_vec3(Value);
+                    break;
+                case AnimationPath::ROTATION:
+                    m_Rotations.at(Node) = normalize(glm::make_quat(Value));
+                    break;
+                case AnimationPath::SCALE:
+                    m_Scales.at(Node) = glm::make_vec3(Value);
+                    break;
+            }
+        }
+    }
+
+    // A finished clip stops once its last pose is sampled, instead of being evaluated again every frame
+    m_AnimationState.IsPaused = HasFinished;
+    m_IsDirty                 = true;
+}
+
+bool Skeleton::UpdateGlobalMatrices()
+{
+    if (!m_IsDirty)
+    {
+        return false;
+    }
+
+    for (std::uint32_t const Node : m_UpdateOrder)
+    {
+        glm::mat4 const LocalMatrix = translate(glm::mat4 { 1.F }, m_Translations.at(Node)) * mat4_cast(m_Rotations.at(Node)) *
+                                      scale(glm::mat4 { 1.F }, m_Scales.at(Node));
+
+        std::int32_t const Parent = m_Parents.at(Node);
+        m_GlobalMatrices.at(Node) = Parent >= 0 ? m_GlobalMatrices.at(Parent) * LocalMatrix : LocalMatrix;
+    }
+
+    m_IsDirty = false;
+    return true;
+}
+
+// Skinned meshes ignore the transform of their own node, so the joints map the vertices straight to the model space
+void Skeleton::GetJointMatrices(std::uint32_t const SkinIndex, std::span<glm::mat4> const Output) const
+{
+    SkinData const &Skin = m_Skins.at(SkinIndex);
+
+    for (std::size_t JointIndex = 0U; JointIndex < std::size(Skin.JointNodes) && JointIndex < std::size(Output); ++JointIndex)
+    {
+        Output[JointIndex] = m_GlobalMatrices.at(Skin.JointNodes.at(JointIndex)) * Skin.InverseBindMatrices.at(JointIndex);
+    }
+}
@@ -15,8 +15,8 @@ Texture::Texture(std::uint32_t const ID, strzilla::string_view const Path)
 {
 }
 
-Texture::Texture(std::uint32_t const ID, strzilla::string_view const Path, strzilla::string_view const Name)
-    : Resource(ID, Path, Name)
+Texture::Texture(std::uint32_t const ID, strzilla::string_view const Path, strzilla::string_view const Name, std::uint32_t const NameSuffix)
+    : Resource(ID, Path, Name, NameSuffix)
 {
 }
 
@@ -6,6 +6,8 @@ module;
 
 module RenderCore.Utils.DebugHelpers;
 
+import RenderCore.Utils.Logger;
+
 using namespace RenderCore;
 
 #ifdef _DEBUG
@@ -17,7 +19,7 @@ VKAPI_ATTR VkBool32 VKAPI_CALL RenderCore::ValidationLayerDebugCallback([[maybe_
     // if (MessageSeverity > VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) // - uncomment to print only warnings and errors
     // if (!HasFlag<VkDebugUtilsMessageTypeFlagsEXT>(MessageType, VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT)) // - uncomment to avoid imgui performance warnings
     {
-        BOOST_LOG_TRIVIAL(info) << "[" << __func__ << "]: Message: " << CallbackData->pMessage;
+        RENDERCORE_LOG(info, "Message: {}", CallbackData->pMessage);
     }
 
     return VK_FALSE;
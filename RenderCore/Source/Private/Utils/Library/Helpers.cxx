@@ -8,6 +8,7 @@ module RenderCore.Utils.Helpers;
 
 import RenderCore.Types.Vertex;
 import RenderCore.Utils.EnumConverter;
+import RenderCore.Utils.Logger;
 
 using namespace RenderCore;
 
@@ -31,12 +32,16 @@ std::string ExtractFileName(strzilla::string_view const &FileName)
 
 void RenderCore::EmitFatalError(strzilla::string_view const Message, std::source_location const &Location)
 {
-    BOOST_LOG_TRIVIAL(fatal) << std::format("[{}:{}:{}:{}] {}",
-                                            ExtractFileName(Location.file_name()),
-                                            ExtractFunctionName(Location.function_name()),
-                                            Location.line(),
-                                            Location.column(),
-                                            std::data(Message));
+    // Fatal errors terminate the process: pending records are written first and this one is sunk synchronously
+    FlushLogger();
+    SinkLogMessage(boost::log::trivial::fatal,
+                   nullptr,
+                   std::format("[{}:{}:{}:{}] {}",
+                               ExtractFileName(Location.file_name()),
+                               ExtractFunctionName(Location.function_name()),
+                               Location.line(),
+                               Location.column(),
+                               std::data(Message)));
 
     std::exit(EXIT_FAILURE);
 }
@@ -0,0 +1,92 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.StringTable;
+
+import RenderCore.Utils.Helpers;
+
+using namespace RenderCore;
+
+constexpr std::uint32_t g_StringChunkSize { 1024U };
+constexpr std::uint32_t g_MaxStringChunks { 4096U };
+
+// Strings are stored in chunks that never move, so a handle is resolved with two loads and no lock; only interning takes the mutex
+struct StringTable
+{
+    std::mutex                                                     Mutex {};
+    std::array<std::atomic<strzilla::string *>, g_MaxStringChunks> Chunks {};
+    std::uint32_t                                                  NumStrings { 1U };
+    std::unordered_map<std::string_view, StringHandle>             Handles { { std::string_view {}, g_EmptyStringHandle } };
+
+    StringTable()
+    {
+        Chunks.front().store(new strzilla::string[g_StringChunkSize], std::memory_order_release);
+    }
+};
+
+// Never destroyed: resources held by other globals may still read their names during the static destruction
+StringTable &GetStringTable()
+{
+    static auto *const Table = new StringTable {};
+    return *Table;
+}
+
+StringHandle RenderCore::InternString(strzilla::string_view const Value)
+{
+    std::string_view const Key { std::data(Value), std::size(Value) };
+
+    if (std::empty(Key))
+    {
+        return g_EmptyStringHandle;
+    }
+
+    StringTable &         Table = GetStringTable();
+    std::lock_guard const Lock { Table.Mutex };
+
+    if (auto const Match = Table.Handles.find(Key);
+        Match != std::end(Table.Handles))
+    {
+        return Match->second;
+    }
+
+    StringHandle const  Handle = Table.NumStrings;
+    std::uint32_t const Chunk  = Handle / g_StringChunkSize;
+
+    if (Chunk >= g_MaxStringChunks)
+    {
+        EmitFatalError("String table is full");
+        return g_EmptyStringHandle;
+    }
+
+    strzilla::string *Storage = Table.Chunks.at(Chunk).load(std::memory_order_relaxed);
+
+    if (Storage == nullptr)
+    {
+        Storage = new strzilla::string[g_StringChunkSize];
+        Table.Chunks.at(Chunk).store(Storage, std::memory_order_release);
+    }
+
+    // Written before the handle is returned: readers get the handle through whatever published the resource holding it
+    strzilla::string &Stored = Storage[Handle % g_StringChunkSize];
+    Stored                   = Value;
+    ++Table.NumStrings;
+
+    Table.Handles.emplace(std::string_view { std::data(Stored), std::size(Stored) }, Handle);
+    return Handle;
+}
+
+strzilla::string const &RenderCore::GetInternedString(StringHandle const Handle)
+{
+    return GetStringTable().Chunks.at(Handle / g_StringChunkSize).load(std::memory_order_acquire)[Handle % g_StringChunkSize];
+}
+
+std::uint32_t RenderCore::GetNumInternedStrings()
+{
+    StringTable &         Table = GetStringTable();
+    std::lock_guard const Lock { Table.Mutex };
+
+    return Table.NumStrings;
+}
@@ -0,0 +1,222 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.Logger;
+
+using namespace RenderCore;
+
+constexpr std::uint64_t g_LogCapacity { 1U << 12U };
+
+// Bounded multi-producer ring: a slot is free for position P when its sequence is P and readable when it is P + 1
+std::array<LogRecord, g_LogCapacity> g_LogRecords {};
+std::atomic<std::uint64_t>           g_LogEnqueuePosition { 0U };
+std::atomic<std::uint64_t>           g_LogDequeuePosition { 0U };
+std::atomic<bool>                    g_LoggerRunning { false };
+std::mutex                           g_LoggerMutex {};
+std::jthread                         g_LoggerThread {};
+thread_local std::string             t_LogFormatBuffer {};
+
+bool ConsumeLogRecord(std::string &Message)
+{
+    std::uint64_t const Position = g_LogDequeuePosition.load(std::memory_order_relaxed);
+    LogRecord &         Record   = g_LogRecords.at(Position & g_LogCapacity - 1U);
+
+    if (Record.Sequence.load(std::memory_order_acquire) != Position + 1U)
+    {
+        return false;
+    }
+
+    Message.clear();
+
+    if (Record.Formatter != nullptr)
+    {
+        Record.Formatter(Record.Format, Record.Payload, Message);
+        Record.Formatter = nullptr;
+    }
+    else if (Record.Overflow)
+    {
+        Message = std::move(*Record.Overflow);
+        Record.Overflow.reset();
+    }
+    else
+    {
+        Message.assign(reinterpret_cast<char const *>(Record.Payload), Record.Length);
+    }
+
+    boost::log::trivial::severity_level const Level    = Record.Level;
+    char const *const                         Function = Record.Function;
+
+    Record.Sequence.store(Position + g_LogCapacity, std::memory_order_release);
+    g_LogDequeuePosition.store(Position + 1U, std::memory_order_release);
+
+    SinkLogMessage(Level, Function, Message);
+
+    return true;
+}
+
+void ConsumeLogRecords(std::stop_token const &StopToken)
+{
+    std::string Message {};
+
+    while (true)
+    {
+        if (ConsumeLogRecord(Message))
+        {
+            continue;
+        }
+
+        if (StopToken.stop_requested()
+            && g_LogDequeuePosition.load(std::memory_order_relaxed) == g_LogEnqueuePosition.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+LogRecord *RenderCore::AcquireLogRecord()
+{
+    if (!g_LoggerRunning.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    std::uint64_t Position = g_LogEnqueuePosition.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        LogRecord &         Record   = g_LogRecords.at(Position & g_LogCapacity - 1U);
+        std::uint64_t const Sequence = Record.Sequence.load(std::memory_order_acquire);
+        auto const          Distance = static_cast<std::int64_t>(Sequence - Position);
+
+        if (Distance == 0)
+        {
+            if (g_LogEnqueuePosition.compare_exchange_weak(Position, Position + 1U, std::memory_order_relaxed))
+            {
+                return &Record;
+            }
+        }
+        else if (Distance < 0)
+        {
+            // Ring is full: wait for the logger thread instead of dropping records
+            std::this_thread::yield();
+            Position = g_LogEnqueuePosition.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            Position = g_LogEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void RenderCore::CommitLogRecord(LogRecord &Record)
+{
+    Record.Sequence.store(Record.Sequence.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+}
+
+void RenderCore::FormatLogMessage(boost::log::trivial::severity_level const Level,
+                                  char const *const                         Function,
+                                  std::string_view const                    Format,
+                                  std::format_args const                    Arguments)
+{
+    // Reused per thread, so formatting on the caller side doesn't allocate once the buffer has grown
+    t_LogFormatBuffer.clear();
+    std::vformat_to(std::back_inserter(t_LogFormatBuffer), Format, Arguments);
+
+    EnqueueLogMessage(Level, Function, t_LogFormatBuffer);
+}
+
+extern "C++" void RenderCore::EnqueueLogMessage(boost::log::trivial::severity_level const Level,
+                                                char const *const                         Function,
+                                                std::string_view const                    Message)
+{
+    LogRecord *const Record = AcquireLogRecord();
+
+    if (Record == nullptr)
+    {
+        SinkLogMessage(Level, Function, Message);
+        return;
+    }
+
+    Record->Level     = Level;
+    Record->Function  = Function;
+    Record->Formatter = nullptr;
+
+    if (std::size(Message) > g_LogPayloadSize)
+    {
+        Record->Overflow = std::make_unique<std::string>(Message);
+    }
+    else
+    {
+        std::copy_n(std::data(Message), std::size(Message), reinterpret_cast<char *>(Record->Payload));
+        Record->Length = static_cast<std::uint32_t>(std::size(Message));
+    }
+
+    CommitLogRecord(*Record);
+}
+
+void RenderCore::SinkLogMessage(boost::log::trivial::severity_level const Level, char const *const Function, std::string_view const Message)
+{
+    if (Function != nullptr)
+    {
+        BOOST_LOG_SEV(boost::log::trivial::logger::get(), Level) << "[" << Function << "]: " << Message;
+    }
+    else
+    {
+        BOOST_LOG_SEV(boost::log::trivial::logger::get(), Level) << Message;
+    }
+}
+
+void RenderCore::InitializeLogger()
+{
+    std::lock_guard const Lock { g_LoggerMutex };
+
+    if (g_LoggerRunning.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    for (std::uint64_t Index = 0U; Index < g_LogCapacity; ++Index)
+    {
+        g_LogRecords.at(Index).Sequence.store(Index, std::memory_order_relaxed);
+    }
+
+    g_LogEnqueuePosition.store(0U, std::memory_order_relaxed);
+    g_LogDequeuePosition.store(0U, std::memory_order_relaxed);
+
+    g_LoggerThread = std::jthread { &ConsumeLogRecords };
+    g_LoggerRunning.store(true, std::memory_order_release);
+}
+
+void RenderCore::FlushLogger()
+{
+    if (!g_LoggerRunning.load(std::memory_order_acquire) || std::this_thread::get_id() == g_LoggerThread.get_id())
+    {
+        return;
+    }
+
+    std::uint64_t const Target = g_LogEnqueuePosition.load(std::memory_order_acquire);
+
+    while (g_LogDequeuePosition.load(std::memory_order_acquire) < Target)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void RenderCore::ShutdownLogger()
+{
+    std::lock_guard const Lock { g_LoggerMutex };
+
+    if (!g_LoggerRunning.exchange(false, std::memory_order_acq_rel))
+    {
+        return;
+    }
+
+    // Records acquired before the flag changed are still drained by the logger thread before it exits
+    g_LoggerThread.request_stop();
+    g_LoggerThread.join();
+}
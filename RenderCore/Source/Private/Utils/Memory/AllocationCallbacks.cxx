@@ -0,0 +1,265 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.AllocationCallbacks;
+
+import RenderCore.Utils.Logger;
+
+using namespace RenderCore;
+
+constexpr auto g_NumAllocationTags = static_cast<std::uint8_t>(HostAllocationTag::Count);
+
+constexpr std::array<strzilla::string_view, g_NumAllocationTags> g_AllocationTagNames {
+        "Instance",
+        "Device",
+        "Memory",
+        "Pipeline",
+        "SwapChain",
+        "Descriptors",
+        "Commands",
+        "Synchronization"
+};
+
+#if RENDERCORE_TRACK_HOST_ALLOCATIONS
+struct TrackedAllocationStats
+{
+    std::atomic<std::uint64_t>                                          NumAllocations { 0U };
+    std::atomic<std::uint64_t>                                          NumReallocations { 0U };
+    std::atomic<std::uint64_t>                                          NumFrees { 0U };
+    std::atomic<std::uint64_t>                                          CurrentBytes { 0U };
+    std::atomic<std::uint64_t>                                          PeakBytes { 0U };
+    std::atomic<std::uint64_t>                                          TotalBytes { 0U };
+    std::atomic<std::uint64_t>                                          InternalBytes { 0U };
+    std::array<std::atomic<std::uint64_t>, g_NumSystemAllocationScopes> ScopeCurrentBytes {};
+    std::array<std::atomic<std::uint64_t>, g_NumSystemAllocationScopes> ScopePeakBytes {};
+};
+
+// Stored right before the returned pointer, so frees and reallocations know the size, scope and alignment of the block
+struct AllocationHeader
+{
+    std::size_t             Size { 0U };
+    std::size_t             Alignment { 0U };
+    std::size_t             Offset { 0U };
+    VkSystemAllocationScope Scope { VK_SYSTEM_ALLOCATION_SCOPE_OBJECT };
+};
+
+std::array<TrackedAllocationStats, g_NumAllocationTags> g_TrackedStats {};
+
+void UpdatePeak(std::atomic<std::uint64_t> &Peak, std::uint64_t const Value)
+{
+    std::uint64_t Current = Peak.load(std::memory_order_relaxed);
+
+    while (Value > Current && !Peak.compare_exchange_weak(Current, Value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void TrackAllocation(TrackedAllocationStats &Stats, std::size_t const Size, VkSystemAllocationScope const Scope)
+{
+    auto const ScopeIndex = static_cast<std::uint8_t>(Scope);
+
+    Stats.TotalBytes.fetch_add(Size, std::memory_order_relaxed);
+    UpdatePeak(Stats.PeakBytes, Stats.CurrentBytes.fetch_add(Size, std::memory_order_relaxed) + Size);
+    UpdatePeak(Stats.ScopePeakBytes.at(ScopeIndex), Stats.ScopeCurrentBytes.at(ScopeIndex).fetch_add(Size, std::memory_order_relaxed) + Size);
+}
+
+void TrackRelease(TrackedAllocationStats &Stats, std::size_t const Size, VkSystemAllocationScope const Scope)
+{
+    Stats.CurrentBytes.fetch_sub(Size, std::memory_order_relaxed);
+    Stats.ScopeCurrentBytes.at(static_cast<std::uint8_t>(Scope)).fetch_sub(Size, std::memory_order_relaxed);
+}
+
+AllocationHeader &GetAllocationHeader(void *const Memory)
+{
+    return *reinterpret_cast<AllocationHeader *>(static_cast<std::byte *>(Memory) - sizeof(AllocationHeader));
+}
+
+void *AllocateTracked(TrackedAllocationStats &Stats, std::size_t const Size, std::size_t Alignment, VkSystemAllocationScope const Scope)
+{
+    Alignment = std::max(Alignment, alignof(AllocationHeader));
+
+    // Header space is a multiple of the alignment, so the returned pointer keeps the requested alignment
+    std::size_t const Offset = (sizeof(AllocationHeader) + Alignment - 1U) / Alignment * Alignment;
+    void *const       Base   = ::operator new(Offset + Size, std::align_val_t { Alignment }, std::nothrow);
+
+    if (Base == nullptr)
+    {
+        return nullptr;
+    }
+
+    void *const Output = static_cast<std::byte *>(Base) + Offset;
+
+    GetAllocationHeader(Output) = AllocationHeader { .Size = Size, .Alignment = Alignment, .Offset = Offset, .Scope = Scope };
+    TrackAllocation(Stats, Size, Scope);
+
+    return Output;
+}
+
+void FreeTracked(TrackedAllocationStats &Stats, void *const Memory)
+{
+    AllocationHeader const Header = GetAllocationHeader(Memory);
+    TrackRelease(Stats, Header.Size, Header.Scope);
+
+    ::operator delete(static_cast<std::byte *>(Memory) - Header.Offset, std::align_val_t { Header.Alignment });
+}
+
+void *VKAPI_CALL TrackedAllocation(void *const UserData, std::size_t const Size, std::size_t const Alignment, VkSystemAllocationScope const Scope)
+{
+    auto &Stats = *static_cast<TrackedAllocationStats *>(UserData);
+    Stats.NumAllocations.fetch_add(1U, std::memory_order_relaxed);
+
+    return AllocateTracked(Stats, Size, Alignment, Scope);
+}
+
+void *VKAPI_CALL TrackedReallocation(void *const                  UserData,
+                                     void *const                  Original,
+                                     std::size_t const            Size,
+                                     std::size_t const            Alignment,
+                                     VkSystemAllocationScope const Scope)
+{
+    auto &Stats = *static_cast<TrackedAllocationStats *>(UserData);
+
+    if (Original == nullptr)
+    {
+        Stats.NumAllocations.fetch_add(1U, std::memory_order_relaxed);
+        return AllocateTracked(Stats, Size, Alignment, Scope);
+    }
+
+    if (Size == 0U)
+    {
+        Stats.NumFrees.fetch_add(1U, std::memory_order_relaxed);
+        FreeTracked(Stats, Original);
+        return nullptr;
+    }
+
+    Stats.NumReallocations.fetch_add(1U, std::memory_order_relaxed);
+
+    void *const Output = AllocateTracked(Stats, Size, Alignment, Scope);
+
+    if (Output != nullptr)
+    {
+        std::copy_n(static_cast<std::byte const *>(Original), std::min(Size, GetAllocationHeader(Original).Size), static_cast<std::byte *>(Output));
+        FreeTracked(Stats, Original);
+    }
+
+    return Output;
+}
+
+void VKAPI_CALL TrackedFree(void *const UserData, void *const Memory)
+{
+    if (Memory == nullptr)
+    {
+        return;
+    }
+
+    auto &Stats = *static_cast<TrackedAllocationStats *>(UserData);
+    Stats.NumFrees.fetch_add(1U, std::memory_order_relaxed);
+
+    FreeTracked(Stats, Memory);
+}
+
+void VKAPI_CALL TrackedInternalAllocation(void *const UserData, std::size_t const Size, VkInternalAllocationType, VkSystemAllocationScope)
+{
+    static_cast<TrackedAllocationStats *>(UserData)->InternalBytes.fetch_add(Size, std::memory_order_relaxed);
+}
+
+void VKAPI_CALL TrackedInternalFree(void *const UserData, std::size_t const Size, VkInternalAllocationType, VkSystemAllocationScope)
+{
+    static_cast<TrackedAllocationStats *>(UserData)->InternalBytes.fetch_sub(Size, std::memory_order_relaxed);
+}
+
+std::array<VkAllocationCallbacks, g_NumAllocationTags> const g_TrackedCallbacks = []
+{
+    std::array<VkAllocationCallbacks, g_NumAllocationTags> Output {};
+
+    for (std::uint8_t TagIt = 0U; TagIt < g_NumAllocationTags; ++TagIt)
+    {
+        Output.at(TagIt) = VkAllocationCallbacks {
+                .pUserData = &g_TrackedStats.at(TagIt),
+                .pfnAllocation = &TrackedAllocation,
+                .pfnReallocation = &TrackedReallocation,
+                .pfnFree = &TrackedFree,
+                .pfnInternalAllocation = &TrackedInternalAllocation,
+                .pfnInternalFree = &TrackedInternalFree
+        };
+    }
+
+    return Output;
+}();
+#endif
+
+VkAllocationCallbacks const *RenderCore::GetAllocationCallbacks([[maybe_unused]] HostAllocationTag const Tag)
+{
+    #if RENDERCORE_TRACK_HOST_ALLOCATIONS
+    return &g_TrackedCallbacks.at(static_cast<std::uint8_t>(Tag));
+    #else
+    return nullptr;
+    #endif
+}
+
+HostAllocationStats RenderCore::GetHostAllocationStats([[maybe_unused]] HostAllocationTag const Tag)
+{
+    HostAllocationStats Output {};
+
+    #if RENDERCORE_TRACK_HOST_ALLOCATIONS
+    TrackedAllocationStats const &Stats = g_TrackedStats.at(static_cast<std::uint8_t>(Tag));
+
+    Output.NumAllocations   = Stats.NumAllocations.load(std::memory_order_relaxed);
+    Output.NumReallocations = Stats.NumReallocations.load(std::memory_order_relaxed);
+    Output.NumFrees         = Stats.NumFrees.load(std::memory_order_relaxed);
+    Output.CurrentBytes     = Stats.CurrentBytes.load(std::memory_order_relaxed);
+    Output.PeakBytes        = Stats.PeakBytes.load(std::memory_order_relaxed);
+    Output.TotalBytes       = Stats.TotalBytes.load(std::memory_order_relaxed);
+    Output.InternalBytes    = Stats.InternalBytes.load(std::memory_order_relaxed);
+
+    for (std::uint8_t ScopeIt = 0U; ScopeIt < g_NumSystemAllocationScopes; ++ScopeIt)
+    {
+        Output.ScopeCurrentBytes.at(ScopeIt) = Stats.ScopeCurrentBytes.at(ScopeIt).load(std::memory_order_relaxed);
+        Output.ScopePeakBytes.at(ScopeIt)    = Stats.ScopePeakBytes.at(ScopeIt).load(std::memory_order_relaxed);
+    }
+    #endif
+
+    return Output;
+}
+
+strzilla::string_view RenderCore::GetHostAllocationTagName(HostAllocationTag const Tag)
+{
+    return Tag < HostAllocationTag::Count ? g_AllocationTagNames.at(static_cast<std::uint8_t>(Tag)) : "Unknown";
+}
+
+void RenderCore::PrintHostAllocationReport()
+{
+    #if RENDERCORE_TRACK_HOST_ALLOCATIONS
+    for (std::uint8_t TagIt = 0U; TagIt < g_NumAllocationTags; ++TagIt)
+    {
+        auto const                Tag   = static_cast<HostAllocationTag>(TagIt);
+        HostAllocationStats const Stats = GetHostAllocationStats(Tag);
+
+        if (Stats.NumAllocations == 0U)
+        {
+            continue;
+        }
+
+        auto const Message = std::format("{:<16} current {:>10} B, peak {:>10} B, total {:>12} B, allocations {:>8}, reallocations {:>6}, frees {:>8}",
+                                         std::data(GetHostAllocationTagName(Tag)),
+                                         Stats.CurrentBytes,
+                                         Stats.PeakBytes,
+                                         Stats.TotalBytes,
+                                         Stats.NumAllocations,
+                                         Stats.NumReallocations,
+                                         Stats.NumFrees);
+
+        if (Stats.CurrentBytes > 0U)
+        {
+            RENDERCORE_LOG(warning, "{} (not released)", Message);
+        }
+        else
+        {
+            RENDERCORE_LOG(info, "{}", Message);
+        }
+    }
+    #endif
+}
@@ -0,0 +1,111 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.FrameAllocator;
+
+import RenderCore.Utils.Logger;
+
+using namespace RenderCore;
+
+FrameAllocator::FrameAllocator(std::size_t const Capacity)
+    : m_Buffer(std::make_unique_for_overwrite<std::byte[]>(Capacity))
+  , m_Capacity(Capacity)
+{
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    ReleaseHeapBlocks();
+}
+
+void FrameAllocator::Reset()
+{
+    std::lock_guard const Lock { m_Mutex };
+
+    std::size_t const UsedBytes = m_Offset.load(std::memory_order_relaxed) + m_HeapBytes.load(std::memory_order_relaxed);
+    auto const        HeapCount = static_cast<std::uint64_t>(std::size(m_HeapBlocks));
+
+    m_LastFrameStats = FrameAllocationStats {
+            .NumAllocations = m_NumAllocations.exchange(0U, std::memory_order_relaxed),
+            .NumHeapAllocations = HeapCount,
+            .UsedBytes = UsedBytes,
+            .Capacity = m_Capacity,
+            .TotalHeapAllocations = m_LastFrameStats.TotalHeapAllocations + HeapCount
+    };
+
+    ReleaseHeapBlocks();
+
+    // Grown outside of the frame with some headroom, as the padding of the heap requests isn't known
+    if (UsedBytes > m_Capacity)
+    {
+        m_Capacity = std::bit_ceil(UsedBytes + UsedBytes / 2U);
+        m_Buffer   = std::make_unique_for_overwrite<std::byte[]>(m_Capacity);
+
+        RENDERCORE_LOG(info, "Frame allocator grown to {} B after {} heap allocations", m_Capacity, HeapCount);
+    }
+
+    m_Offset.store(0U, std::memory_order_relaxed);
+    m_HeapBytes.store(0U, std::memory_order_relaxed);
+}
+
+FrameAllocationStats FrameAllocator::GetStats() const
+{
+    std::lock_guard const Lock { m_Mutex };
+    return m_LastFrameStats;
+}
+
+void *FrameAllocator::do_allocate(std::size_t const Bytes, std::size_t const Alignment)
+{
+    m_NumAllocations.fetch_add(1U, std::memory_order_relaxed);
+
+    auto const  Base   = reinterpret_cast<std::uintptr_t>(m_Buffer.get());
+    std::size_t Offset = m_Offset.load(std::memory_order_relaxed);
+
+    // Lock-free bump: a failed exchange only means another thread took the space first
+    while (true)
+    {
+        std::size_t const Aligned = ((Base + Offset + Alignment - 1U) & ~(Alignment - 1U)) - Base;
+        std::size_t const End     = Aligned + Bytes;
+
+        if (End > m_Capacity)
+        {
+            break;
+        }
+
+        if (m_Offset.compare_exchange_weak(Offset, End, std::memory_order_relaxed))
+        {
+            return m_Buffer.get() + Aligned;
+        }
+    }
+
+    void *const Output = ::operator new(Bytes, std::align_val_t { Alignment });
+    m_HeapBytes.fetch_add(Bytes, std::memory_order_relaxed);
+
+    std::lock_guard const Lock { m_Mutex };
+    m_HeapBlocks.push_back(HeapBlock { .Data = Output, .Size = Bytes, .Alignment = Alignment });
+
+    return Output;
+}
+
+// Memory is only given back on reset
+void FrameAllocator::do_deallocate(void *, std::size_t, std::size_t)
+{
+}
+
+bool FrameAllocator::do_is_equal(std::pmr::memory_resource const &Other) const noexcept
+{
+    return this == &Other;
+}
+
+void FrameAllocator::ReleaseHeapBlocks()
+{
+    for (auto const &[Data, Size, Alignment] : m_HeapBlocks)
+    {
+        ::operator delete(Data, Size, std::align_val_t { Alignment });
+    }
+
+    m_HeapBlocks.clear();
+}
@@ -0,0 +1,283 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.APICalls;
+
+import RenderCore.Utils.Logger;
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+#if RENDERCORE_TRACK_API_CALLS
+// Device-level entry points used by the renderer: (name, whether the CPU time spent inside the driver is measured)
+#define RENDERCORE_API_CALLS(Entry)                             \
+        Entry(vkAcquireNextImageKHR, true)                      \
+        Entry(vkAllocateCommandBuffers, true)                   \
+        Entry(vkAllocateMemory, true)                           \
+        Entry(vkBeginCommandBuffer, true)                       \
+        Entry(vkCmdBeginRendering, true)                        \
+        Entry(vkCmdBindDescriptorBuffersEXT, true)              \
+        Entry(vkCmdBindIndexBuffer, true)                       \
+        Entry(vkCmdBindPipeline, true)                          \
+        Entry(vkCmdBindVertexBuffers, true)                     \
+        Entry(vkCmdBlitImage2, true)                            \
+        Entry(vkCmdCopyBuffer, true)                            \
+        Entry(vkCmdCopyBufferToImage, true)                     \
+        Entry(vkCmdCopyImageToBuffer, true)                     \
+        Entry(vkCmdDispatch, true)                              \
+        Entry(vkCmdDrawIndexed, true)                           \
+        Entry(vkCmdEndRendering, true)                          \
+        Entry(vkCmdExecuteCommands, true)                       \
+        Entry(vkCmdPipelineBarrier2, true)                      \
+        Entry(vkCmdPushConstants, true)                         \
+        Entry(vkCmdResetQueryPool, true)                        \
+        Entry(vkCmdSetDescriptorBufferOffsetsEXT, true)         \
+        Entry(vkCmdSetScissor, true)                            \
+        Entry(vkCmdSetViewport, true)                           \
+        Entry(vkCmdUpdateBuffer, true)                          \
+        Entry(vkCmdWriteTimestamp2, true)                       \
+        Entry(vkCreateCommandPool, false)                       \
+        Entry(vkCreateComputePipelines, true)                   \
+        Entry(vkCreateDescriptorSetLayout, false)               \
+        Entry(vkCreateFence, false)                             \
+        Entry(vkCreateGraphicsPipelines, true)                  \
+        Entry(vkCreateImageView, false)                         \
+        Entry(vkCreatePipelineCache, true)                      \
+        Entry(vkCreatePipelineLayout, true)                     \
+        Entry(vkCreateQueryPool, false)                         \
+        Entry(vkCreateSampler, false)                           \
+        Entry(vkCreateSemaphore, false)                         \
+        Entry(vkCreateSwapchainKHR, true)                       \
+        Entry(vkDestroyCommandPool, false)                      \
+        Entry(vkDestroyDescriptorSetLayout, false)              \
+        Entry(vkDestroyFence, false)                            \
+        Entry(vkDestroyImageView, false)                        \
+        Entry(vkDestroyPipeline, false)                         \
+        Entry(vkDestroyPipelineCache, false)                    \
+        Entry(vkDestroyPipelineLayout, false)                   \
+        Entry(vkDestroyQueryPool, false)                        \
+        Entry(vkDestroySampler, false)                          \
+        Entry(vkDestroySemaphore, false)                        \
+        Entry(vkDestroySwapchainKHR, false)                     \
+        Entry(vkDeviceWaitIdle, true)                           \
+        Entry(vkEndCommandBuffer, true)                         \
+        Entry(vkFreeCommandBuffers, false)                      \
+        Entry(vkFreeMemory, true)                               \
+        Entry(vkGetBufferDeviceAddress, false)                  \
+        Entry(vkGetDescriptorEXT, true)                         \
+        Entry(vkGetDescriptorSetLayoutBindingOffsetEXT, false)  \
+        Entry(vkGetDescriptorSetLayoutSizeEXT, false)           \
+        Entry(vkGetFenceStatus, false)                          \
+        Entry(vkGetPipelineCacheData, true)                     \
+        Entry(vkGetQueryPoolResults, true)                      \
+        Entry(vkGetSwapchainImagesKHR, false)                   \
+        Entry(vkQueuePresentKHR, true)                          \
+        Entry(vkQueueSubmit2, true)                             \
+        Entry(vkQueueWaitIdle, true)                            \
+        Entry(vkResetCommandPool, true)                         \
+        Entry(vkResetFences, false)                             \
+        Entry(vkWaitForFences, true)
+
+enum class APICall : std::uint16_t
+{
+    #define RENDERCORE_API_CALL_ENUM(Name, Timed) Name,
+    RENDERCORE_API_CALLS(RENDERCORE_API_CALL_ENUM)
+    #undef RENDERCORE_API_CALL_ENUM
+
+    Count
+};
+
+struct APICallDescription
+{
+    strzilla::string_view Name {};
+    bool                  IsTimed { false };
+};
+
+// Written from every recording thread: one cache line each, so hot entry points don't share it
+struct alignas(64) APICallCounter
+{
+    std::atomic<std::uint64_t> Calls { 0U };
+    std::atomic<std::int64_t>  Time { 0 };
+};
+
+struct APICallTotals
+{
+    std::uint64_t FrameCalls { 0U };
+    std::int64_t  FrameTime { 0 };
+    std::uint64_t TotalCalls { 0U };
+    std::int64_t  TotalTime { 0 };
+};
+
+constexpr auto g_NumAPICalls = static_cast<std::size_t>(APICall::Count);
+
+constexpr std::array<APICallDescription, g_NumAPICalls> g_APICallDescriptions {
+    #define RENDERCORE_API_CALL_DESCRIPTION(Name, Timed) APICallDescription { .Name = #Name, .IsTimed = Timed },
+        RENDERCORE_API_CALLS(RENDERCORE_API_CALL_DESCRIPTION)
+    #undef RENDERCORE_API_CALL_DESCRIPTION
+};
+
+std::array<PFN_vkVoidFunction, g_NumAPICalls> g_OriginalFunctions {};
+std::array<APICallCounter, g_NumAPICalls>     g_APICallCounters {};
+std::array<APICallTotals, g_NumAPICalls>      g_APICallTotals {};
+std::mutex                                    g_APICallTotalsMutex {};
+
+struct APICallTimer
+{
+    APICallCounter &Counter;
+    std::int64_t    Begin { GetProfilerTimestamp() };
+
+    ~APICallTimer()
+    {
+        Counter.Time.fetch_add(GetProfilerTimestamp() - Begin, std::memory_order_relaxed);
+    }
+};
+
+template <APICall Call, typename Function>
+struct APICallHook;
+
+template <APICall Call, typename Result, typename... Arguments>
+struct APICallHook<Call, Result (VKAPI_PTR *)(Arguments...)>
+{
+    static Result VKAPI_CALL Invoke(Arguments... Values)
+    {
+        constexpr auto Index    = static_cast<std::size_t>(Call);
+        auto const     Original = reinterpret_cast<Result (VKAPI_PTR *)(Arguments...)>(g_OriginalFunctions[Index]);
+
+        APICallCounter &Counter = g_APICallCounters[Index];
+        Counter.Calls.fetch_add(1U, std::memory_order_relaxed);
+
+        if constexpr (g_APICallDescriptions[Index].IsTimed)
+        {
+            APICallTimer const Timer { .Counter = Counter };
+            return Original(Values...);
+        }
+        else
+        {
+            return Original(Values...);
+        }
+    }
+};
+
+double NanosecondsToMilliseconds(std::int64_t const Value)
+{
+    return static_cast<double>(Value) / 1000000.;
+}
+#endif
+
+void RenderCore::InstallAPICallHooks()
+{
+    #if RENDERCORE_TRACK_API_CALLS
+    // volk is reloaded for every new device: pointers that still hold a hook keep the original captured before
+    #define RENDERCORE_API_CALL_INSTALL(Name, Timed)                                                                        \
+            if (auto const Hook = &APICallHook<APICall::Name, PFN_##Name>::Invoke; Name != nullptr && Name != Hook)         \
+            {                                                                                                               \
+                g_OriginalFunctions[static_cast<std::size_t>(APICall::Name)] = reinterpret_cast<PFN_vkVoidFunction>(Name);  \
+                Name                                                         = Hook;                                        \
+            }
+
+    RENDERCORE_API_CALLS(RENDERCORE_API_CALL_INSTALL)
+    #undef RENDERCORE_API_CALL_INSTALL
+    #endif
+}
+
+void RenderCore::AdvanceAPICallFrame()
+{
+    #if RENDERCORE_TRACK_API_CALLS
+    std::lock_guard const Lock { g_APICallTotalsMutex };
+
+    for (std::size_t Index = 0U; Index < g_NumAPICalls; ++Index)
+    {
+        APICallTotals &Totals = g_APICallTotals[Index];
+        Totals.FrameCalls     = g_APICallCounters[Index].Calls.exchange(0U, std::memory_order_relaxed);
+        Totals.FrameTime      = g_APICallCounters[Index].Time.exchange(0, std::memory_order_relaxed);
+        Totals.TotalCalls += Totals.FrameCalls;
+        Totals.TotalTime += Totals.FrameTime;
+    }
+    #endif
+}
+
+void RenderCore::ResetAPICallStats()
+{
+    #if RENDERCORE_TRACK_API_CALLS
+    std::lock_guard const Lock { g_APICallTotalsMutex };
+
+    for (std::size_t Index = 0U; Index < g_NumAPICalls; ++Index)
+    {
+        g_APICallCounters[Index].Calls.store(0U, std::memory_order_relaxed);
+        g_APICallCounters[Index].Time.store(0, std::memory_order_relaxed);
+        g_APICallTotals[Index] = APICallTotals {};
+    }
+    #endif
+}
+
+bool RenderCore::IsTrackingAPICalls()
+{
+    return RENDERCORE_TRACK_API_CALLS;
+}
+
+std::vector<APICallStats> RenderCore::GetAPICallStats()
+{
+    std::vector<APICallStats> Output {};
+
+    #if RENDERCORE_TRACK_API_CALLS
+    std::lock_guard const Lock { g_APICallTotalsMutex };
+    Output.reserve(g_NumAPICalls);
+
+    for (std::size_t Index = 0U; Index < g_NumAPICalls; ++Index)
+    {
+        APICallTotals const &Totals = g_APICallTotals[Index];
+
+        if (Totals.TotalCalls == 0U)
+        {
+            continue;
+        }
+
+        Output.push_back(APICallStats {
+                .Name = g_APICallDescriptions[Index].Name,
+                .IsTimed = g_APICallDescriptions[Index].IsTimed,
+                .FrameCalls = Totals.FrameCalls,
+                .FrameTime = NanosecondsToMilliseconds(Totals.FrameTime),
+                .TotalCalls = Totals.TotalCalls,
+                .TotalTime = NanosecondsToMilliseconds(Totals.TotalTime)
+        });
+    }
+    #endif
+
+    return Output;
+}
+
+void RenderCore::PrintAPICallReport()
+{
+    #if RENDERCORE_TRACK_API_CALLS
+    // Calls made after the last frame boundary (e.g.: shutdown) are still part of the totals
+    AdvanceAPICallFrame();
+
+    std::vector<APICallStats> Stats = GetAPICallStats();
+
+    std::ranges::sort(Stats,
+                      [](APICallStats const &Lhs, APICallStats const &Rhs)
+                      {
+                          return Lhs.TotalTime != Rhs.TotalTime ? Lhs.TotalTime > Rhs.TotalTime : Lhs.TotalCalls > Rhs.TotalCalls;
+                      });
+
+    for (APICallStats const &StatsIt : Stats)
+    {
+        if (StatsIt.IsTimed)
+        {
+            RENDERCORE_LOG(info,
+                           "{}: {} calls, {:.3f} ms ({:.3f} us per call)",
+                           std::data(StatsIt.Name),
+                           StatsIt.TotalCalls,
+                           StatsIt.TotalTime,
+                           StatsIt.TotalTime * 1000. / static_cast<double>(StatsIt.TotalCalls));
+        }
+        else
+        {
+            RENDERCORE_LOG(info, "{}: {} calls", std::data(StatsIt.Name), StatsIt.TotalCalls);
+        }
+    }
+    #endif
+}
@@ -0,0 +1,246 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.Profiler;
+
+import RenderCore.Utils.Logger;
+
+using namespace RenderCore;
+
+struct ProfilerEvent
+{
+    char const * Name { nullptr };
+    std::int64_t Begin { 0 };
+    std::int64_t End { 0 };
+};
+
+constexpr std::uint64_t g_ProfilerBufferCapacity { 1U << 16U };
+
+// Written only by the owning thread: the exporter reads up to the released head, so recording never takes a lock
+struct ProfilerThreadBuffer
+{
+    std::uint32_t                    ThreadID { 0U };
+    strzilla::string                 ThreadName {};
+    bool                             UsesGPUClock { false };
+    std::unique_ptr<ProfilerEvent[]> Events { std::make_unique<ProfilerEvent[]>(g_ProfilerBufferCapacity) };
+    std::atomic<std::uint64_t>       Head { 0U };
+
+    void Push(char const *const Name, std::int64_t const Begin, std::int64_t const End)
+    {
+        std::uint64_t const Index = Head.load(std::memory_order_relaxed);
+
+        Events[Index & g_ProfilerBufferCapacity - 1U] = ProfilerEvent { .Name = Name, .Begin = Begin, .End = End };
+        Head.store(Index + 1U, std::memory_order_release);
+    }
+};
+
+std::mutex                                         g_ProfilerRegistryMutex {};
+std::vector<std::unique_ptr<ProfilerThreadBuffer>> g_ProfilerThreadBuffers {};
+ProfilerThreadBuffer *                             g_GPUProfilerBuffer { nullptr };
+std::int64_t                                       g_ProfilerCaptureBegin { 0 };
+std::int64_t                                       g_ProfilerCaptureEnd { 0 };
+std::atomic<std::int64_t>                          g_GPUClockOffset { std::numeric_limits<std::int64_t>::min() };
+thread_local ProfilerThreadBuffer *                t_ProfilerThreadBuffer { nullptr };
+
+ProfilerThreadBuffer *RegisterProfilerBuffer(strzilla::string_view const Name, bool const UsesGPUClock)
+{
+    std::lock_guard const Lock { g_ProfilerRegistryMutex };
+
+    auto &Buffer         = g_ProfilerThreadBuffers.emplace_back(std::make_unique<ProfilerThreadBuffer>());
+    Buffer->ThreadID     = static_cast<std::uint32_t>(std::size(g_ProfilerThreadBuffers));
+    Buffer->UsesGPUClock = UsesGPUClock;
+
+    if (std::empty(Name))
+    {
+        Buffer->ThreadName = std::format("Thread {}", Buffer->ThreadID);
+    }
+    else
+    {
+        Buffer->ThreadName = Name;
+    }
+
+    return Buffer.get();
+}
+
+ProfilerThreadBuffer &GetProfilerThreadBuffer()
+{
+    if (t_ProfilerThreadBuffer == nullptr)
+    {
+        t_ProfilerThreadBuffer = RegisterProfilerBuffer({}, false);
+    }
+
+    return *t_ProfilerThreadBuffer;
+}
+
+std::string EscapeTraceString(strzilla::string_view const Value)
+{
+    std::string Output {};
+    Output.reserve(std::size(Value));
+
+    for (char const Character : Value)
+    {
+        if (Character == '"' || Character == '\\')
+        {
+            Output += '\\';
+        }
+
+        Output += Character;
+    }
+
+    return Output;
+}
+
+std::int64_t RenderCore::GetProfilerTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RenderCore::SetProfilerThreadName(strzilla::string_view const Name)
+{
+    if (t_ProfilerThreadBuffer == nullptr)
+    {
+        t_ProfilerThreadBuffer = RegisterProfilerBuffer(Name, false);
+        return;
+    }
+
+    // Only the owning thread writes its name, so it can be compared without locking
+    if (t_ProfilerThreadBuffer->ThreadName == Name)
+    {
+        return;
+    }
+
+    std::lock_guard const Lock { g_ProfilerRegistryMutex };
+    t_ProfilerThreadBuffer->ThreadName = Name;
+}
+
+void RenderCore::RecordProfilerZone(char const *const Name, std::int64_t const Begin, std::int64_t const End)
+{
+    GetProfilerThreadBuffer().Push(Name, Begin, End);
+}
+
+void RenderCore::RecordGPUProfilerZone(char const *const  Name,
+                                       std::int64_t const GPUBegin,
+                                       std::int64_t const GPUEnd,
+                                       std::int64_t const CPUSubmit)
+{
+    if (!IsProfilerCapturing())
+    {
+        return;
+    }
+
+    if (g_GPUProfilerBuffer == nullptr)
+    {
+        g_GPUProfilerBuffer = RegisterProfilerBuffer("GPU Graphics Queue", true);
+    }
+
+    // The GPU can't start a frame before its submission: the largest (submit - GPU begin) difference is the tightest clock offset
+    std::int64_t const Candidate = CPUSubmit - GPUBegin;
+    std::int64_t       Offset    = g_GPUClockOffset.load(std::memory_order_relaxed);
+
+    while (Candidate > Offset && !g_GPUClockOffset.compare_exchange_weak(Offset, Candidate, std::memory_order_relaxed))
+    {
+    }
+
+    g_GPUProfilerBuffer->Push(Name, GPUBegin, GPUEnd);
+}
+
+void RenderCore::BeginProfilerCapture()
+{
+    std::lock_guard const Lock { g_ProfilerRegistryMutex };
+
+    g_ProfilerCaptureBegin = GetProfilerTimestamp();
+    g_ProfilerCaptureEnd   = std::numeric_limits<std::int64_t>::max();
+    g_GPUClockOffset.store(std::numeric_limits<std::int64_t>::min(), std::memory_order_relaxed);
+    g_ProfilerCapturing.store(true, std::memory_order_relaxed);
+}
+
+void RenderCore::EndProfilerCapture()
+{
+    std::lock_guard const Lock { g_ProfilerRegistryMutex };
+
+    if (g_ProfilerCapturing.exchange(false, std::memory_order_relaxed))
+    {
+        g_ProfilerCaptureEnd = GetProfilerTimestamp();
+    }
+}
+
+bool RenderCore::ExportProfilerTrace(strzilla::string_view const Path)
+{
+    EndProfilerCapture();
+
+    std::lock_guard const Lock { g_ProfilerRegistryMutex };
+
+    std::string   Output { "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" };
+    std::uint64_t NumEvents = 0U;
+
+    Output += R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"RenderCore"}})";
+
+    std::int64_t const GPUClockOffset = g_GPUClockOffset.load(std::memory_order_relaxed);
+
+    for (auto const &Buffer : g_ProfilerThreadBuffers)
+    {
+        if (Buffer->UsesGPUClock && GPUClockOffset == std::numeric_limits<std::int64_t>::min())
+        {
+            continue;
+        }
+
+        Output += std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                              Buffer->ThreadID,
+                              EscapeTraceString(Buffer->ThreadName));
+
+        std::uint64_t const Head  = Buffer->Head.load(std::memory_order_acquire);
+        std::uint64_t const First = Head > g_ProfilerBufferCapacity ? Head - g_ProfilerBufferCapacity : 0U;
+
+        for (std::uint64_t Index = First; Index < Head; ++Index)
+        {
+            ProfilerEvent Event = Buffer->Events[Index & g_ProfilerBufferCapacity - 1U];
+
+            if (Buffer->UsesGPUClock)
+            {
+                Event.Begin += GPUClockOffset;
+                Event.End += GPUClockOffset;
+            }
+
+            if (Event.Name == nullptr || Event.Begin < g_ProfilerCaptureBegin || Event.End > g_ProfilerCaptureEnd)
+            {
+                continue;
+            }
+
+            Output += std::format(",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                                  EscapeTraceString(Event.Name),
+                                  Buffer->UsesGPUClock ? "GPU" : "CPU",
+                                  Buffer->ThreadID,
+                                  static_cast<double>(Event.Begin - g_ProfilerCaptureBegin) / 1000.,
+                                  static_cast<double>(Event.End - Event.Begin) / 1000.);
+
+            ++NumEvents;
+        }
+    }
+
+    Output += "\n]}\n";
+
+    std::filesystem::path const OutputPath { std::data(Path) };
+
+    if (OutputPath.has_parent_path())
+    {
+        std::error_code Error {};
+        std::filesystem::create_directories(OutputPath.parent_path(), Error);
+    }
+
+    std::ofstream OutputFile { OutputPath, std::ios::binary | std::ios::trunc };
+
+    if (!OutputFile.is_open())
+    {
+        RENDERCORE_LOG(error, "Failed to open trace output file: '{}'", std::data(Path));
+        return false;
+    }
+
+    OutputFile.write(std::data(Output), static_cast<std::streamsize>(std::size(Output)));
+
+    RENDERCORE_LOG(info, "Exported {} profiler zones to '{}'", NumEvents, std::data(Path));
+
+    return true;
+}
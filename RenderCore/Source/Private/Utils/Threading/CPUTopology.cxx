@@ -0,0 +1,220 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif // NOMINMAX
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif // WIN32_LEAN_AND_MEAN
+    #include <Windows.h>
+#endif // _WIN32
+
+module RenderCore.Utils.CPUTopology;
+
+import RenderCore.Utils.Logger;
+
+using namespace RenderCore;
+
+// Indices into the topology cores
+struct WorkerLayout
+{
+    std::vector<std::size_t> RecordingCores {};
+    std::vector<std::size_t> IOCores {};
+};
+
+WorkerThreadSettings g_WorkerThreadSettings {};
+WorkerLayout         g_WorkerLayout {};
+std::mutex           g_WorkerThreadMutex {};
+
+CPUTopology QueryCPUTopology()
+{
+    CPUTopology Output {};
+
+    #ifdef _WIN32
+    DWORD BufferSize = 0U;
+    GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &BufferSize);
+
+    std::vector<std::byte> Buffer(BufferSize);
+
+    if (BufferSize > 0U &&
+        GetLogicalProcessorInformationEx(RelationProcessorCore,
+                                         reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *>(std::data(Buffer)),
+                                         &BufferSize))
+    {
+        for (std::size_t Offset = 0U; Offset < BufferSize;)
+        {
+            auto const &Information = *reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX const *>(std::data(Buffer) + Offset);
+            Offset += Information.Size;
+
+            GROUP_AFFINITY const &Affinity = Information.Processor.GroupMask[0];
+            auto const            Mask     = static_cast<std::uint64_t>(Affinity.Mask);
+
+            CPUCore const Core {
+                    .Group = Affinity.Group,
+                    .Mask = Mask,
+                    .EfficiencyClass = Information.Processor.EfficiencyClass,
+                    .NumLogicalProcessors = static_cast<std::uint8_t>(std::popcount(Mask))
+            };
+
+            Output.Cores.push_back(Core);
+            Output.NumLogicalProcessors += Core.NumLogicalProcessors;
+            Output.MaxEfficiencyClass = std::max(Output.MaxEfficiencyClass, Core.EfficiencyClass);
+        }
+    }
+    #endif // _WIN32
+
+    // Without topology information each logical processor is taken as a core, and no thread is pinned
+    if (std::empty(Output.Cores))
+    {
+        std::uint32_t const NumProcessors = std::max(std::thread::hardware_concurrency(), 1U);
+
+        Output.Cores.resize(NumProcessors, CPUCore { .Mask = 0U });
+        Output.NumLogicalProcessors = NumProcessors;
+    }
+
+    return Output;
+}
+
+std::optional<std::size_t> FindCurrentThreadCore(CPUTopology const &Topology)
+{
+    #ifdef _WIN32
+    PROCESSOR_NUMBER Processor {};
+    GetCurrentProcessorNumberEx(&Processor);
+
+    for (std::size_t CoreIndex = 0U; CoreIndex < std::size(Topology.Cores); ++CoreIndex)
+    {
+        if (CPUCore const &Core = Topology.Cores.at(CoreIndex);
+            Core.Group == Processor.Group && (Core.Mask >> Processor.Number & 1U) != 0U)
+        {
+            return CoreIndex;
+        }
+    }
+    #endif // _WIN32
+
+    return std::nullopt;
+}
+
+CPUTopology const &RenderCore::GetCPUTopology()
+{
+    static CPUTopology const Topology = QueryCPUTopology();
+    return Topology;
+}
+
+void RenderCore::SetWorkerThreadSettings(WorkerThreadSettings const &Settings)
+{
+    std::lock_guard const Lock { g_WorkerThreadMutex };
+    g_WorkerThreadSettings = Settings;
+}
+
+WorkerThreadSettings RenderCore::GetWorkerThreadSettings()
+{
+    std::lock_guard const Lock { g_WorkerThreadMutex };
+    return g_WorkerThreadSettings;
+}
+
+// Called from the application thread: the core it's running on is left to it
+void RenderCore::InitializeWorkerLayout()
+{
+    CPUTopology const &Topology = GetCPUTopology();
+
+    std::lock_guard const Lock { g_WorkerThreadMutex };
+
+    std::optional<std::size_t> const MainThreadCore = g_WorkerThreadSettings.ReserveMainThreadCore ? FindCurrentThreadCore(Topology) : std::nullopt;
+
+    WorkerLayout Layout {};
+
+    for (std::size_t CoreIndex = 0U; CoreIndex < std::size(Topology.Cores); ++CoreIndex)
+    {
+        if (CoreIndex == MainThreadCore)
+        {
+            continue;
+        }
+
+        if (Topology.IsPerformanceCore(Topology.Cores.at(CoreIndex)))
+        {
+            Layout.RecordingCores.push_back(CoreIndex);
+        }
+        else
+        {
+            Layout.IOCores.push_back(CoreIndex);
+        }
+    }
+
+    // Recording is split in one batch per worker: past a few cores the batches get too small to pay for their command buffers
+    if (std::uint32_t const MaxRecordingWorkers = g_WorkerThreadSettings.MaxRecordingWorkers;
+        MaxRecordingWorkers > 0U && std::size(Layout.RecordingCores) > MaxRecordingWorkers)
+    {
+        Layout.IOCores.insert(std::begin(Layout.IOCores), std::begin(Layout.RecordingCores) + MaxRecordingWorkers, std::end(Layout.RecordingCores));
+        Layout.RecordingCores.resize(MaxRecordingWorkers);
+    }
+
+    if (std::empty(Layout.RecordingCores))
+    {
+        Layout.RecordingCores.push_back(MainThreadCore.value_or(0U));
+    }
+
+    if (std::empty(Layout.IOCores))
+    {
+        Layout.IOCores = Layout.RecordingCores;
+    }
+
+    RENDERCORE_LOG(info,
+                   "CPU topology: {} cores, {} logical processors; {} recording workers, {} cores for IO workers",
+                   std::size(Topology.Cores),
+                   Topology.NumLogicalProcessors,
+                   std::size(Layout.RecordingCores),
+                   std::size(Layout.IOCores));
+
+    g_WorkerLayout = std::move(Layout);
+}
+
+std::uint32_t RenderCore::GetNumWorkers(WorkerClass const Class)
+{
+    std::lock_guard const Lock { g_WorkerThreadMutex };
+
+    std::vector<std::size_t> const &Cores = Class == WorkerClass::Recording ? g_WorkerLayout.RecordingCores : g_WorkerLayout.IOCores;
+    return std::max(static_cast<std::uint32_t>(std::size(Cores)), 1U);
+}
+
+void RenderCore::SetupCurrentWorkerThread(WorkerClass const Class, std::uint32_t const Index)
+{
+    std::optional<std::size_t> CoreIndex {};
+    bool                       PinWorkers { false };
+
+    {
+        std::lock_guard const Lock { g_WorkerThreadMutex };
+
+        std::vector<std::size_t> const &Cores = Class == WorkerClass::Recording ? g_WorkerLayout.RecordingCores : g_WorkerLayout.IOCores;
+
+        if (!std::empty(Cores))
+        {
+            CoreIndex = Cores.at(Index % std::size(Cores));
+        }
+
+        PinWorkers = g_WorkerThreadSettings.PinWorkers;
+    }
+
+    #ifdef _WIN32
+    std::wstring const Name = std::format(L"RenderCore {} Worker {}", Class == WorkerClass::Recording ? L"Recording" : L"IO", Index);
+    SetThreadDescription(GetCurrentThread(), std::data(Name));
+
+    if (!PinWorkers || !CoreIndex.has_value())
+    {
+        return;
+    }
+
+    // The whole core is given to the worker, so its SMT siblings stay free of other workers
+    CPUCore const &      Core = GetCPUTopology().Cores.at(CoreIndex.value());
+    GROUP_AFFINITY const Affinity { .Mask = static_cast<KAFFINITY>(Core.Mask), .Group = Core.Group };
+
+    if (Core.Mask != 0U && !SetThreadGroupAffinity(GetCurrentThread(), &Affinity, nullptr))
+    {
+        RENDERCORE_LOG(warning, "Failed to pin worker {} to core {}", Index, CoreIndex.value());
+    }
+    #endif // _WIN32
+}
@@ -0,0 +1,179 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.JobGraph;
+
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+// Job being executed by the current thread, to tell the jobs it adds to its own graph apart
+thread_local JobGraph const *g_ExecutingGraph { nullptr };
+thread_local Job *           g_ExecutingJob { nullptr };
+
+JobGraph::JobGraph(ThreadPool::Pool &Pool, std::uint32_t const NumThreads, std::size_t const ArenaSize)
+    : m_Pool(Pool)
+  , m_NumThreads(std::max(NumThreads, 1U))
+  , m_ArenaBuffer(ArenaSize)
+  , m_Arena(std::data(m_ArenaBuffer), std::size(m_ArenaBuffer))
+{
+}
+
+JobGraph::~JobGraph()
+{
+    Reset();
+}
+
+void JobGraph::AddDependency(JobHandle const Before, JobHandle const After)
+{
+    std::lock_guard const Lock { m_Mutex };
+
+    if (Before->IsFinished.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    After->PendingDependencies.fetch_add(1U, std::memory_order_relaxed);
+    Before->Continuations.push_back(After);
+}
+
+// Released with the graph locked, so no job is added meanwhile, and cleared to keep the capacity of the list for the next frame
+void JobGraph::Dispatch()
+{
+    std::lock_guard const Lock { m_Mutex };
+
+    for (Job *const JobIt : m_HeldJobs)
+    {
+        Release(*JobIt);
+    }
+
+    m_HeldJobs.clear();
+}
+
+// Must not be called from a job of the same graph: the calling worker would wait on itself
+void JobGraph::Wait()
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    Dispatch();
+
+    std::uint32_t Pending = m_PendingJobs.load(std::memory_order_acquire);
+
+    while (Pending != 0U)
+    {
+        m_PendingJobs.wait(Pending, std::memory_order_acquire);
+        Pending = m_PendingJobs.load(std::memory_order_acquire);
+    }
+
+    // The last job decrements and notifies under the lock: once it's taken here, no worker touches the graph anymore and it can be reset or destroyed
+    std::lock_guard const Lock { m_Mutex };
+}
+
+// Same restriction as the overload above; lets the caller overlap its own work with the rest of the graph
+void JobGraph::Wait(JobHandle const Target)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    Dispatch();
+    Target->IsFinished.wait(false, std::memory_order_acquire);
+}
+
+void JobGraph::Reset()
+{
+    Wait();
+
+    for (Job *const JobIt : m_Jobs)
+    {
+        JobIt->Destroy(JobIt->Callable);
+        std::destroy_at(JobIt);
+    }
+
+    m_Jobs.clear();
+    m_HeldJobs.clear();
+    m_Arena.release();
+    m_NextThread.store(0U, std::memory_order_relaxed);
+}
+
+// Called with the graph locked; the pending count includes the job right away, so a Wait can't return before it runs
+void JobGraph::Hold(Job &Target)
+{
+    m_Jobs.push_back(&Target);
+    m_PendingJobs.fetch_add(1U, std::memory_order_relaxed);
+
+    if (g_ExecutingGraph == this && g_ExecutingJob != nullptr)
+    {
+        g_ExecutingJob->SpawnedJobs.push_back(&Target);
+    }
+    else
+    {
+        m_HeldJobs.push_back(&Target);
+    }
+}
+
+bool JobGraph::IsComplete() const
+{
+    return m_PendingJobs.load(std::memory_order_acquire) == 0U;
+}
+
+void JobGraph::Release(Job &Target)
+{
+    if (Target.PendingDependencies.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+    {
+        Schedule(Target);
+    }
+}
+
+void JobGraph::Schedule(Job &Target)
+{
+    auto const ThreadIndex = static_cast<std::uint8_t>(m_NextThread.fetch_add(1U, std::memory_order_relaxed) % m_NumThreads);
+
+    m_Pool.AddTask([this, &Target]
+                   {
+                       Execute(Target);
+                   },
+                   ThreadIndex);
+}
+
+void JobGraph::Execute(Job &Target)
+{
+    {
+        RENDERCORE_PROFILE_SCOPE(Target.Name);
+
+        JobGraph const *const PreviousGraph = std::exchange(g_ExecutingGraph, this);
+        Job *const            PreviousJob   = std::exchange(g_ExecutingJob, &Target);
+
+        Target.Invoke(Target.Callable);
+
+        g_ExecutingGraph = PreviousGraph;
+        g_ExecutingJob   = PreviousJob;
+    }
+
+    {
+        std::lock_guard const Lock { m_Mutex };
+        Target.IsFinished.store(true, std::memory_order_release);
+    }
+
+    Target.IsFinished.notify_all();
+
+    // No dependency can be added to a finished job, so the list is stable from here
+    for (Job *const ContinuationIt : Target.Continuations)
+    {
+        Release(*ContinuationIt);
+    }
+
+    // Only this thread added to the list, while the job was running
+    for (Job *const SpawnedJobIt : Target.SpawnedJobs)
+    {
+        Release(*SpawnedJobIt);
+    }
+
+    std::lock_guard const Lock { m_Mutex };
+
+    if (m_PendingJobs.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+    {
+        m_PendingJobs.notify_all();
+    }
+}
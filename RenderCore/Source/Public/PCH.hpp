@@ -8,12 +8,16 @@
 #pragma once
 
 #include "RenderCoreModule.hpp"
+#include "RenderCoreProfiler.hpp"
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <charconv>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <execution>
 #include <filesystem>
 #include <format>
@@ -21,9 +25,13 @@
 #include <functional>
 #include <future>
 #include <limits>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <numeric>
 #include <optional>
+#include <queue>
 #include <ranges>
 #include <regex>
 #include <semaphore>
@@ -49,6 +57,8 @@
 #include <glm/ext.hpp>
 #include <tiny_gltf.h>
 
+#include "RenderCoreLogger.hpp"
+
 #include <stringzilla/stringzilla.hpp>
 namespace strzilla = ashvardanian::stringzilla;
 
@@ -0,0 +1,30 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+#ifndef RENDERCORELOGGER_H
+#define RENDERCORELOGGER_H
+
+// Records below this boost::log::trivial severity are discarded at compile time, arguments included
+#ifndef RENDERCORE_MIN_LOG_LEVEL
+#define RENDERCORE_MIN_LOG_LEVEL 0
+#endif
+
+// Translation units using the macro must import RenderCore.Utils.Logger
+#define RENDERCORE_LOG(Severity, ...)                                                                   \
+        do                                                                                              \
+        {                                                                                               \
+            if constexpr (boost::log::trivial::Severity >= RENDERCORE_MIN_LOG_LEVEL)                    \
+            {                                                                                           \
+                RenderCore::PushLogRecord<boost::log::trivial::Severity>(__func__, __VA_ARGS__);        \
+            }                                                                                           \
+        }                                                                                               \
+        while (false)
+
+namespace RenderCore
+{
+    // Enqueues an already formatted message; declared here so it is also reachable from global module fragments (e.g.: VMA's leak log)
+    RENDERCOREMODULE_API void EnqueueLogMessage(boost::log::trivial::severity_level, char const *, std::string_view);
+} // namespace RenderCore
+
+#endif
@@ -0,0 +1,22 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+#ifndef RENDERCOREPROFILER_H
+#define RENDERCOREPROFILER_H
+
+// Zones are only recorded when RENDERCORE_ENABLE_PROFILER is set; otherwise the macros expand to nothing
+// Translation units using the macros must import RenderCore.Utils.Profiler
+#if defined(RENDERCORE_ENABLE_PROFILER) && RENDERCORE_ENABLE_PROFILER
+#define RENDERCORE_PROFILER_CONCAT_IMPL(Lhs, Rhs) Lhs##Rhs
+#define RENDERCORE_PROFILER_CONCAT(Lhs, Rhs) RENDERCORE_PROFILER_CONCAT_IMPL(Lhs, Rhs)
+
+#define RENDERCORE_PROFILE_SCOPE(Name) RenderCore::ProfilerZone const RENDERCORE_PROFILER_CONCAT(ProfilerZone_, __LINE__) { Name }
+#define RENDERCORE_PROFILE_FUNCTION() RENDERCORE_PROFILE_SCOPE(__func__)
+#define RENDERCORE_PROFILE_THREAD(Name) RenderCore::SetProfilerThreadName(Name)
+#else
+#define RENDERCORE_PROFILE_SCOPE(Name)
+#define RENDERCORE_PROFILE_FUNCTION()
+#define RENDERCORE_PROFILE_THREAD(Name)
+#endif
+#endif
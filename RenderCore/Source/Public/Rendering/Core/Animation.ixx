@@ -0,0 +1,22 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.Animation;
+
+import RenderCore.Utils.JobGraph;
+
+namespace RenderCore
+{
+    // Skeletons evaluated by each job: a skeleton is a few tracks, so smaller batches would cost more to schedule than to evaluate
+    export constexpr std::uint32_t g_AnimationBatchSize { 8U };
+}
+
+export namespace RenderCore
+{
+    void ScheduleAnimations(JobGraph &, JobHandle, JobHandle, float);
+    void TickAnimations(float);
+    void ReleaseAnimationResources();
+} // namespace RenderCore
@@ -0,0 +1,52 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.Capture;
+
+import RenderCore.Types.Transform;
+
+namespace RenderCore
+{
+    export struct RENDERCOREMODULE_API TiledCaptureSettings
+    {
+        VkExtent2D    Extent {};
+        std::uint32_t MaxTileSize { 2048U };
+    };
+
+    export struct RENDERCOREMODULE_API BatchCameraPose
+    {
+        glm::vec3 Position { 0.F, 0.F, 1.F };
+        glm::vec3 Rotation { -90.F, 0.F, 0.F };
+    };
+
+    export struct RENDERCOREMODULE_API BatchObjectTransform
+    {
+        std::uint32_t ObjectID {};
+        Transform     ObjectTransform {};
+    };
+
+    export struct RENDERCOREMODULE_API BatchRenderFrame
+    {
+        BatchCameraPose                   Pose {};
+        std::vector<BatchObjectTransform> ObjectTransforms {};
+    };
+
+    export using BatchRenderSink = std::function<void(std::uint32_t, VkExtent2D const &, VkFormat, std::vector<std::uint8_t> &&)>;
+
+    export struct RENDERCOREMODULE_API BatchRenderRequest
+    {
+        std::vector<BatchRenderFrame> Frames {};
+        VkExtent2D                    Extent {};
+        strzilla::string              OutputPathFormat {};
+        BatchRenderSink               Sink {};
+    };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    RENDERCOREMODULE_API bool CaptureTiledImage(strzilla::string_view, TiledCaptureSettings const &);
+    RENDERCOREMODULE_API bool RenderBatch(BatchRenderRequest const &);
+} // namespace RenderCore
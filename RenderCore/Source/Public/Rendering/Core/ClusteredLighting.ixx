@@ -0,0 +1,59 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.ClusteredLighting;
+
+import RenderCore.Types.Allocation;
+import RenderCore.Types.Illumination;
+import RenderCore.Types.UniformBufferObject;
+
+namespace RenderCore
+{
+    // View space froxels: screen tiles split in exponential depth slices; must match the defines of the default shaders
+    export constexpr std::uint32_t g_ClusterGridX { 16U };
+    export constexpr std::uint32_t g_ClusterGridY { 9U };
+    export constexpr std::uint32_t g_ClusterGridZ { 24U };
+    export constexpr std::uint32_t g_NumClusters { g_ClusterGridX * g_ClusterGridY * g_ClusterGridZ };
+    export constexpr std::uint32_t g_MaxPointLights { 1024U };
+    export constexpr std::uint32_t g_MaxLightsPerCluster { 128U };
+    export constexpr std::uint32_t g_LightCullingGroupSize { 64U };
+
+    // std430 element of the light buffer
+    export struct RENDERCOREMODULE_API GPUPointLight
+    {
+        alignas(16) glm::vec4 PositionRadius {};
+        alignas(16) glm::vec4 ColorIntensity {};
+    };
+
+    // The cluster buffer holds the light count of each cluster, followed by a fixed capacity index list per cluster
+    export constexpr VkDeviceSize g_ClusterCountsSize { g_NumClusters * sizeof(std::uint32_t) };
+    export constexpr VkDeviceSize g_ClusterBufferSize { g_ClusterCountsSize + g_NumClusters * g_MaxLightsPerCluster * sizeof(std::uint32_t) };
+
+    RENDERCOREMODULE_API BufferAllocation g_PointLightBuffer {};
+    RENDERCOREMODULE_API BufferAllocation g_ClusterBuffer {};
+}
+
+export namespace RenderCore
+{
+    void CreateClusteredLightingResources();
+    void ReleaseClusteredLightingResources();
+
+    void FillClusterUniformData(SceneUniformData &, glm::mat4 const &, glm::mat4 const &, float, float, std::size_t);
+    void UpdateClusteredLighting(std::span<PointLight const>, SceneUniformData const &);
+    void RecordLightCulling(VkCommandBuffer const &);
+
+    [[nodiscard]] bool IsLightCullingOnGPU();
+
+    RENDERCOREMODULE_API [[nodiscard]] inline BufferAllocation const &GetPointLightBuffer()
+    {
+        return g_PointLightBuffer;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline BufferAllocation const &GetClusterBuffer()
+    {
+        return g_ClusterBuffer;
+    }
+} // namespace RenderCore
@@ -7,11 +7,17 @@ module;
 export module RenderCore.Runtime.Command;
 
 import ThreadPool;
+import RenderCore.Runtime.FrameState;
 import RenderCore.Types.Allocation;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.FrameAllocator;
+import RenderCore.Utils.JobGraph;
 
 namespace RenderCore
 {
-    RENDERCOREMODULE_API ThreadPool::Pool g_ThreadPool {};
+    RENDERCOREMODULE_API ThreadPool::Pool                                          g_ThreadPool {};
+    RENDERCOREMODULE_API std::array<std::unique_ptr<JobGraph>, g_ImageCount>       g_FrameJobGraphs {};
+    RENDERCOREMODULE_API std::array<std::unique_ptr<FrameAllocator>, g_ImageCount> g_FrameAllocators {};
 
     std::function<void(std::uint8_t)>                                     g_OnCommandPoolResetCallback {};
     std::function<void(VkCommandBuffer const &, ImageAllocation const &)> g_OnCommandBufferRecordCallback {};
@@ -27,14 +33,14 @@ namespace RenderCore
         void Reset(VkDevice const &);
     };
 
-    [[nodiscard]] VkCommandPool CreateCommandPool(std::uint8_t, VkCommandPoolCreateFlags);
-    export void                 SetNumObjectsPerThread(std::uint32_t);
-    export void                 ResetCommandPool(std::uint32_t);
-    export void                 FreeCommandBuffers();
-    export void                 InitializeCommandsResources(std::uint32_t);
-    export void                 ReleaseCommandsResources();
-    export void                 RecordCommandBuffers(std::uint32_t);
-    export void                 SubmitCommandBuffers(std::uint32_t);
+    export [[nodiscard]] VkCommandPool CreateCommandPool(std::uint8_t, VkCommandPoolCreateFlags);
+    export void                        SetNumObjectsPerThread(std::uint32_t);
+    export void                        ResetCommandPool(std::uint32_t);
+    export void                        FreeCommandBuffers();
+    export void                        InitializeCommandsResources(std::uint32_t);
+    export void                        ReleaseCommandsResources();
+    export void                        RecordCommandBuffers(std::uint32_t, SceneFrameState const &, JobHandle = nullptr);
+    export void                        SubmitCommandBuffers(std::uint32_t);
 
     export RENDERCOREMODULE_API void InitializeSingleCommandQueue(VkCommandPool &, std::vector<VkCommandBuffer> &, std::uint8_t);
     export RENDERCOREMODULE_API void FinishSingleCommandQueue(VkQueue const &, VkCommandPool const &, std::vector<VkCommandBuffer> const &);
@@ -44,6 +50,20 @@ namespace RenderCore
         return g_ThreadPool;
     }
 
+    // Jobs of a frame slot are only waited on by that slot, and their arena is recycled with its command pools
+    export RENDERCOREMODULE_API [[nodiscard]] inline JobGraph &GetFrameJobGraph(std::uint32_t const Index)
+    {
+        return *g_FrameJobGraphs.at(Index);
+    }
+
+    // Transient data of a frame slot, recycled with its command pools; the render graph of the slot and the recording lists are built from it
+    export RENDERCOREMODULE_API [[nodiscard]] inline FrameAllocator &GetFrameAllocator(std::uint32_t const Index)
+    {
+        return *g_FrameAllocators.at(Index);
+    }
+
+    export RENDERCOREMODULE_API [[nodiscard]] FrameAllocationStats GetFrameAllocationStats();
+
     export RENDERCOREMODULE_API inline void SetOnCommandPoolResetCallbackCallback(std::function<void(std::uint8_t)> &&Callback)
     {
         g_OnCommandPoolResetCallback = std::move(Callback);
@@ -10,12 +10,27 @@ import RenderCore.Types.SurfaceProperties;
 
 namespace RenderCore
 {
+    export struct RENDERCOREMODULE_API PhysicalDeviceCandidate
+    {
+        VkPhysicalDevice                       Device { VK_NULL_HANDLE };
+        std::uint32_t                          Index { 0U };
+        strzilla::string                       Name {};
+        std::array<std::uint8_t, VK_UUID_SIZE> UUID {};
+        VkPhysicalDeviceType                   Type { VK_PHYSICAL_DEVICE_TYPE_OTHER };
+        VkDeviceSize                           DeviceLocalMemory { 0U };
+        std::uint64_t                          Score { 0U };
+        bool                                   IsSuitable { false };
+        bool                                   SupportsVisibilityBuffer { false };
+    };
+
     RENDERCOREMODULE_API VkPhysicalDevice           g_PhysicalDevice{VK_NULL_HANDLE};
     RENDERCOREMODULE_API VkPhysicalDeviceProperties g_PhysicalDeviceProperties{};
     RENDERCOREMODULE_API VkDevice                   g_Device{VK_NULL_HANDLE};
     RENDERCOREMODULE_API std::pair<std::uint8_t, VkQueue> g_GraphicsQueue{};
     RENDERCOREMODULE_API std::vector<std::uint8_t> g_UniqueQueueFamilyIndices{};
     RENDERCOREMODULE_API std::function<SurfaceProperties()> g_OnGetSurfaceProperties{};
+    RENDERCOREMODULE_API PhysicalDeviceCandidate g_SelectedPhysicalDevice{};
+    RENDERCOREMODULE_API strzilla::string g_PhysicalDeviceOverride{};
 
     export void InitializeDevice(VkSurfaceKHR const &);
     export void ReleaseDeviceResources();
@@ -27,6 +42,8 @@ namespace RenderCore
     }
     export RENDERCOREMODULE_API [[nodiscard]] std::vector<std::uint32_t> GetUniqueQueueFamilyIndicesU32();
 
+    export RENDERCOREMODULE_API [[nodiscard]] std::vector<PhysicalDeviceCandidate> GetPhysicalDeviceCandidates();
+
     export RENDERCOREMODULE_API [[nodiscard]] std::vector<VkPhysicalDevice>      GetAvailablePhysicalDevices();
     export RENDERCOREMODULE_API [[nodiscard]] std::vector<VkExtensionProperties> GetAvailablePhysicalDeviceExtensions();
     export RENDERCOREMODULE_API [[nodiscard]] std::vector<VkLayerProperties>     GetAvailablePhysicalDeviceLayers();
@@ -42,6 +59,24 @@ namespace RenderCore
         g_OnGetSurfaceProperties = std::move(Callback);
     }
 
+    // Name (case-insensitive substring), enumeration index or UUID. The RENDERCORE_PHYSICAL_DEVICE environment variable is used when empty
+    export RENDERCOREMODULE_API inline void SetPhysicalDeviceOverride(strzilla::string_view const Value)
+    {
+        g_PhysicalDeviceOverride = Value;
+    }
+
+    export RENDERCOREMODULE_API [[nodiscard]] inline PhysicalDeviceCandidate const &GetSelectedPhysicalDevice()
+    {
+        return g_SelectedPhysicalDevice;
+    }
+
+    // gl_PrimitiveID in the visibility fragment shader, rg32ui storage image reads and a non uniformly indexed array of the material maps in the resolve;
+    // only enabled when the device has them
+    export RENDERCOREMODULE_API [[nodiscard]] inline bool IsVisibilityBufferSupported()
+    {
+        return g_SelectedPhysicalDevice.SupportsVisibilityBuffer;
+    }
+
     export RENDERCOREMODULE_API [[nodiscard]] inline VkDevice &GetLogicalDevice()
     {
         return g_Device;
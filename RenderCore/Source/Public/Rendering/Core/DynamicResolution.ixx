@@ -0,0 +1,80 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.DynamicResolution;
+
+import RenderCore.Utils.Constants;
+import RenderCore.Types.Allocation;
+import RenderCore.Types.SurfaceProperties;
+
+namespace RenderCore
+{
+    export struct RENDERCOREMODULE_API DynamicResolutionSettings
+    {
+        bool  Enabled { false };
+        float TargetGPUTime { 16.F };
+        float MinScale { 0.5F };
+        float MaxScale { 1.F };
+        float Tolerance { 0.05F };
+        float AdjustmentRate { 0.25F };
+    };
+
+    RENDERCOREMODULE_API DynamicResolutionSettings         g_DynamicResolutionSettings {};
+    RENDERCOREMODULE_API ImageAllocation                   g_ScaledColorImage {};
+    RENDERCOREMODULE_API VkQueryPool                       g_TimestampQueryPool { VK_NULL_HANDLE };
+    RENDERCOREMODULE_API std::array<bool, g_ImageCount>    g_PendingTimestamps {};
+    RENDERCOREMODULE_API std::uint64_t                     g_TimestampMask { 0U };
+    RENDERCOREMODULE_API float                             g_ResolutionScale { 1.F };
+    RENDERCOREMODULE_API float                             g_GPUFrameTime { 0.F };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    void CreateTimestampQueryPool();
+    void ReleaseTimestampQueryPool();
+
+    void CreateScaledColorImage(SurfaceProperties const &);
+    void DestroyScaledColorImage();
+
+    void UpdateDynamicResolution(std::uint32_t);
+    void BeginFrameTimestamp(VkCommandBuffer const &, std::uint32_t);
+    void EndFrameTimestamp(VkCommandBuffer const &, std::uint32_t);
+
+    // Only records the blit: the scaled image and the target are transitioned by the frame render graph
+    void RecordUpscale(VkCommandBuffer const &, VkExtent2D const &, ImageAllocation const &);
+
+    RENDERCOREMODULE_API [[nodiscard]] VkExtent2D GetRenderExtent(VkExtent2D const &);
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool IsDynamicResolutionActive()
+    {
+        return g_DynamicResolutionSettings.Enabled && g_ScaledColorImage.IsValid();
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline DynamicResolutionSettings const &GetDynamicResolutionSettings()
+    {
+        return g_DynamicResolutionSettings;
+    }
+
+    RENDERCOREMODULE_API inline void SetDynamicResolutionSettings(DynamicResolutionSettings const &Settings)
+    {
+        g_DynamicResolutionSettings = Settings;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline ImageAllocation const &GetScaledColorImage()
+    {
+        return g_ScaledColorImage;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline float GetResolutionScale()
+    {
+        return IsDynamicResolutionActive() ? g_ResolutionScale : 1.F;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline float GetGPUFrameTime()
+    {
+        return g_GPUFrameTime;
+    }
+} // namespace RenderCore
@@ -0,0 +1,75 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.FrameState;
+
+import RenderCore.Types.Illumination;
+import RenderCore.Types.Object;
+import RenderCore.Types.Transform;
+import RenderCore.Types.UniformBufferObject;
+
+namespace RenderCore
+{
+    // Double buffered: the application may produce one frame ahead of the one being recorded
+    export constexpr std::uint8_t g_NumFrameStates { 2U };
+
+    export struct RENDERCOREMODULE_API ObjectFrameState
+    {
+        std::shared_ptr<Object> Owner { nullptr };
+        ModelUniformData        UniformData {};
+        Bounds                  MeshBounds {};
+        glm::vec3               MeshCenter {};
+        std::uint32_t           NumInstances { 1U };
+        bool                    CanDraw { false };
+        bool                    IsUniformDirty { false };
+    };
+
+    // Everything the recording reads from the scene; the object list keeps the indices of the scene objects
+    export struct RENDERCOREMODULE_API SceneFrameState
+    {
+        std::uint64_t                 FrameNumber { 0U };
+        std::uint64_t                 SceneGeneration { 0U };
+        float                         DeltaTime { 0.F };
+        SceneUniformData              SceneData {};
+        bool                          IsSceneDirty { false };
+        glm::vec3                     CameraPosition {};
+        float                         DrawDistance { 0.F };
+        std::array<glm::vec4, 6U>     FrustumPlanes {};
+        std::vector<PointLight>       PointLights {};
+        std::vector<glm::mat4>        JointMatrices {};
+        std::vector<ObjectFrameState> Objects {};
+
+        [[nodiscard]] bool IsVisible(ObjectFrameState const &) const;
+    };
+
+    // Bounded single producer, single consumer handoff: the producer blocks while every state is still queued
+    export class RENDERCOREMODULE_API FrameStateQueue
+    {
+        std::array<SceneFrameState, g_NumFrameStates> m_States {};
+        std::uint32_t                                 m_WriteIndex { 0U };
+        std::uint32_t                                 m_ReadIndex { 0U };
+        std::uint32_t                                 m_NumQueued { 0U };
+        bool                                          m_IsOpen { false };
+        std::mutex                                    m_Mutex {};
+        std::condition_variable                       m_Condition {};
+
+    public:
+        void Open();
+        void Close();
+        void Reset();
+
+        [[nodiscard]] SceneFrameState *      BeginWrite();
+        void                                 EndWrite();
+        [[nodiscard]] SceneFrameState const *BeginRead();
+        void                                 EndRead();
+
+        // Called by the producer: once it returns, the consumer is done with every state and waits for the next one
+        void WaitUntilEmpty();
+    };
+
+    export void CaptureFrameState(SceneFrameState &, float);
+    export void RestoreFrameStateDirtiness(SceneFrameState const &);
+} // namespace RenderCore
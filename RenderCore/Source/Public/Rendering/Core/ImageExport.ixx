@@ -0,0 +1,52 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.ImageExport;
+
+namespace RenderCore
+{
+    export enum class ImageExportFormat : std::uint8_t
+    {
+        PNG,
+        QOI,
+        TGA,
+        RAW
+    };
+
+    export struct RENDERCOREMODULE_API ImageExportSettings
+    {
+        std::uint8_t NumWorkers { 2U };
+        std::int32_t PNGCompressionLevel { 8 };
+        std::size_t  MaxInFlightBytes { 512ULL * 1024ULL * 1024ULL };
+        bool         PreserveOrder { true };
+    };
+
+    export struct RENDERCOREMODULE_API ImageExportRequest
+    {
+        strzilla::string          Path {};
+        ImageExportFormat         Format { ImageExportFormat::PNG };
+        VkExtent2D                Extent {};
+        VkFormat                  PixelFormat { VK_FORMAT_R8G8B8A8_UNORM };
+        std::vector<std::uint8_t> Pixels {};
+    };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    RENDERCOREMODULE_API void                              SetImageExportSettings(ImageExportSettings const &);
+    RENDERCOREMODULE_API [[nodiscard]] ImageExportSettings GetImageExportSettings();
+
+    RENDERCOREMODULE_API std::uint64_t EnqueueImageExport(ImageExportRequest &&);
+    RENDERCOREMODULE_API void          WaitImageExports();
+    void                               ReleaseImageExportResources();
+
+    RENDERCOREMODULE_API [[nodiscard]] std::size_t       GetImageExportInFlightBytes();
+    RENDERCOREMODULE_API [[nodiscard]] ImageExportFormat GetImageExportFormatFromPath(strzilla::string_view);
+    RENDERCOREMODULE_API [[nodiscard]] bool              IsBGRAFormat(VkFormat);
+
+    RENDERCOREMODULE_API [[nodiscard]] std::vector<std::uint8_t> EncodeImage(ImageExportRequest &);
+    RENDERCOREMODULE_API [[nodiscard]] std::array<std::uint8_t, 18U> MountTGAHeader(VkExtent2D const &);
+} // namespace RenderCore
@@ -10,12 +10,20 @@ import RenderCore.Runtime.Scene;
 import RenderCore.Types.Allocation;
 import RenderCore.Types.Object;
 import RenderCore.Types.Texture;
+import RenderCore.Types.Vertex;
 import RenderCore.Utils.Constants;
 import RenderCore.Utils.EnumHelpers;
 import RenderCore.Utils.Helpers;
 
 namespace RenderCore
 {
+    export struct RENDERCOREMODULE_API ModelsBufferLayout
+    {
+        VkDeviceSize VertexBufferSize { 0U };
+        VkDeviceSize IndexBufferSize { 0U };
+        VkDeviceSize UniformOffset { 0U };
+    };
+
     VmaPool                                            g_StagingBufferPool{VK_NULL_HANDLE};
     VmaPool                                            g_DescriptorBufferPool{VK_NULL_HANDLE};
     VmaPool                                            g_BufferPool{VK_NULL_HANDLE};
@@ -35,6 +43,7 @@ export namespace RenderCore
     VmaAllocationInfo CreateBuffer(VkDeviceSize const &, VkBufferUsageFlags, strzilla::string_view, VkBuffer &, VmaAllocation &);
     void              CopyBuffer(VkCommandBuffer const &, VkBuffer const &, VkBuffer const &, VkDeviceSize const &);
     void              CreateUniformBuffers(BufferAllocation &, VkDeviceSize, strzilla::string_view);
+    VkDeviceAddress   GetBufferDeviceAddress(VkBuffer const &);
 
     void CreateImage(
             VkFormat const &, VkExtent2D const &, VkImageTiling const &, VkImageUsageFlags, VmaMemoryUsage, strzilla::string_view, VkImage &, VmaAllocation &);
@@ -45,6 +54,10 @@ export namespace RenderCore
     [[nodiscard]] std::tuple<std::uint32_t, VkBuffer, VmaAllocation>
     AllocateTexture(VkCommandBuffer const &, unsigned char const *, std::uint32_t, std::uint32_t, VkFormat, VkDeviceSize);
 
+    RENDERCOREMODULE_API [[nodiscard]] ModelsBufferLayout PackModelsBuffers(std::vector<std::shared_ptr<Object>> const &,
+                                                                             VkDeviceSize,
+                                                                             std::vector<Vertex> &,
+                                                                             std::vector<std::uint32_t> &);
     void AllocateModelsBuffers(std::vector<std::shared_ptr<Object>> const &);
 
     template <VkImageLayout OldLayout, VkImageLayout NewLayout, VkImageAspectFlags Aspect>
@@ -148,7 +161,8 @@ export namespace RenderCore
         vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
     }
 
-    RENDERCOREMODULE_API void SaveImageToFile(VkImage const &, strzilla::string_view, VkExtent2D const &);
+    RENDERCOREMODULE_API [[nodiscard]] std::vector<std::uint8_t> ReadbackImage(VkImage const &, VkExtent2D const &);
+    RENDERCOREMODULE_API void SaveImageToFile(VkImage const &, strzilla::string_view, VkExtent2D const &, VkFormat = VK_FORMAT_R8G8B8A8_UNORM);
 
     struct TextureDeleter
     {
@@ -6,13 +6,32 @@ module;
 
 export module RenderCore.Runtime.Model;
 
+import RenderCore.Types.Animation;
 import RenderCore.Types.Mesh;
+import RenderCore.Types.Skeleton;
 
 namespace RenderCore
 {
     void         InsertIndiceInContainer(std::vector<std::uint32_t> &, tinygltf::Accessor const &, auto const *);
     float const *GetPrimitiveData(strzilla::string_view const &, tinygltf::Model const &, tinygltf::Primitive const &, std::uint32_t *);
-    export void  SetVertexAttributes(std::shared_ptr<Mesh> const &, tinygltf::Model const &, tinygltf::Primitive const &);
-    export void  AllocatePrimitiveIndices(std::shared_ptr<Mesh> const &, tinygltf::Model const &, tinygltf::Primitive const &);
-    export void  SetPrimitiveTransform(std::shared_ptr<Mesh> const &, tinygltf::Node const &);
+
+    std::pmr::vector<glm::vec4> GetPrimitiveVec4Data(strzilla::string_view const &,
+                                                     tinygltf::Model const &,
+                                                     tinygltf::Primitive const &,
+                                                     std::pmr::memory_resource *);
+
+    std::pmr::vector<float> GetAccessorFloatData(tinygltf::Model const &, std::int32_t, std::pmr::memory_resource *);
+
+    // The memory resource receives the data only needed while the model is loaded
+    export void SetVertexAttributes(std::shared_ptr<Mesh> const &,
+                                    tinygltf::Model const &,
+                                    tinygltf::Primitive const &,
+                                    std::pmr::memory_resource * = std::pmr::get_default_resource());
+    export void AllocatePrimitiveIndices(std::shared_ptr<Mesh> const &, tinygltf::Model const &, tinygltf::Primitive const &);
+    export void SetPrimitiveTransform(std::shared_ptr<Mesh> const &, tinygltf::Node const &);
+
+    export [[nodiscard]] std::shared_ptr<Skeleton>  ConstructSkeleton(tinygltf::Model const &);
+    export [[nodiscard]] std::vector<AnimationClip> ConstructAnimations(tinygltf::Model const &,
+                                                                        Skeleton const &,
+                                                                        std::pmr::memory_resource * = std::pmr::get_default_resource());
 } // namespace RenderCore
@@ -8,6 +8,7 @@ export module RenderCore.Runtime.Pipeline;
 
 import RenderCore.Types.Allocation;
 import RenderCore.Types.Object;
+import RenderCore.Types.SurfaceProperties;
 
 namespace RenderCore
 {
@@ -18,7 +19,15 @@ namespace RenderCore
         VkPipeline       PreRasterizationPipeline { VK_NULL_HANDLE };
         VkPipeline       FragmentOutputPipeline { VK_NULL_HANDLE };
         VkPipeline       FragmentShaderPipeline { VK_NULL_HANDLE };
+        VkPipeline       LightCullingPipeline { VK_NULL_HANDLE };
+        VkPipeline       VisibilityPipeline { VK_NULL_HANDLE };
+        VkPipeline       VisibilityFragmentOutputPipeline { VK_NULL_HANDLE };
+        VkPipeline       VisibilityFragmentShaderPipeline { VK_NULL_HANDLE };
+        VkPipeline       VisibilityResolvePipeline { VK_NULL_HANDLE };
+        VkPipeline       SkinningPipeline { VK_NULL_HANDLE };
         VkPipelineLayout PipelineLayout { VK_NULL_HANDLE };
+        VkPipelineLayout VisibilityResolveLayout { VK_NULL_HANDLE };
+        VkPipelineLayout SkinningLayout { VK_NULL_HANDLE };
         VkPipelineCache  PipelineCache { VK_NULL_HANDLE };
         VkPipelineCache  PipelineLibraryCache { VK_NULL_HANDLE };
 
@@ -26,7 +35,10 @@ namespace RenderCore
         {
             return MainPipeline != VK_NULL_HANDLE || FragmentShaderPipeline != VK_NULL_HANDLE || VertexInputPipeline != VK_NULL_HANDLE ||
                    PreRasterizationPipeline != VK_NULL_HANDLE || FragmentOutputPipeline != VK_NULL_HANDLE || PipelineLayout != VK_NULL_HANDLE ||
-                   PipelineCache != VK_NULL_HANDLE || PipelineLibraryCache != VK_NULL_HANDLE;
+                   PipelineCache != VK_NULL_HANDLE || PipelineLibraryCache != VK_NULL_HANDLE || LightCullingPipeline != VK_NULL_HANDLE ||
+                   VisibilityPipeline != VK_NULL_HANDLE || VisibilityFragmentOutputPipeline != VK_NULL_HANDLE ||
+                   VisibilityFragmentShaderPipeline != VK_NULL_HANDLE || VisibilityResolvePipeline != VK_NULL_HANDLE ||
+                   VisibilityResolveLayout != VK_NULL_HANDLE || SkinningPipeline != VK_NULL_HANDLE || SkinningLayout != VK_NULL_HANDLE;
         }
 
         void DestroyResources(VkDevice const &, bool);
@@ -40,6 +52,8 @@ namespace RenderCore
         DescriptorData SceneData {};
         DescriptorData ModelData {};
         DescriptorData TextureData {};
+        DescriptorData VisibilityData {};
+        DescriptorData MaterialData {};
 
         [[nodiscard]] inline bool IsValid() const
         {
@@ -49,8 +63,11 @@ namespace RenderCore
         void DestroyResources(VmaAllocator const &, bool);
 
         void SetDescriptorLayoutSize();
-        void SetupSceneBuffer(BufferAllocation const &);
+        void SetupSceneBuffer(BufferAllocation const &, BufferAllocation const &, BufferAllocation const &);
         void SetupModelsBuffer(std::vector<std::shared_ptr<Object>> const &);
+        void WriteModelsDescriptors(std::vector<std::shared_ptr<Object>> const &, VkDeviceAddress, VkDescriptorImageInfo const &) const;
+        void SetupVisibilityBuffer(std::vector<std::shared_ptr<Object>> const &);
+        void WriteVisibilityDescriptors(std::uint32_t, VkImageView const &, VkImageView const &) const;
     };
 
     export extern RENDERCOREMODULE_API PipelineData           g_PipelineData { VK_NULL_HANDLE };
@@ -60,10 +77,16 @@ namespace RenderCore
 export namespace RenderCore
 {
     void CreatePipelineDynamicResources();
-    void CreatePipelineLibraries();
+    void CreatePipelineLibraries(SurfaceProperties const &);
     void SetupPipelineLayouts();
+    void CreateLightCullingPipeline();
+    void CreateVisibilityPipelines();
+    void CreateSkinningPipeline();
     void ReleasePipelineResources(bool);
 
+    void LoadPipelineCacheData();
+    void SavePipelineCacheData();
+
     struct RENDERCOREMODULE_API PipelineLibraryCreationArguments
     {
         VkPipelineRasterizationStateCreateInfo         RasterizationState {};
@@ -72,6 +95,8 @@ export namespace RenderCore
         VkVertexInputBindingDescription                VertexBinding {};
         std::vector<VkVertexInputAttributeDescription> VertexAttributes {};
         std::vector<VkPipelineShaderStageCreateInfo>   ShaderStages {};
+        VkFormat                                       ColorFormat { VK_FORMAT_UNDEFINED };
+        VkFormat                                       DepthFormat { VK_FORMAT_UNDEFINED };
     };
 
     RENDERCOREMODULE_API void CreatePipelineLibraries(PipelineData &, PipelineLibraryCreationArguments const &, VkPipelineCreateFlags, bool);
@@ -86,6 +111,36 @@ export namespace RenderCore
         return g_PipelineData.MainPipeline;
     }
 
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipeline const &GetLightCullingPipeline()
+    {
+        return g_PipelineData.LightCullingPipeline;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipeline const &GetVisibilityPipeline()
+    {
+        return g_PipelineData.VisibilityPipeline;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipeline const &GetVisibilityResolvePipeline()
+    {
+        return g_PipelineData.VisibilityResolvePipeline;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipelineLayout const &GetVisibilityResolveLayout()
+    {
+        return g_PipelineData.VisibilityResolveLayout;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipeline const &GetSkinningPipeline()
+    {
+        return g_PipelineData.SkinningPipeline;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipelineLayout const &GetSkinningLayout()
+    {
+        return g_PipelineData.SkinningLayout;
+    }
+
     RENDERCOREMODULE_API [[nodiscard]] inline VkPipelineCache const &GetPipelineCache()
     {
         return g_PipelineData.PipelineCache;
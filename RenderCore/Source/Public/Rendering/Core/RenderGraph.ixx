@@ -0,0 +1,188 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.RenderGraph;
+
+import RenderCore.Types.Allocation;
+import RenderCore.Utils.Constants;
+
+namespace RenderCore
+{
+    export enum class RenderGraphAccess : std::uint8_t
+    {
+        None,
+        ColorAttachment,
+        DepthAttachment,
+        ShaderRead,
+        Storage,
+        TransferRead,
+        TransferWrite,
+        Present
+    };
+
+    export using RenderGraphResource = std::uint32_t;
+
+    export constexpr RenderGraphResource g_InvalidRenderGraphResource { std::numeric_limits<RenderGraphResource>::max() };
+
+    export struct RENDERCOREMODULE_API TransientImageDescription
+    {
+        VkFormat           Format { VK_FORMAT_UNDEFINED };
+        VkExtent2D         Extent {};
+        VkImageUsageFlags  Usage { 0U };
+        VkImageAspectFlags Aspect { g_ImageAspect };
+
+        [[nodiscard]] bool operator==(TransientImageDescription const &Other) const
+        {
+            return Format == Other.Format && Extent.width == Other.Extent.width && Extent.height == Other.Extent.height && Usage == Other.Usage
+                   && Aspect == Other.Aspect;
+        }
+    };
+
+    struct RenderGraphImageState
+    {
+        VkImageLayout         Layout { g_UndefinedLayout };
+        VkPipelineStageFlags2 Stages { VK_PIPELINE_STAGE_2_NONE };
+        VkAccessFlags2        Access { VK_ACCESS_2_NONE };
+        bool                  IsWrite { false };
+    };
+
+    struct RenderGraphImage
+    {
+        strzilla::string_view     Name {};
+        ImageAllocation           Allocation {};
+        VkImageAspectFlags        Aspect { g_ImageAspect };
+        TransientImageDescription Description {};
+        bool                      IsTransient { false };
+        RenderGraphAccess         ExportAccess { RenderGraphAccess::None };
+        RenderGraphImageState     InitialState {};
+        std::uint32_t             FirstPass { std::numeric_limits<std::uint32_t>::max() };
+        std::uint32_t             LastPass { 0U };
+        std::uint32_t             PhysicalIndex { std::numeric_limits<std::uint32_t>::max() };
+    };
+
+    struct RenderGraphAccessEntry
+    {
+        RenderGraphResource Resource { g_InvalidRenderGraphResource };
+        RenderGraphAccess   Access { RenderGraphAccess::None };
+        bool                IsWrite { false };
+    };
+
+    export class RenderGraph;
+
+    using RenderGraphExecuteFunction = void(*)(void *, VkCommandBuffer const &, RenderGraph const &);
+    using RenderGraphDestroyFunction = void(*)(void *, std::pmr::memory_resource *);
+
+    export class RENDERCOREMODULE_API RenderGraphPass
+    {
+        friend class RenderGraph;
+
+        strzilla::string_view                    m_Name {};
+        RenderGraphExecuteFunction               m_Execute { nullptr };
+        RenderGraphDestroyFunction               m_Destroy { nullptr };
+        void *                                   m_Callable { nullptr };
+        std::pmr::vector<RenderGraphAccessEntry> m_Accesses;
+        std::pmr::vector<VkImageMemoryBarrier2>  m_Barriers;
+        bool                                     m_HasSideEffects { false };
+        bool                                     m_IsCulled { false };
+
+    public:
+        RenderGraphPass(RenderGraphPass const &) = delete;
+
+        RenderGraphPass &operator=(RenderGraphPass const &) = delete;
+
+        explicit RenderGraphPass(std::pmr::memory_resource *const Resource)
+            : m_Accesses(Resource)
+          , m_Barriers(Resource)
+        {
+        }
+
+        ~RenderGraphPass();
+
+        RenderGraphPass &Read(RenderGraphResource, RenderGraphAccess);
+        RenderGraphPass &Write(RenderGraphResource, RenderGraphAccess);
+        RenderGraphPass &SetHasSideEffects();
+    };
+
+    // Containers of the graph being built: created on first use and destroyed on Reset, so nothing is left in the memory resource between frames
+    struct RenderGraphData
+    {
+        std::pmr::vector<RenderGraphImage>      Images;
+        std::pmr::deque<RenderGraphPass>        Passes;
+        std::pmr::vector<VkImageMemoryBarrier2> FinalBarriers;
+        std::pmr::vector<RenderGraphImageState> TransientFinalStates;
+
+        explicit RenderGraphData(std::pmr::memory_resource *const Resource)
+            : Images(Resource)
+          , Passes(Resource)
+          , FinalBarriers(Resource)
+          , TransientFinalStates(Resource)
+        {
+        }
+    };
+
+    // Passes declare what they read and write; barriers, culling and transient image aliasing are derived from that on Compile.
+    // Passes, their callables and the compile data live in the memory resource of the graph, usually the frame allocator of its slot
+    export class RENDERCOREMODULE_API RenderGraph
+    {
+        std::pmr::memory_resource *    m_Resource { nullptr };
+        std::optional<RenderGraphData> m_Data {};
+        bool                           m_IsCompiled { false };
+
+    public:
+        RenderGraph(RenderGraph const &) = delete;
+
+        RenderGraph &operator=(RenderGraph const &) = delete;
+
+        explicit RenderGraph(std::pmr::memory_resource * = std::pmr::get_default_resource());
+
+        [[nodiscard]] RenderGraphResource ImportImage(strzilla::string_view,
+                                                      ImageAllocation const &,
+                                                      VkImageAspectFlags    = g_ImageAspect,
+                                                      VkPipelineStageFlags2 = VK_PIPELINE_STAGE_2_NONE,
+                                                      VkAccessFlags2        = VK_ACCESS_2_NONE);
+        [[nodiscard]] RenderGraphResource CreateTransientImage(strzilla::string_view, TransientImageDescription const &);
+        void                              ExportImage(RenderGraphResource, RenderGraphAccess);
+
+        template <typename Function>
+        RenderGraphPass &AddPass(strzilla::string_view const Name, Function &&Callable)
+        {
+            using CallableType = std::decay_t<Function>;
+
+            std::pmr::polymorphic_allocator<> Allocator { m_Resource };
+
+            RenderGraphPass &Output = GetData().Passes.emplace_back(m_Resource);
+            Output.m_Name           = Name;
+            Output.m_Callable       = Allocator.new_object<CallableType>(std::forward<Function>(Callable));
+
+            Output.m_Execute = [](void *const Data, VkCommandBuffer const &CommandBuffer, RenderGraph const &Graph)
+            {
+                (*static_cast<CallableType *>(Data))(CommandBuffer, Graph);
+            };
+
+            Output.m_Destroy = [](void *const Data, std::pmr::memory_resource *const Resource)
+            {
+                std::pmr::polymorphic_allocator<> { Resource }.delete_object(static_cast<CallableType *>(Data));
+            };
+
+            m_IsCompiled = false;
+            return Output;
+        }
+
+        void Compile();
+        void Execute(VkCommandBuffer const &);
+
+        // Destroys the containers, so a frame allocator can be reset right after
+        void Reset();
+
+        [[nodiscard]] ImageAllocation const &GetImage(RenderGraphResource) const;
+        [[nodiscard]] std::uint32_t          GetNumCulledPasses() const;
+
+    private:
+        RenderGraphData &GetData();
+    };
+
+    export void ReleaseRenderGraphResources();
+} // namespace RenderCore
@@ -12,6 +12,7 @@ import RenderCore.Types.Illumination;
 import RenderCore.Types.Allocation;
 import RenderCore.Types.Object;
 import RenderCore.Types.SurfaceProperties;
+import RenderCore.Types.UniformBufferObject;
 
 namespace RenderCore
 {
@@ -35,7 +36,7 @@ export namespace RenderCore
     void ReleaseSceneResources();
     void DestroyObjects();
     void TickObjects(float);
-    void UpdateSceneUniformBuffer();
+    void UpdateSceneUniformBuffer(SceneUniformData const &);
     void UpdateObjectsUniformBuffer();
 
     RENDERCOREMODULE_API [[nodiscard]] inline std::uint32_t FetchID()
@@ -17,6 +17,10 @@ namespace RenderCore
     };
 
     RENDERCOREMODULE_API std::vector<ShaderStageData> g_StageInfos;
+
+    // Kept apart from the default stages, as the main pipeline links every fragment stage it finds there
+    RENDERCOREMODULE_API std::vector<ShaderStageData> g_VisibilityStageInfos;
+    RENDERCOREMODULE_API std::vector<ShaderStageData> g_SkinningStageInfos;
 }
 
 export namespace RenderCore
@@ -42,9 +46,21 @@ export namespace RenderCore
         return g_StageInfos;
     }
 
+    RENDERCOREMODULE_API [[nodiscard]] inline std::vector<ShaderStageData> const &GetVisibilityStageData()
+    {
+        return g_VisibilityStageInfos;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline std::vector<ShaderStageData> const &GetSkinningStageData()
+    {
+        return g_SkinningStageInfos;
+    }
+
     inline void ReleaseShaderResources()
     {
         g_StageInfos.clear();
+        g_VisibilityStageInfos.clear();
+        g_SkinningStageInfos.clear();
     }
 
     void CompileDefaultShaders();
@@ -0,0 +1,60 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.Skinning;
+
+import RenderCore.Types.Allocation;
+import RenderCore.Types.Object;
+import RenderCore.Types.Skeleton;
+
+namespace RenderCore
+{
+    // Must match the define of the skinning shader
+    export constexpr std::uint32_t g_SkinningGroupSize { 64U };
+
+    // std430 element of the job buffer: one per skinned object, its vertices found by the invocations from the first one of the batch
+    export struct RENDERCOREMODULE_API GPUSkinningJob
+    {
+        std::uint32_t SourceOffset { 0U };
+        std::uint32_t OutputOffset { 0U };
+        std::uint32_t JointOffset { 0U };
+        std::uint32_t FirstVertex { 0U };
+    };
+
+    export struct RENDERCOREMODULE_API SkinningConstants
+    {
+        VkDeviceAddress SourceAddress { 0U };
+        VkDeviceAddress OutputAddress { 0U };
+        VkDeviceAddress JointsAddress { 0U };
+        VkDeviceAddress JobsAddress { 0U };
+        std::uint32_t   NumJobs { 0U };
+        std::uint32_t   NumVertices { 0U };
+    };
+
+    // The posed vertices of every skinned object, and one joint palette per frame in flight, written while the previous ones are in use
+    RENDERCOREMODULE_API BufferAllocation g_SkinnedVertexBuffer {};
+    RENDERCOREMODULE_API BufferAllocation g_JointMatrixBuffer {};
+    RENDERCOREMODULE_API BufferAllocation g_SkinningJobBuffer {};
+}
+
+export namespace RenderCore
+{
+    void UpdateSkinnedObjects(std::vector<std::shared_ptr<Object>> const &);
+    void ReleaseSkinningResources();
+
+    void CaptureJointMatrices(std::vector<glm::mat4> &);
+    void UpdateJointMatrices(std::span<glm::mat4 const>, std::uint32_t);
+    void RecordSkinning(VkCommandBuffer const &, std::uint32_t);
+
+    [[nodiscard]] bool IsSkinningActive();
+
+    [[nodiscard]] std::vector<std::shared_ptr<Skeleton>> const &GetSkinnedSkeletons();
+
+    RENDERCOREMODULE_API [[nodiscard]] inline BufferAllocation const &GetSkinnedVertexBuffer()
+    {
+        return g_SkinnedVertexBuffer;
+    }
+} // namespace RenderCore
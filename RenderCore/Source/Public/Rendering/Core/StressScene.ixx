@@ -0,0 +1,44 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.StressScene;
+
+import RenderCore.Types.Object;
+
+namespace RenderCore
+{
+    export struct RENDERCOREMODULE_API StressSceneSettings
+    {
+        std::uint32_t NumObjects { 1000U };
+        std::uint32_t NumMeshes { 16U };
+        std::uint32_t TrianglesPerMesh { 512U };
+        std::uint32_t NumMaterials { 8U };
+        std::uint32_t NumTextures { 4U };
+        std::uint32_t TextureSize { 256U };
+        std::uint32_t NumInstances { 1U };
+        float         MovingFraction { 0.1F };
+        float         SceneExtent { 250.F };
+        std::uint32_t NumPointLights { 0U };
+        std::uint32_t Seed { 1U };
+    };
+
+    export class RENDERCOREMODULE_API StressSceneObject : public Object
+    {
+        glm::vec3 m_Origin {};
+        float     m_OrbitRadius { 0.F };
+        float     m_OrbitSpeed { 0.F };
+        float     m_Phase { 0.F };
+        double    m_ElapsedTime { 0. };
+
+    public:
+        StressSceneObject() = delete;
+        StressSceneObject(std::uint32_t, strzilla::string_view, glm::vec3 const &, float, float, float);
+
+        void Tick(double) override;
+    };
+
+    export RENDERCOREMODULE_API void GenerateStressScene(StressSceneSettings const &);
+} // namespace RenderCore
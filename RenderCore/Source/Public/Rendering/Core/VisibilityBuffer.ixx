@@ -0,0 +1,48 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.VisibilityBuffer;
+
+import RenderCore.Types.Allocation;
+import RenderCore.Types.Object;
+
+namespace RenderCore
+{
+    // Object index (plus one, zero is the background) and primitive id of each pixel; must match the visibility shaders
+    export constexpr VkFormat      g_VisibilityFormat { VK_FORMAT_R32G32_UINT };
+    export constexpr VkFormat      g_VisibilityColorFormat { VK_FORMAT_R16G16B16A16_SFLOAT };
+    export constexpr std::uint32_t g_VisibilityResolveGroupSize { 8U };
+
+    // std430 element of the object buffer: byte offsets into the unified models buffer, or into the posed vertices when skinned
+    export struct RENDERCOREMODULE_API GPUVisibilityObject
+    {
+        std::uint32_t VertexOffset { 0U };
+        std::uint32_t IndexOffset { 0U };
+        std::uint32_t UniformOffset { 0U };
+        std::uint32_t IsSkinned { 0U };
+    };
+
+    export struct RENDERCOREMODULE_API VisibilityResolveConstants
+    {
+        VkDeviceAddress GeometryAddress { 0U };
+        VkDeviceAddress SkinnedAddress { 0U };
+        VkDeviceAddress ObjectsAddress { 0U };
+        glm::uvec2      Extent {};
+    };
+
+    RENDERCOREMODULE_API BufferAllocation g_VisibilityObjectBuffer {};
+}
+
+export namespace RenderCore
+{
+    void UpdateVisibilityObjects(std::vector<std::shared_ptr<Object>> const &);
+    void ReleaseVisibilityBufferResources();
+
+    void RecordVisibilityResolve(VkCommandBuffer const &, std::uint32_t, ImageAllocation const &, ImageAllocation const &, VkExtent2D const &);
+    void RecordVisibilityCopy(VkCommandBuffer const &, ImageAllocation const &, ImageAllocation const &, VkExtent2D const &);
+
+    [[nodiscard]] bool IsVisibilityBufferActive();
+} // namespace RenderCore
@@ -13,13 +13,14 @@ namespace RenderCore
 {
     export struct RENDERCOREMODULE_API MeshConstructionInputParameters
     {
-        std::uint32_t                                                      ID { 0U };
-        strzilla::string_view const &                                      Path {};
-        tinygltf::Model const &                                            Model {};
-        tinygltf::Node const &                                             Node {};
-        tinygltf::Mesh const &                                             Mesh {};
-        tinygltf::Primitive const &                                        Primitive {};
-        std::unordered_map<std::uint32_t, std::shared_ptr<Texture>> const &TextureMap {};
+        std::uint32_t                                                            ID { 0U };
+        strzilla::string_view const &                                            Path {};
+        tinygltf::Model const &                                                  Model {};
+        tinygltf::Node const &                                                   Node {};
+        tinygltf::Mesh const &                                                   Mesh {};
+        tinygltf::Primitive const &                                              Primitive {};
+        std::pmr::unordered_map<std::uint32_t, std::shared_ptr<Texture>> const &TextureMap {};
+        std::pmr::memory_resource *                                              TransientResource { std::pmr::get_default_resource() };
     };
 
     export RENDERCOREMODULE_API [[nodiscard]] std::shared_ptr<Mesh> ConstructMesh(MeshConstructionInputParameters const &);
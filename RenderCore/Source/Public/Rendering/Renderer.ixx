@@ -11,10 +11,21 @@ import RenderCore.Utils.EnumHelpers;
 import RenderCore.Types.Object;
 import RenderCore.Types.Texture;
 import RenderCore.Types.RendererStateFlags;
+import RenderCore.Runtime.Capture;
+import RenderCore.Runtime.StressScene;
 import RenderCore.Runtime.SwapChain;
+import RenderCore.Utils.APICalls;
+import RenderCore.Utils.FrameAllocator;
 
 namespace RenderCore
 {
+    export struct RENDERCOREMODULE_API StartupStepTiming
+    {
+        strzilla::string Name {};
+        double           StartOffset { 0. };
+        double           Duration { 0. };
+    };
+
     RENDERCOREMODULE_API auto                              g_StateFlags { RendererStateFlags::NONE };
     RENDERCOREMODULE_API auto                              g_ObjectsManagementStateFlags { RendererObjectsManagementStateFlags::NONE };
     RENDERCOREMODULE_API float                             g_FrameTime { 0.F };
@@ -22,6 +33,9 @@ namespace RenderCore
     RENDERCOREMODULE_API bool                              g_UseVSync { true };
     RENDERCOREMODULE_API bool                              g_RenderOffscreen { false };
     RENDERCOREMODULE_API bool                              g_UseDefaultSync { true };
+    RENDERCOREMODULE_API bool                              g_UseRenderThread { false };
+    RENDERCOREMODULE_API bool                              g_UseGPULightCulling { true };
+    RENDERCOREMODULE_API bool                              g_UseVisibilityBuffer { false };
     RENDERCOREMODULE_API std::uint32_t                     g_ImageIndex { g_ImageCount };
     RENDERCOREMODULE_API std::mutex                        g_RendererMutex {};
     RENDERCOREMODULE_API std::queue<std::function<void()>> g_MainThreadDispatchQueue {};
@@ -30,6 +44,13 @@ namespace RenderCore
     RENDERCOREMODULE_API std::vector<strzilla::string> g_ModelsToLoad {};
     RENDERCOREMODULE_API std::vector<std::uint32_t>    g_ModelsToUnload {};
 
+    RENDERCOREMODULE_API std::vector<StressSceneSettings> g_StressScenesToGenerate {};
+
+    RENDERCOREMODULE_API std::vector<StartupStepTiming>        g_StartupTimings {};
+    RENDERCOREMODULE_API std::mutex                            g_StartupTimingsMutex {};
+    RENDERCOREMODULE_API std::chrono::steady_clock::time_point g_StartupTimePoint {};
+    RENDERCOREMODULE_API double                                g_TimeToFirstFrame { 0. };
+
     std::function<void()> g_OnInitializeCallback {};
     std::function<void()> g_OnRefreshCallback {};
     std::function<void()> g_OnDrawCallback {};
@@ -72,14 +93,30 @@ namespace RenderCore
         RENDERCOREMODULE_API void SetVSync(bool);
         RENDERCOREMODULE_API void SetRenderOffscreen(bool);
         RENDERCOREMODULE_API void SetUseDefaultSync(bool);
+        RENDERCOREMODULE_API void SetUseRenderThread(bool);
+        RENDERCOREMODULE_API void SetUseGPULightCulling(bool);
+        RENDERCOREMODULE_API void SetUseVisibilityBuffer(bool);
+        RENDERCOREMODULE_API void SetDynamicResolution(bool);
+        RENDERCOREMODULE_API void SetDynamicResolutionTargetGPUTime(float);
 
         RENDERCOREMODULE_API [[nodiscard]] std::shared_ptr<Object> GetObjectByID(std::uint32_t);
 
         RENDERCOREMODULE_API [[nodiscard]] std::vector<VkImageView> GetOffscreenImages();
         RENDERCOREMODULE_API void                                   SaveOffscreenFrameToImage(strzilla::string_view);
+        RENDERCOREMODULE_API void                                   SaveTiledCaptureToImage(strzilla::string_view, VkExtent2D const &, std::uint32_t = 2048U);
+        RENDERCOREMODULE_API bool                                   RenderBatch(BatchRenderRequest const &);
 
         RENDERCOREMODULE_API [[nodiscard]] std::vector<std::shared_ptr<Texture>> LoadImages(std::vector<strzilla::string_view> &&);
 
+        RENDERCOREMODULE_API [[nodiscard]] std::vector<StartupStepTiming> GetStartupTimings();
+        RENDERCOREMODULE_API [[nodiscard]] std::vector<APICallStats>      GetAPICallStats();
+        RENDERCOREMODULE_API [[nodiscard]] FrameAllocationStats           GetFrameAllocationStats();
+
+        RENDERCOREMODULE_API [[nodiscard]] inline double GetTimeToFirstFrame()
+        {
+            return g_TimeToFirstFrame;
+        }
+
         RENDERCOREMODULE_API [[nodiscard]] inline std::mutex &GetMutex()
         {
             return g_RendererMutex;
@@ -136,6 +173,12 @@ namespace RenderCore
             AddFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_LOAD);
         }
 
+        RENDERCOREMODULE_API inline void RequestGenerateStressScene(StressSceneSettings const &Settings)
+        {
+            g_StressScenesToGenerate.push_back(Settings);
+            AddFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_LOAD);
+        }
+
         RENDERCOREMODULE_API inline void RequestUnloadObjects(std::vector<std::uint32_t> const &ObjectIDs)
         {
             g_ModelsToUnload.insert(std::end(g_ModelsToUnload), std::begin(ObjectIDs), std::end(ObjectIDs));
@@ -185,6 +228,21 @@ namespace RenderCore
             return g_UseDefaultSync;
         }
 
+        RENDERCOREMODULE_API [[nodiscard]] inline bool const &GetUseRenderThread()
+        {
+            return g_UseRenderThread;
+        }
+
+        RENDERCOREMODULE_API [[nodiscard]] inline bool const &GetUseGPULightCulling()
+        {
+            return g_UseGPULightCulling;
+        }
+
+        RENDERCOREMODULE_API [[nodiscard]] inline bool const &GetUseVisibilityBuffer()
+        {
+            return g_UseVisibilityBuffer;
+        }
+
         RENDERCOREMODULE_API [[nodiscard]] inline std::uint32_t const &GetImageIndex()
         {
             return g_ImageIndex;
@@ -0,0 +1,55 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Types.Animation;
+
+namespace RenderCore
+{
+    export enum class AnimationPath : std::uint8_t { TRANSLATION, ROTATION, SCALE };
+
+    export enum class AnimationInterpolation : std::uint8_t { STEP, LINEAR, CUBIC_SPLINE };
+
+    // Node property written from the lanes [FirstLane, FirstLane + 3 or 4) of a sampled keyframe
+    export struct RENDERCOREMODULE_API AnimationTarget
+    {
+        std::uint32_t Node { 0U };
+        std::uint32_t FirstLane { 0U };
+        AnimationPath Path { AnimationPath::TRANSLATION };
+    };
+
+    // Channels of a clip that share their input times and interpolation: a keyframe is a row with one lane per component of every target,
+    // so a track is sampled with a single key search and the rows are blended lane by lane
+    export struct RENDERCOREMODULE_API AnimationTrack
+    {
+        AnimationInterpolation       Interpolation { AnimationInterpolation::LINEAR };
+        std::uint32_t                NumLanes { 0U };
+        std::vector<float>           Times {};
+        std::vector<float>           Values {};
+        std::vector<float>           InTangents {};
+        std::vector<float>           OutTangents {};
+        std::vector<AnimationTarget> Targets {};
+
+        void Sample(float, std::span<float>) const;
+    };
+
+    export struct RENDERCOREMODULE_API AnimationClip
+    {
+        strzilla::string            Name {};
+        float                       Duration { 0.F };
+        std::uint32_t               MaxLanes { 0U };
+        std::vector<AnimationTrack> Tracks {};
+    };
+
+    // Playback of a clip by a skeleton; the skeleton owns it, so every loaded model animates on its own
+    export struct RENDERCOREMODULE_API AnimationState
+    {
+        std::int32_t ClipIndex { -1 };
+        float        Time { 0.F };
+        float        Speed { 1.F };
+        bool         IsPaused { false };
+        bool         IsLooping { true };
+    };
+} // namespace RenderCore
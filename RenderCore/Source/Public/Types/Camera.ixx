@@ -31,7 +31,7 @@ namespace RenderCore
         float                    m_FieldOfView { 45.F };
         float                    m_NearPlane { 0.001F };
         float                    m_FarPlane { 1000.F };
-        float                    m_CurrentAspectRatio { 1.F };
+        mutable float            m_CurrentAspectRatio { 1.F };
         float                    m_DrawDistance { 500.F };
         glm::vec3                m_Position { 0.F, 0.F, 1.F };
         glm::vec3                m_Rotation { -90.F, 0.F, 0.F };
@@ -149,6 +149,7 @@ namespace RenderCore
 
         [[nodiscard]] glm::mat4 GetViewMatrix() const;
         [[nodiscard]] glm::mat4 GetProjectionMatrix() const;
+        [[nodiscard]] glm::mat4 GetProjectionMatrix(float) const;
 
 
         [[nodiscard]] inline CameraMovementStateFlags GetCameraMovementStateFlags() const
@@ -168,6 +169,7 @@ namespace RenderCore
         [[nodiscard]] static bool BoxIntersectsPlane(Bounds const &, glm::vec4 const &);
         [[nodiscard]] bool        IsInAllowedDistance(std::shared_ptr<Object> const &) const;
         [[nodiscard]] bool        CanDrawObject(std::shared_ptr<Object> const &) const;
+        [[nodiscard]] bool        CanDrawObject(std::shared_ptr<Object> const &, std::array<glm::vec4, 6U> const &) const;
 
         [[nodiscard]] inline bool IsRenderDirty() const
         {
@@ -10,6 +10,16 @@ import RenderCore.Types.Allocation;
 
 namespace RenderCore
 {
+    export struct RENDERCOREMODULE_API PointLight
+    {
+        glm::vec3 Position {};
+        float     Radius { 10.F };
+        glm::vec3 Color { 1.F, 1.F, 1.F };
+        float     Intensity { 1.F };
+
+        [[nodiscard]] bool operator==(PointLight const &) const = default;
+    };
+
     export class RENDERCOREMODULE_API Illumination
     {
         mutable bool                                        m_IsRenderDirty { true };
@@ -18,6 +28,7 @@ namespace RenderCore
         glm::vec3                                           m_Position { 100.F, 100.F, 100.F };
         glm::vec3                                           m_Color { 1.F, 1.F, 1.F };
         std::pair<BufferAllocation, VkDescriptorBufferInfo> m_UniformBufferAllocation {};
+        std::vector<PointLight>                             m_PointLights {};
 
     public:
         Illumination() = default;
@@ -78,6 +89,45 @@ namespace RenderCore
             return m_Ambient;
         }
 
+        // Point lights are shaded through the clustered light lists, in addition to the main light
+        inline std::uint32_t AddPointLight(PointLight const &Value)
+        {
+            m_PointLights.push_back(Value);
+            m_IsRenderDirty = true;
+
+            return static_cast<std::uint32_t>(std::size(m_PointLights) - 1U);
+        }
+
+        inline void SetPointLight(std::uint32_t const Index, PointLight const &Value)
+        {
+            if (PointLight &Light = m_PointLights.at(Index);
+                Light != Value)
+            {
+                Light           = Value;
+                m_IsRenderDirty = true;
+            }
+        }
+
+        inline void RemovePointLight(std::uint32_t const Index)
+        {
+            m_PointLights.erase(std::begin(m_PointLights) + Index);
+            m_IsRenderDirty = true;
+        }
+
+        inline void ClearPointLights()
+        {
+            if (!std::empty(m_PointLights))
+            {
+                m_PointLights.clear();
+                m_IsRenderDirty = true;
+            }
+        }
+
+        [[nodiscard]] inline std::vector<PointLight> const &GetPointLights() const
+        {
+            return m_PointLights;
+        }
+
         [[nodiscard]] inline bool IsRenderDirty() const
         {
             return m_IsRenderDirty;
@@ -33,9 +33,9 @@ namespace RenderCore
         Mesh()           = delete;
 
         Mesh(std::uint32_t, strzilla::string_view);
-        Mesh(std::uint32_t, strzilla::string_view, strzilla::string_view);
+        Mesh(std::uint32_t, strzilla::string_view, strzilla::string_view, std::uint32_t = g_NoNameSuffix);
 
-        void Optimize();
+        void Optimize(std::pmr::memory_resource * = std::pmr::get_default_resource());
         void SetupBounds();
 
         [[nodiscard]] inline Transform const &GetTransform() const
@@ -73,6 +73,11 @@ namespace RenderCore
             m_Vertices = Vertices;
         }
 
+        inline void SetVertices(std::vector<Vertex> &&Vertices)
+        {
+            m_Vertices = std::move(Vertices);
+        }
+
         [[nodiscard]] inline std::vector<std::uint32_t> const &GetIndices() const
         {
             return m_Indices;
@@ -84,6 +89,12 @@ namespace RenderCore
             m_NumTriangles = static_cast<std::uint32_t>(std::size(m_Indices) / 3U);
         }
 
+        inline void SetIndices(std::vector<std::uint32_t> &&Indices)
+        {
+            m_Indices      = std::move(Indices);
+            m_NumTriangles = static_cast<std::uint32_t>(std::size(m_Indices) / 3U);
+        }
+
         [[nodiscard]] inline std::uint32_t GetNumTriangles() const
         {
             return m_NumTriangles;
@@ -145,5 +156,6 @@ namespace RenderCore
         }
 
         void BindBuffers(VkCommandBuffer const &, std::uint32_t) const;
+        void BindBuffers(VkCommandBuffer const &, std::uint32_t, VkBuffer const &, VkDeviceSize) const;
     };
 } // namespace RenderCore
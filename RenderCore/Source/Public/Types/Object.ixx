@@ -8,7 +8,9 @@ export module RenderCore.Types.Object;
 
 import RenderCore.Types.Mesh;
 import RenderCore.Types.Resource;
+import RenderCore.Types.Skeleton;
 import RenderCore.Types.Transform;
+import RenderCore.Types.UniformBufferObject;
 
 namespace RenderCore
 {
@@ -22,13 +24,17 @@ namespace RenderCore
         VkDescriptorBufferInfo m_UniformBufferInfo {};
         void *                 m_MappedData { nullptr };
 
+        std::shared_ptr<Skeleton> m_Skeleton { nullptr };
+        std::uint32_t             m_SkinIndex { 0U };
+        VkDeviceSize              m_SkinnedVertexOffset { 0U };
+
     public:
         Object()           = delete;
         ~Object() override = default;
 
         inline bool operator==(Object const &Rhs) const
         {
-            return GetID() == Rhs.GetID() && GetName() == Rhs.GetName() && GetPath() == Rhs.GetPath();
+            return GetID() == Rhs.GetID() && GetNameHandle() == Rhs.GetNameHandle() && GetPathHandle() == Rhs.GetPathHandle();
         }
 
         Object(std::uint32_t, strzilla::string_view);
@@ -150,6 +156,37 @@ namespace RenderCore
             m_Mesh = Value;
         }
 
+        [[nodiscard]] inline bool IsSkinned() const
+        {
+            return m_Skeleton != nullptr;
+        }
+
+        [[nodiscard]] inline std::shared_ptr<Skeleton> const &GetSkeleton() const
+        {
+            return m_Skeleton;
+        }
+
+        [[nodiscard]] inline std::uint32_t GetSkinIndex() const
+        {
+            return m_SkinIndex;
+        }
+
+        inline void SetSkin(std::shared_ptr<Skeleton> const &Value, std::uint32_t const SkinIndex)
+        {
+            m_Skeleton  = Value;
+            m_SkinIndex = SkinIndex;
+        }
+
+        [[nodiscard]] inline VkDeviceSize GetSkinnedVertexOffset() const
+        {
+            return m_SkinnedVertexOffset;
+        }
+
+        inline void SetSkinnedVertexOffset(VkDeviceSize const &Offset)
+        {
+            m_SkinnedVertexOffset = Offset;
+        }
+
         [[nodiscard]] inline bool IsRenderDirty() const
         {
             return m_IsRenderDirty;
@@ -160,14 +197,22 @@ namespace RenderCore
             m_IsRenderDirty = true;
         }
 
+        inline void SetRenderDirty(bool const Value) const
+        {
+            m_IsRenderDirty = Value;
+        }
+
         void Destroy() override;
 
         virtual void Tick(double)
         {
         }
 
-        void SetupUniformDescriptor();
-        void UpdateUniformBuffers() const;
+        void                           SetupUniformDescriptor();
+        [[nodiscard]] ModelUniformData GetUniformData(Transform const &) const;
+        void                           UpdateUniformBuffers() const;
+        void                           UpdateUniformBuffers(ModelUniformData const &) const;
         void DrawObject(VkCommandBuffer const &, VkPipelineLayout const &, std::uint32_t) const;
+        void DrawObject(VkCommandBuffer const &, VkPipelineLayout const &, std::uint32_t, std::uint32_t) const;
     };
 } // namespace RenderCore
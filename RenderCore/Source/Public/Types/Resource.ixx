@@ -6,22 +6,28 @@ module;
 
 export module RenderCore.Types.Resource;
 
+import RenderCore.Utils.StringTable;
+
 namespace RenderCore
 {
+    export constexpr std::uint32_t g_NoNameSuffix { std::numeric_limits<std::uint32_t>::max() };
+
     export class RENDERCOREMODULE_API Resource
     {
-        bool             m_IsPendingDestroy { false };
-        std::uint32_t    m_ID {};
-        strzilla::string m_Path {};
-        strzilla::string m_Name {};
-        std::uint32_t    m_BufferIndex { 0U };
+        bool          m_IsPendingDestroy { false };
+        std::uint32_t m_ID {};
+        StringHandle  m_Path { g_EmptyStringHandle };
+        StringHandle  m_Name { g_EmptyStringHandle };
+        std::uint32_t m_NameSuffix { g_NoNameSuffix };
+        std::uint32_t m_BufferIndex { 0U };
 
     public:
         virtual ~Resource() = default;
         Resource()          = delete;
 
         Resource(std::uint32_t, strzilla::string_view);
-        Resource(std::uint32_t, strzilla::string_view, strzilla::string_view);
+        // The suffix makes the name unique without interning it: only the shared part of the name goes into the string table
+        Resource(std::uint32_t, strzilla::string_view, strzilla::string_view, std::uint32_t = g_NoNameSuffix);
 
         [[nodiscard]] inline std::uint32_t GetID() const
         {
@@ -29,11 +35,18 @@ namespace RenderCore
         }
 
         [[nodiscard]] inline strzilla::string const &GetPath() const
+        {
+            return GetInternedString(m_Path);
+        }
+
+        [[nodiscard]] inline StringHandle GetPathHandle() const
         {
             return m_Path;
         }
 
-        [[nodiscard]] inline strzilla::string const &GetName() const
+        [[nodiscard]] strzilla::string GetName() const;
+
+        [[nodiscard]] inline StringHandle GetNameHandle() const
         {
             return m_Name;
         }
@@ -58,4 +71,14 @@ namespace RenderCore
             m_IsPendingDestroy = true;
         }
     };
+
+    // Objects and meshes share a pool instead of a heap allocation each, as a large model creates thousands of them at once
+    export RENDERCOREMODULE_API [[nodiscard]] std::pmr::memory_resource *GetResourcePool();
+
+    export template <typename ResourceType, typename... ArgumentTypes>
+    [[nodiscard]] std::shared_ptr<ResourceType> MakePooledResource(ArgumentTypes &&... Arguments)
+    {
+        return std::allocate_shared<ResourceType>(std::pmr::polymorphic_allocator<ResourceType> { GetResourcePool() },
+                                                  std::forward<ArgumentTypes>(Arguments)...);
+    }
 } // namespace RenderCore
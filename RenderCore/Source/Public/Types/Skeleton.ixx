@@ -0,0 +1,150 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Types.Skeleton;
+
+import RenderCore.Types.Animation;
+
+namespace RenderCore
+{
+    // Joints of a glTF skin, as node indices of the owning skeleton
+    export struct RENDERCOREMODULE_API SkinData
+    {
+        std::vector<std::uint32_t> JointNodes {};
+        std::vector<glm::mat4>     InverseBindMatrices {};
+    };
+
+    // Node hierarchy of a loaded model, indexed as the glTF nodes; the local transforms are kept per component to be animated
+    export class RENDERCOREMODULE_API Skeleton
+    {
+        std::vector<std::int32_t>  m_Parents {};
+        std::vector<std::uint32_t> m_UpdateOrder {};
+        std::vector<glm::vec3>     m_Translations {};
+        std::vector<glm::quat>     m_Rotations {};
+        std::vector<glm::vec3>     m_Scales {};
+        std::vector<glm::mat4>     m_GlobalMatrices {};
+        std::vector<SkinData>      m_Skins {};
+        std::vector<AnimationClip> m_Animations {};
+        std::vector<float>         m_SampledLanes {};
+        AnimationState             m_AnimationState {};
+        bool                       m_IsDirty { true };
+        bool                       m_IsVisible { true };
+
+    public:
+        Skeleton() = default;
+
+        void SetNodes(std::vector<std::int32_t> const &, std::vector<glm::vec3> const &, std::vector<glm::quat> const &, std::vector<glm::vec3> const &);
+
+        [[nodiscard]] inline std::uint32_t GetNumNodes() const
+        {
+            return static_cast<std::uint32_t>(std::size(m_Parents));
+        }
+
+        [[nodiscard]] inline std::int32_t GetNodeParent(std::uint32_t const Node) const
+        {
+            return m_Parents.at(Node);
+        }
+
+        [[nodiscard]] inline glm::vec3 const &GetNodeTranslation(std::uint32_t const Node) const
+        {
+            return m_Translations.at(Node);
+        }
+
+        inline void SetNodeTranslation(std::uint32_t const Node, glm::vec3 const &Value)
+        {
+            m_Translations.at(Node) = Value;
+            m_IsDirty               = true;
+        }
+
+        [[nodiscard]] inline glm::quat const &GetNodeRotation(std::uint32_t const Node) const
+        {
+            return m_Rotations.at(Node);
+        }
+
+        inline void SetNodeRotation(std::uint32_t const Node, glm::quat const &Value)
+        {
+            m_Rotations.at(Node) = Value;
+            m_IsDirty            = true;
+        }
+
+        [[nodiscard]] inline glm::vec3 const &GetNodeScale(std::uint32_t const Node) const
+        {
+            return m_Scales.at(Node);
+        }
+
+        inline void SetNodeScale(std::uint32_t const Node, glm::vec3 const &Value)
+        {
+            m_Scales.at(Node) = Value;
+            m_IsDirty         = true;
+        }
+
+        [[nodiscard]] inline glm::mat4 const &GetGlobalMatrix(std::uint32_t const Node) const
+        {
+            return m_GlobalMatrices.at(Node);
+        }
+
+        [[nodiscard]] inline std::vector<SkinData> const &GetSkins() const
+        {
+            return m_Skins;
+        }
+
+        inline std::uint32_t AddSkin(SkinData &&Skin)
+        {
+            m_Skins.push_back(std::move(Skin));
+            return static_cast<std::uint32_t>(std::size(m_Skins) - 1U);
+        }
+
+        [[nodiscard]] inline bool IsDirty() const
+        {
+            return m_IsDirty;
+        }
+
+        inline void MarkAsDirty()
+        {
+            m_IsDirty = true;
+        }
+
+        void SetAnimations(std::vector<AnimationClip> &&);
+
+        [[nodiscard]] inline std::vector<AnimationClip> const &GetAnimations() const
+        {
+            return m_Animations;
+        }
+
+        [[nodiscard]] inline AnimationState const &GetAnimationState() const
+        {
+            return m_AnimationState;
+        }
+
+        void PlayAnimation(std::uint32_t, bool = true);
+
+        inline void SetAnimationPaused(bool const Value)
+        {
+            m_AnimationState.IsPaused = Value;
+        }
+
+        inline void SetAnimationSpeed(float const Value)
+        {
+            m_AnimationState.Speed = Value;
+        }
+
+        [[nodiscard]] inline bool IsAnimating() const
+        {
+            return m_AnimationState.ClipIndex >= 0 && !m_AnimationState.IsPaused;
+        }
+
+        // Set by the frame state capture for each skinned object in view, and consumed by the next evaluation
+        inline void MarkAsVisible()
+        {
+            m_IsVisible = true;
+        }
+
+        void Animate(float);
+
+        bool UpdateGlobalMatrices();
+        void GetJointMatrices(std::uint32_t, std::span<glm::mat4>) const;
+    };
+} // namespace RenderCore
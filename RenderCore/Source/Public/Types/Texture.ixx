@@ -31,7 +31,7 @@ export namespace RenderCore
          Texture()          = delete;
 
         Texture(std::uint32_t, strzilla::string_view);
-        Texture(std::uint32_t, strzilla::string_view, strzilla::string_view);
+        Texture(std::uint32_t, strzilla::string_view, strzilla::string_view, std::uint32_t = g_NoNameSuffix);
 
         [[nodiscard]] inline std::vector<TextureType> const &GetTypes() const
         {
@@ -10,10 +10,13 @@ namespace RenderCore
 {
     export struct RENDERCOREMODULE_API SceneUniformData
     {
-        alignas(16) glm::mat4 ProjectionView {};
-        alignas(16) glm::vec3 LightPosition {};
-        alignas(16) glm::vec3 LightColor {};
-        alignas(8) double     AmbientLight {};
+        alignas(16) glm::mat4  ProjectionView {};
+        alignas(16) glm::vec3  LightPosition {};
+        alignas(16) glm::vec3  LightColor {};
+        alignas(4) float       AmbientLight {};
+        alignas(16) glm::mat4  View {};
+        alignas(16) glm::vec4  ClusterProjection {};
+        alignas(16) glm::uvec4 ClusterGrid {};
     };
 
     export struct RENDERCOREMODULE_API ModelUniformData
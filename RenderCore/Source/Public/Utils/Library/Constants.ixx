@@ -45,7 +45,7 @@ export namespace RenderCore
     constexpr auto g_ModelMemoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
     constexpr auto g_ModelBufferUsage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
-                                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+                                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
     constexpr auto g_TextureMemoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
@@ -65,6 +65,9 @@ export namespace RenderCore
 
     constexpr std::uint8_t g_ImageCount = 3U;
 
+    // Texture maps the visibility resolve can index, five per object
+    constexpr std::uint32_t g_MaxVisibilityMaterialMaps = 16384U;
+
     constexpr std::uint32_t g_Timeout = std::numeric_limits<std::uint32_t>::max();
 
     constexpr std::array g_ClearValues{VkClearValue{.color = {{0.F, 0.F, 0.F, 0.F}}}, VkClearValue{.depthStencil = {1.F, 0U}}};
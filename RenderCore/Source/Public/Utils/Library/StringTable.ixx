@@ -0,0 +1,24 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.StringTable;
+
+namespace RenderCore
+{
+    // Index of an interned string: equal strings share a handle, so they're compared and hashed as integers
+    export using StringHandle = std::uint32_t;
+
+    export constexpr StringHandle g_EmptyStringHandle { 0U };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    // Interned strings are never released, as the handles are held by resources of any thread: only strings shared by many resources belong here,
+    // not the ones made unique by an ID. Resolving a handle doesn't lock
+    RENDERCOREMODULE_API [[nodiscard]] StringHandle            InternString(strzilla::string_view);
+    RENDERCOREMODULE_API [[nodiscard]] strzilla::string const &GetInternedString(StringHandle);
+    RENDERCOREMODULE_API [[nodiscard]] std::uint32_t           GetNumInternedStrings();
+} // namespace RenderCore
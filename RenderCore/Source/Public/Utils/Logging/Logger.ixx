@@ -0,0 +1,82 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.Logger;
+
+namespace RenderCore
+{
+    constexpr std::size_t g_LogPayloadSize { 192U };
+
+    using LogRecordFormatter = void(*)(std::string_view, std::byte const *, std::string &);
+
+    // Fixed-size ring slot: either a copy of the arguments to be formatted by the logger thread or the already formatted text
+    struct LogRecord
+    {
+        std::atomic<std::uint64_t>          Sequence { 0U };
+        boost::log::trivial::severity_level Level { boost::log::trivial::info };
+        char const *                        Function { nullptr };
+        std::string_view                    Format {};
+        LogRecordFormatter                  Formatter { nullptr };
+        std::unique_ptr<std::string>        Overflow { nullptr };
+        std::uint32_t                       Length { 0U };
+        alignas(std::max_align_t) std::byte Payload[g_LogPayloadSize] {};
+    };
+
+    template <typename Type>
+    concept DeferredLogArgument = std::is_arithmetic_v<Type>;
+
+    template <typename... Arguments>
+    void FormatDeferredLogRecord(std::string_view const Format, std::byte const *const Payload, std::string &Output)
+    {
+        auto const &Values = *std::launder(reinterpret_cast<std::tuple<Arguments...> const *>(Payload));
+
+        std::apply([&](auto const &... Unpacked)
+                   {
+                       std::vformat_to(std::back_inserter(Output), Format, std::make_format_args(Unpacked...));
+                   },
+                   Values);
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] LogRecord *AcquireLogRecord();
+    RENDERCOREMODULE_API void                     CommitLogRecord(LogRecord &);
+    RENDERCOREMODULE_API void                     FormatLogMessage(boost::log::trivial::severity_level, char const *, std::string_view, std::format_args);
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    RENDERCOREMODULE_API void InitializeLogger();
+    RENDERCOREMODULE_API void FlushLogger();
+    RENDERCOREMODULE_API void ShutdownLogger();
+
+    RENDERCOREMODULE_API void SinkLogMessage(boost::log::trivial::severity_level, char const *, std::string_view);
+
+    template <boost::log::trivial::severity_level Level, typename... Arguments>
+    void PushLogRecord(char const *const Function, std::format_string<Arguments...> const Format, Arguments &&... Values)
+    {
+        if constexpr (Level >= RENDERCORE_MIN_LOG_LEVEL)
+        {
+            using StoredArguments = std::tuple<std::decay_t<Arguments>...>;
+
+            // Only plain values are deferred: anything that may reference caller memory is formatted before returning
+            if constexpr ((DeferredLogArgument<std::decay_t<Arguments>> && ...) && sizeof(StoredArguments) <= g_LogPayloadSize)
+            {
+                if (LogRecord *const Record = AcquireLogRecord())
+                {
+                    Record->Level     = Level;
+                    Record->Function  = Function;
+                    Record->Format    = Format.get();
+                    Record->Formatter = &FormatDeferredLogRecord<std::decay_t<Arguments>...>;
+                    new(Record->Payload) StoredArguments { Values... };
+
+                    CommitLogRecord(*Record);
+                    return;
+                }
+            }
+
+            FormatLogMessage(Level, Function, Format.get(), std::make_format_args(Values...));
+        }
+    }
+} // namespace RenderCore
@@ -0,0 +1,48 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.AllocationCallbacks;
+
+namespace RenderCore
+{
+    export enum class HostAllocationTag : std::uint8_t
+    {
+        Instance,
+        Device,
+        Memory,
+        Pipeline,
+        SwapChain,
+        Descriptors,
+        Commands,
+        Synchronization,
+
+        Count
+    };
+
+    export constexpr std::uint8_t g_NumSystemAllocationScopes { VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1U };
+
+    export struct RENDERCOREMODULE_API HostAllocationStats
+    {
+        std::uint64_t                                          NumAllocations { 0U };
+        std::uint64_t                                          NumReallocations { 0U };
+        std::uint64_t                                          NumFrees { 0U };
+        std::uint64_t                                          CurrentBytes { 0U };
+        std::uint64_t                                          PeakBytes { 0U };
+        std::uint64_t                                          TotalBytes { 0U };
+        std::uint64_t                                          InternalBytes { 0U };
+        std::array<std::uint64_t, g_NumSystemAllocationScopes> ScopeCurrentBytes {};
+        std::array<std::uint64_t, g_NumSystemAllocationScopes> ScopePeakBytes {};
+    };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    RENDERCOREMODULE_API [[nodiscard]] VkAllocationCallbacks const *GetAllocationCallbacks(HostAllocationTag);
+    RENDERCOREMODULE_API [[nodiscard]] HostAllocationStats          GetHostAllocationStats(HostAllocationTag);
+    RENDERCOREMODULE_API [[nodiscard]] strzilla::string_view        GetHostAllocationTagName(HostAllocationTag);
+
+    RENDERCOREMODULE_API void PrintHostAllocationReport();
+} // namespace RenderCore
@@ -0,0 +1,65 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.FrameAllocator;
+
+namespace RenderCore
+{
+    export constexpr std::size_t g_DefaultFrameArenaSize { 256U * 1024U };
+
+    // Counters of the last frame recorded with an allocator, taken when its slot is reset; the heap allocations are its own fallbacks only
+    export struct RENDERCOREMODULE_API FrameAllocationStats
+    {
+        std::uint64_t NumAllocations { 0U };
+        std::uint64_t NumHeapAllocations { 0U };
+        std::uint64_t UsedBytes { 0U };
+        std::uint64_t Capacity { 0U };
+        std::uint64_t TotalHeapAllocations { 0U };
+    };
+
+    // Linear memory of a frame slot, released at once when the fence of the slot signals: threads only bump an atomic offset, and deallocation is a no-op.
+    // Requests that don't fit are served by the heap and counted, then the buffer grows on the next reset, so a steady state frame doesn't fall back to it
+    export class RENDERCOREMODULE_API FrameAllocator final : public std::pmr::memory_resource
+    {
+        struct HeapBlock
+        {
+            void *      Data { nullptr };
+            std::size_t Size { 0U };
+            std::size_t Alignment { 0U };
+        };
+
+        std::unique_ptr<std::byte[]> m_Buffer {};
+        std::size_t                  m_Capacity { 0U };
+        std::atomic<std::size_t>     m_Offset { 0U };
+        std::atomic<std::size_t>     m_HeapBytes { 0U };
+        std::atomic<std::uint64_t>   m_NumAllocations { 0U };
+        std::vector<HeapBlock>       m_HeapBlocks {};
+        FrameAllocationStats         m_LastFrameStats {};
+        mutable std::mutex           m_Mutex {};
+
+    public:
+        FrameAllocator()                       = delete;
+        FrameAllocator(FrameAllocator const &) = delete;
+
+        FrameAllocator &operator=(FrameAllocator const &) = delete;
+
+        explicit FrameAllocator(std::size_t = g_DefaultFrameArenaSize);
+        ~FrameAllocator() override;
+
+        // Everything allocated since the last reset must be unused by then: the recording of the slot finished and its fence signaled
+        void Reset();
+
+        [[nodiscard]] FrameAllocationStats GetStats() const;
+
+    private:
+        void *do_allocate(std::size_t, std::size_t) override;
+        void  do_deallocate(void *, std::size_t, std::size_t) override;
+
+        [[nodiscard]] bool do_is_equal(std::pmr::memory_resource const &) const noexcept override;
+
+        void ReleaseHeapBlocks();
+    };
+} // namespace RenderCore
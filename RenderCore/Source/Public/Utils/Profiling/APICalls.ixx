@@ -0,0 +1,32 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.APICalls;
+
+namespace RenderCore
+{
+    export struct RENDERCOREMODULE_API APICallStats
+    {
+        strzilla::string_view Name {};
+        bool                  IsTimed { false };
+        std::uint64_t         FrameCalls { 0U };
+        double                FrameTime { 0. };
+        std::uint64_t         TotalCalls { 0U };
+        double                TotalTime { 0. };
+    };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    RENDERCOREMODULE_API void InstallAPICallHooks();
+    RENDERCOREMODULE_API void AdvanceAPICallFrame();
+    RENDERCOREMODULE_API void ResetAPICallStats();
+
+    RENDERCOREMODULE_API [[nodiscard]] bool                      IsTrackingAPICalls();
+    RENDERCOREMODULE_API [[nodiscard]] std::vector<APICallStats> GetAPICallStats();
+
+    RENDERCOREMODULE_API void PrintAPICallReport();
+} // namespace RenderCore
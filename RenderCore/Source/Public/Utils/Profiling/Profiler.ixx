@@ -0,0 +1,59 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.Profiler;
+
+namespace RenderCore
+{
+    RENDERCOREMODULE_API std::atomic<bool> g_ProfilerCapturing { false };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    RENDERCOREMODULE_API [[nodiscard]] std::int64_t GetProfilerTimestamp();
+
+    RENDERCOREMODULE_API void SetProfilerThreadName(strzilla::string_view);
+    RENDERCOREMODULE_API void RecordProfilerZone(char const *, std::int64_t, std::int64_t);
+    RENDERCOREMODULE_API void RecordGPUProfilerZone(char const *, std::int64_t, std::int64_t, std::int64_t);
+
+    RENDERCOREMODULE_API void BeginProfilerCapture();
+    RENDERCOREMODULE_API void EndProfilerCapture();
+    RENDERCOREMODULE_API bool ExportProfilerTrace(strzilla::string_view);
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool IsProfilerCapturing()
+    {
+        return g_ProfilerCapturing.load(std::memory_order_relaxed);
+    }
+
+    class RENDERCOREMODULE_API ProfilerZone
+    {
+        char const * m_Name { nullptr };
+        std::int64_t m_Begin { -1 };
+
+    public:
+        ProfilerZone()                     = delete;
+        ProfilerZone(ProfilerZone const &) = delete;
+
+        ProfilerZone &operator=(ProfilerZone const &) = delete;
+
+        explicit ProfilerZone(char const *const Name)
+            : m_Name(Name)
+        {
+            if (IsProfilerCapturing())
+            {
+                m_Begin = GetProfilerTimestamp();
+            }
+        }
+
+        ~ProfilerZone()
+        {
+            if (m_Begin >= 0)
+            {
+                RecordProfilerZone(m_Name, m_Begin, GetProfilerTimestamp());
+            }
+        }
+    };
+} // namespace RenderCore
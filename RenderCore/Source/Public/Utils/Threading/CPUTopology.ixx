@@ -0,0 +1,57 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.CPUTopology;
+
+namespace RenderCore
+{
+    export enum class WorkerClass : std::uint8_t
+    {
+        Recording,
+        IO
+    };
+
+    // A physical core: the mask holds every logical processor (SMT sibling) of it, inside its processor group
+    export struct RENDERCOREMODULE_API CPUCore
+    {
+        std::uint16_t Group { 0U };
+        std::uint64_t Mask { 0U };
+        std::uint8_t  EfficiencyClass { 0U };
+        std::uint8_t  NumLogicalProcessors { 1U };
+    };
+
+    export struct RENDERCOREMODULE_API CPUTopology
+    {
+        std::vector<CPUCore> Cores {};
+        std::uint32_t        NumLogicalProcessors { 0U };
+        std::uint8_t         MaxEfficiencyClass { 0U };
+
+        [[nodiscard]] inline bool IsPerformanceCore(CPUCore const &Core) const
+        {
+            return Core.EfficiencyClass == MaxEfficiencyClass;
+        }
+    };
+
+    export struct RENDERCOREMODULE_API WorkerThreadSettings
+    {
+        std::uint32_t MaxRecordingWorkers { 16U };
+        bool          PinWorkers { true };
+        bool          ReserveMainThreadCore { true };
+    };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    RENDERCOREMODULE_API [[nodiscard]] CPUTopology const &GetCPUTopology();
+
+    // Applied when the workers are created, so it must be set before the renderer is initialized
+    RENDERCOREMODULE_API void                               SetWorkerThreadSettings(WorkerThreadSettings const &);
+    RENDERCOREMODULE_API [[nodiscard]] WorkerThreadSettings GetWorkerThreadSettings();
+
+    void                        InitializeWorkerLayout();
+    [[nodiscard]] std::uint32_t GetNumWorkers(WorkerClass);
+    void                        SetupCurrentWorkerThread(WorkerClass, std::uint32_t);
+} // namespace RenderCore
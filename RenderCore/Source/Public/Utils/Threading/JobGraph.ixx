@@ -0,0 +1,111 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.JobGraph;
+
+import ThreadPool;
+
+namespace RenderCore
+{
+    export constexpr std::size_t g_DefaultJobArenaSize { 64U * 1024U };
+
+    using JobFunction = void(*)(void *);
+
+    // Lives in the graph arena; the pending count starts at 1 so a job can't run before the graph is dispatched
+    export struct RENDERCOREMODULE_API Job
+    {
+        char const *               Name { nullptr };
+        JobFunction                Invoke { nullptr };
+        JobFunction                Destroy { nullptr };
+        void *                     Callable { nullptr };
+        std::atomic<std::uint32_t> PendingDependencies { 1U };
+        std::atomic<bool>          IsFinished { false };
+        std::pmr::vector<Job *>    Continuations;
+        std::pmr::vector<Job *>    SpawnedJobs;
+
+        explicit Job(std::pmr::memory_resource *const Resource)
+            : Continuations(Resource)
+          , SpawnedJobs(Resource)
+        {
+        }
+    };
+
+    export using JobHandle = Job *;
+
+    export class RENDERCOREMODULE_API JobGraph
+    {
+        ThreadPool::Pool &                  m_Pool;
+        std::uint32_t                       m_NumThreads { 1U };
+        std::vector<std::byte>              m_ArenaBuffer {};
+        std::pmr::monotonic_buffer_resource m_Arena;
+        std::vector<Job *>                  m_Jobs {};
+        std::vector<Job *>                  m_HeldJobs {};
+        std::atomic<std::uint32_t>          m_PendingJobs { 0U };
+        std::atomic<std::uint32_t>          m_NextThread { 0U };
+        std::mutex                          m_Mutex {};
+
+    public:
+        JobGraph()                 = delete;
+        JobGraph(JobGraph const &) = delete;
+
+        JobGraph &operator=(JobGraph const &) = delete;
+
+        JobGraph(ThreadPool::Pool &, std::uint32_t, std::size_t = g_DefaultJobArenaSize);
+        ~JobGraph();
+
+        template <typename Function>
+        JobHandle AddJob(char const *const Name, Function &&Callable)
+        {
+            using CallableType = std::decay_t<Function>;
+
+            std::lock_guard const             Lock { m_Mutex };
+            std::pmr::polymorphic_allocator<> Allocator { &m_Arena };
+
+            Job *const NewJob = Allocator.new_object<Job>(&m_Arena);
+            NewJob->Name      = Name;
+            NewJob->Callable  = Allocator.new_object<CallableType>(std::forward<Function>(Callable));
+
+            NewJob->Invoke = [](void *const Data)
+            {
+                (*static_cast<CallableType *>(Data))();
+            };
+
+            NewJob->Destroy = [](void *const Data)
+            {
+                std::destroy_at(static_cast<CallableType *>(Data));
+            };
+
+            Hold(*NewJob);
+
+            return NewJob;
+        }
+
+        template <typename Function>
+        JobHandle AddContinuation(JobHandle const Parent, char const *const Name, Function &&Callable)
+        {
+            JobHandle const Output = AddJob(Name, std::forward<Function>(Callable));
+            AddDependency(Parent, Output);
+
+            return Output;
+        }
+
+        // The dependent job must not be dispatched yet. Jobs added from a job of the same graph are dispatched when it returns, so it can declare
+        // their dependencies first; the ones added from elsewhere wait for the next Dispatch or Wait
+        void AddDependency(JobHandle, JobHandle);
+        void Dispatch();
+        void Wait();
+        void Wait(JobHandle);
+        void Reset();
+
+        [[nodiscard]] bool IsComplete() const;
+
+    private:
+        void Hold(Job &);
+        void Release(Job &);
+        void Schedule(Job &);
+        void Execute(Job &);
+    };
+} // namespace RenderCore
@@ -1,5 +1,36 @@
 #version 450
 
+// Must match RenderCore.Runtime.ClusteredLighting
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+#define NUM_CLUSTERS (CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z)
+#define MAX_LIGHTS_PER_CLUSTER 128
+
+struct PointLight {
+    vec4 position_radius;
+    vec4 color_intensity;
+};
+
+layout(std140, set = 0, binding = 0) uniform UBOCamera {
+    mat4 projection_view;
+    vec3 light_position;
+    vec3 light_color;
+    float light_ambient;
+    mat4 view;
+    vec4 cluster_projection;
+    uvec4 cluster_grid;
+} uboCamera;
+
+layout(std430, set = 0, binding = 1) readonly buffer PointLights {
+    PointLight lights[];
+} pointLights;
+
+layout(std430, set = 0, binding = 2) readonly buffer LightClusters {
+    uint counts[NUM_CLUSTERS];
+    uint indices[];
+} lightClusters;
+
 layout(set = 2, binding = 0) uniform sampler2D samplerColorMap;
 layout(set = 2, binding = 1) uniform sampler2D samplerNormalMap;
 layout(set = 2, binding = 2) uniform sampler2D samplerOcclusionMap;
@@ -10,7 +41,7 @@ layout(location = 0) out vec4 outFragColor;
 
 layout(location = 1) in FragmentData {
     vec2  model_uv;
-    vec3  model_view;
+    vec3  model_position;
     vec3  model_normal;
     vec4  model_color;
     vec4  model_tangent;
@@ -28,12 +59,55 @@ layout(location = 1) in FragmentData {
     float light_ambient;
 } fragData;
 
+// Only the lights binned in the cluster of the fragment are visited
+vec3 ShadePointLights(vec3 position, vec3 normal, vec3 albedo) {
+    uint numLights = uboCamera.cluster_grid.w;
+    float nearPlane = uboCamera.cluster_projection.z;
+    float farPlane = uboCamera.cluster_projection.w;
+
+    vec3 viewPos = (uboCamera.view * vec4(position, 1.0)).xyz;
+    float depth = -viewPos.z;
+    vec2 ndc = viewPos.xy * uboCamera.cluster_projection.xy / depth;
+
+    if (numLights == 0u || depth < nearPlane || depth > farPlane || any(greaterThan(abs(ndc), vec2(1.0)))) {
+        return vec3(0.0);
+    }
+
+    ivec2 tile = clamp(ivec2(floor((ndc * 0.5 + 0.5) * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y))), ivec2(0), ivec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1));
+    int slice = clamp(int(floor(log(depth / nearPlane) / log(farPlane / nearPlane) * float(CLUSTER_GRID_Z))), 0, CLUSTER_GRID_Z - 1);
+    uint clusterIndex = uint(tile.x + tile.y * CLUSTER_GRID_X + slice * CLUSTER_GRID_X * CLUSTER_GRID_Y);
+
+    uint count = lightClusters.counts[clusterIndex];
+    vec3 result = vec3(0.0);
+
+    for (uint lightIt = 0u; lightIt < count; ++lightIt) {
+        PointLight light = pointLights.lights[lightClusters.indices[clusterIndex * MAX_LIGHTS_PER_CLUSTER + lightIt]];
+
+        vec3 toLight = light.position_radius.xyz - position;
+        float distanceSquared = dot(toLight, toLight);
+        float radius = light.position_radius.w;
+
+        if (distanceSquared >= radius * radius) {
+            continue;
+        }
+
+        // Inverse square falloff, windowed to reach zero at the light radius
+        float window = clamp(1.0 - pow(distanceSquared / (radius * radius), 2.0), 0.0, 1.0);
+        float attenuation = window * window / (distanceSquared + 1.0);
+        float NdotL = max(dot(normal, toLight * inversesqrt(max(distanceSquared, 0.0001))), 0.0);
+
+        result += albedo * light.color_intensity.rgb * light.color_intensity.w * NdotL * attenuation;
+    }
+
+    return result;
+}
+
 void main() {
     vec4 baseColor = texture(samplerColorMap, fragData.model_uv) * fragData.model_color;
     vec3 normal = normalize(texture(samplerNormalMap, fragData.model_uv).rgb * 2.0 - 1.0);
     normal = normalize(fragData.model_normal);
 
-    vec3 lightDir = normalize(fragData.light_position - fragData.model_view.xyz);
+    vec3 lightDir = normalize(fragData.light_position - fragData.model_position);
     vec3 lightColor = fragData.light_color;
 
     float NdotL = max(dot(normal, lightDir), 0.0);
@@ -45,5 +119,7 @@ void main() {
 
     vec3 emissive = texture(samplerEmissiveMap, fragData.model_uv).rgb * fragData.material_emissiveFactor;
 
-    outFragColor = vec4(ambient + diffuse + emissive, baseColor.a);
+    vec3 pointLighting = ShadePointLights(fragData.model_position, normal, baseColor.rgb);
+
+    outFragColor = vec4(ambient + diffuse + pointLighting + emissive, baseColor.a);
 }
@@ -11,6 +11,9 @@ layout(std140, set = 0, binding = 0) uniform UBOCamera {
     vec3 light_position;
     vec3 light_color;
     float light_ambient;
+    mat4 view;
+    vec4 cluster_projection;
+    uvec4 cluster_grid;
 } uboCamera;
 
 layout(std140, set = 1, binding = 0) uniform UBOModel {
@@ -28,7 +31,7 @@ layout(std140, set = 1, binding = 0) uniform UBOModel {
 
 layout(location = 1) out FragmentData {
     vec2  model_uv;
-    vec3  model_view;
+    vec3  model_position;
     vec3  model_normal;
     vec4  model_color;
     vec4  model_tangent;
@@ -52,7 +55,7 @@ void main() {
     gl_Position = viewPos;
 
     fragData.model_uv = inUV;
-    fragData.model_view = viewPos.xyz;
+    fragData.model_position = worldPos.xyz;
     fragData.model_normal = normalize(mat3(uboModel.model) * inNormal);
     fragData.model_color = inColor;
     fragData.model_tangent = inTangent;
@@ -0,0 +1,13 @@
+#version 450
+
+layout(push_constant) uniform VisibilityConstants {
+    uint object_index;
+} constants;
+
+layout(location = 0) out uvec2 outVisibility;
+
+// Only the visible triangle is written; shading is left to the visibility resolve
+void main() {
+    // Zero is kept for the cleared background
+    outVisibility = uvec2(constants.object_index + 1u, uint(gl_PrimitiveID));
+}